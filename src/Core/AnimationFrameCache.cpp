@@ -0,0 +1,218 @@
+/**
+ * @file AnimationFrameCache.cpp
+ * @brief 动画帧缓存实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "AnimationFrameCache.h"
+#include "MediaPack.h"
+#include <QImageReader>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+
+/**
+ * @brief 占用的字节数
+ * @return qint64 全部帧的字节数
+ */
+qint64 AnimationFrames::bytes() const
+{
+    qint64 total = 0;
+    for (const QImage& frame : frames) total += frame.sizeInBytes();
+    return total;
+}
+
+/**
+ * @brief 获取单例实例
+ * @return AnimationFrameCache& 缓存单例引用
+ */
+AnimationFrameCache& AnimationFrameCache::instance()
+{
+    static AnimationFrameCache instance;
+    return instance;
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+AnimationFrameCache::AnimationFrameCache(QObject* parent) : QObject(parent)
+{
+    // 动画只在悬停时按需解码，一个线程足够，不影响界面和图片加载
+    m_pool.setMaxThreadCount(1);
+    m_cache.setMaxCost(kCacheBytes);
+}
+
+/**
+ * @brief 析构函数
+ */
+AnimationFrameCache::~AnimationFrameCache()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief 加载动画
+ * @param path 动画路径
+ * @param size 显示尺寸（逻辑像素）
+ * @param dpr 设备像素比
+ * @return QFuture<AnimationFramesPtr> 解码结果
+ */
+QFuture<AnimationFramesPtr> AnimationFrameCache::load(const QString& path, const QSize& size, qreal dpr)
+{
+    const QString key = QString("%1x%2@%3:%4").arg(size.width()).arg(size.height()).arg(dpr).arg(path);
+
+    auto promise = std::make_shared<QPromise<AnimationFramesPtr>>();
+    QFuture<AnimationFramesPtr> future = promise->future();
+    promise->start();
+
+    if (AnimationFramesPtr* cached = m_cache.object(key)) {
+        promise->addResult(*cached);
+        promise->finish();
+        return future;
+    }
+
+    auto it = m_pending.find(key);
+    if (it == m_pending.end()) {
+        it = m_pending.insert(key, {});
+
+        m_pool.start([this, key, path, size, dpr]() {
+            AnimationFramesPtr frames = decode(path, size, dpr);
+            QMetaObject::invokeMethod(this, [this, key, frames]() { complete(key, frames); }, Qt::QueuedConnection);
+        });
+    }
+    it->append(promise);
+
+    return future;
+}
+
+/**
+ * @brief 逐帧解码动画
+ * @param path 动画路径
+ * @param size 显示尺寸（逻辑像素）
+ * @param dpr 设备像素比
+ * @return AnimationFramesPtr 解码结果，无法解码时为空指针
+ */
+AnimationFramesPtr AnimationFrameCache::decode(const QString& path, const QSize& size, qreal dpr)
+{
+    // 外部资源包里的动画在第一次用到时才注册资源包
+    if (MediaPack::contains(path) && !MediaPack::ensureLoaded()) return nullptr;
+
+    if (path.endsWith(".json", Qt::CaseInsensitive)) return decodeStrip(path, size, dpr);
+
+    QImageReader reader(path);
+    const QSize target = size * dpr;
+    const QSize source = reader.size();
+
+    // 每帧在解码器里直接缩放裁剪，不保留原尺寸的帧
+    if (source.isValid() && !target.isEmpty()) {
+        const QSize scaled = source.scaled(target, Qt::KeepAspectRatioByExpanding);
+        QRect clip(QPoint(0, 0), target);
+        clip.moveCenter(QRect(QPoint(0, 0), scaled).center());
+        reader.setScaledSize(scaled);
+        reader.setScaledClipRect(clip);
+    }
+
+    auto animation = std::make_shared<AnimationFrames>();
+    while (reader.canRead()) {
+        QImage frame = reader.read();
+        if (frame.isNull()) break;
+
+        const QImage::Format format = frame.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                              : QImage::Format_RGB32;
+        frame = std::move(frame).convertToFormat(format);
+        frame.setDevicePixelRatio(dpr);
+
+        const int delay = reader.nextImageDelay();
+        animation->frames.append(frame);
+        animation->delays.append(delay > 0 ? delay : kDefaultDelay);
+    }
+
+    if (animation->frames.isEmpty()) {
+        qDebug() << "动画解码失败:" << path << reader.errorString();
+        return nullptr;
+    }
+    return animation;
+}
+
+/**
+ * @brief 从帧表切出各帧
+ * @param path 帧表描述文件路径
+ * @param size 显示尺寸（逻辑像素）
+ * @param dpr 设备像素比
+ * @return AnimationFramesPtr 解码结果，无法解码时为空指针
+ */
+AnimationFramesPtr AnimationFrameCache::decodeStrip(const QString& path, const QSize& size, qreal dpr)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "动画解码失败:" << path << file.errorString();
+        return nullptr;
+    }
+
+    const QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+    const QSize cell(manifest.value("frameWidth").toInt(), manifest.value("frameHeight").toInt());
+    const int columns = manifest.value("columns").toInt();
+    const QJsonArray delays = manifest.value("delays").toArray();
+
+    // 整张帧表只解码一次，之后按格切出各帧
+    const QString sheetPath = QFileInfo(path).path() + "/" + manifest.value("image").toString();
+    QImageReader reader(sheetPath);
+    const QImage sheet = reader.read().convertToFormat(QImage::Format_RGB32);
+    if (sheet.isNull() || cell.isEmpty() || columns <= 0) {
+        qDebug() << "动画解码失败:" << sheetPath << reader.errorString();
+        return nullptr;
+    }
+
+    // 帧表按常用尺寸生成，只有显示尺寸不同时才逐帧缩放裁剪
+    const QSize target = size * dpr;
+    QRect clip(QPoint(0, 0), target);
+    clip.moveCenter(QRect(QPoint(0, 0), cell.scaled(target, Qt::KeepAspectRatioByExpanding)).center());
+
+    auto animation = std::make_shared<AnimationFrames>();
+    for (int i = 0; i < delays.size(); ++i) {
+        const QRect source(QPoint((i % columns) * cell.width(), (i / columns) * cell.height()), cell);
+        if (!sheet.rect().contains(source)) break;
+
+        QImage frame = sheet.copy(source);
+        if (!target.isEmpty() && frame.size() != target) {
+            frame = frame.scaled(target, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation).copy(clip);
+        }
+        frame.setDevicePixelRatio(dpr);
+
+        const int delay = delays.at(i).toInt();
+        animation->frames.append(frame);
+        animation->delays.append(delay > 0 ? delay : kDefaultDelay);
+    }
+
+    if (animation->frames.isEmpty()) {
+        qDebug() << "动画解码失败:" << path << "帧表为空";
+        return nullptr;
+    }
+    return animation;
+}
+
+/**
+ * @brief 解码完成，写入缓存并通知所有请求方
+ * @param key 缓存键
+ * @param frames 解码结果
+ */
+void AnimationFrameCache::complete(const QString& key, const AnimationFramesPtr& frames)
+{
+    const auto promises = m_pending.take(key);
+
+    if (frames) {
+        m_cache.insert(key, new AnimationFramesPtr(frames), static_cast<qsizetype>(frames->bytes()));
+    }
+
+    for (const auto& promise : promises) {
+        promise->addResult(frames);
+        promise->finish();
+    }
+}
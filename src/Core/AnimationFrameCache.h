@@ -0,0 +1,123 @@
+/**
+ * @file AnimationFrameCache.h
+ * @brief 动画帧缓存头文件
+ *
+ * 该文件定义了AnimationFrameCache类，在工作线程中把 GIF 等动画逐帧解码并直接缩放到显示尺寸，
+ * 同一动画同一尺寸只解码一次，结果在所有使用者之间共享。
+ * 除普通动画文件外，也支持构建时由 GIF 生成的帧表（.json 描述文件加一张 JPEG）。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QFuture>
+#include <QPromise>
+#include <QImage>
+#include <QSize>
+#include <QVector>
+#include <memory>
+
+/**
+ * @brief 解码完成的动画
+ *
+ * 帧已缩放并裁剪到目标尺寸、带设备像素比，绘制时按原样贴出，不再缩放或转换格式
+ */
+struct AnimationFrames {
+    QVector<QImage> frames; ///< 各帧图像
+    QVector<int> delays;    ///< 各帧显示时长（毫秒）
+
+    /**
+     * @brief 占用的字节数
+     * @return qint64 全部帧的字节数
+     */
+    qint64 bytes() const;
+};
+
+using AnimationFramesPtr = std::shared_ptr<const AnimationFrames>;
+
+/**
+ * @brief 动画帧缓存类
+ *
+ * 单例，只在 GUI 线程调用。解码在单线程的独立线程池中依次进行，不与图片加载争抢线程。
+ * 内存缓存按字节数淘汰；正在播放的使用者持有共享指针，淘汰不会影响播放。
+ */
+class AnimationFrameCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 获取单例实例
+     * @return AnimationFrameCache& 缓存单例引用
+     */
+    static AnimationFrameCache& instance();
+
+    /**
+     * @brief 加载动画
+     * @param path 动画路径（本地文件、资源路径或帧表描述文件）
+     * @param size 显示尺寸（逻辑像素），帧按比例填满后居中裁剪
+     * @param dpr 设备像素比
+     * @return QFuture<AnimationFramesPtr> 解码结果，无法解码时为空指针
+     */
+    QFuture<AnimationFramesPtr> load(const QString& path, const QSize& size, qreal dpr);
+
+    /**
+     * @brief 逐帧解码动画
+     * @param path 动画路径
+     * @param size 显示尺寸（逻辑像素）
+     * @param dpr 设备像素比
+     * @return AnimationFramesPtr 解码结果，无法解码时为空指针
+     *
+     * 可在任意线程调用
+     */
+    static AnimationFramesPtr decode(const QString& path, const QSize& size, qreal dpr);
+
+private:
+    /**
+     * @brief 私有构造函数（单例模式）
+     * @param parent 父对象指针
+     */
+    explicit AnimationFrameCache(QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     *
+     * 丢弃尚未开始的解码并等待正在执行的解码结束
+     */
+    ~AnimationFrameCache();
+
+    AnimationFrameCache(const AnimationFrameCache&) = delete;
+    AnimationFrameCache& operator=(const AnimationFrameCache&) = delete;
+
+    /**
+     * @brief 解码完成，写入缓存并通知所有请求方
+     * @param key 缓存键
+     * @param frames 解码结果
+     */
+    void complete(const QString& key, const AnimationFramesPtr& frames);
+
+    /**
+     * @brief 从帧表切出各帧
+     * @param path 帧表描述文件路径
+     * @param size 显示尺寸（逻辑像素）
+     * @param dpr 设备像素比
+     * @return AnimationFramesPtr 解码结果，无法解码时为空指针
+     */
+    static AnimationFramesPtr decodeStrip(const QString& path, const QSize& size, qreal dpr);
+
+private:
+    QThreadPool m_pool;                                                          ///< 解码线程池
+    QCache<QString, AnimationFramesPtr> m_cache;                                 ///< 解码结果缓存，代价为字节数
+    QHash<QString, QList<std::shared_ptr<QPromise<AnimationFramesPtr>>>> m_pending; ///< 正在解码的请求
+
+    static constexpr qint64 kCacheBytes = 64LL * 1024 * 1024; ///< 内存缓存上限
+    static constexpr int kDefaultDelay = 100;                 ///< 动画未给出帧时长时的默认值（毫秒）
+};
@@ -0,0 +1,229 @@
+/**
+ * @file ImageLoader.cpp
+ * @brief 异步图片加载服务实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "ImageLoader.h"
+#include <QImageReader>
+#include <QThread>
+#include <QDebug>
+
+/**
+ * @brief 获取单例实例
+ * @return ImageLoader& 加载服务单例引用
+ */
+ImageLoader& ImageLoader::instance()
+{
+    static ImageLoader instance;
+    return instance;
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+ImageLoader::ImageLoader(QObject* parent) : QObject(parent)
+{
+    // 解码以 CPU 为主，留出一半核心给界面和网络
+    m_pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount() / 2, 4));
+    m_cache.setMaxCost(kDefaultCacheBytes);
+}
+
+/**
+ * @brief 析构函数
+ */
+ImageLoader::~ImageLoader()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief 加载图片
+ * @param path 图片路径（本地文件或资源路径）
+ * @param targetSize 解码尺寸上限，无效尺寸表示原图
+ * @param receiver 请求方对象，销毁后取消请求，可为空
+ * @param priority 加载优先级
+ * @return QFuture<QPixmap> 解码结果，文件不存在或无法解码时为空图
+ */
+QFuture<QPixmap> ImageLoader::load(const QString& path, const QSize& targetSize, QObject* receiver,
+                                   ImagePriority priority)
+{
+    const QString key = targetSize.isValid()
+        ? QString("%1x%2:%3").arg(targetSize.width()).arg(targetSize.height()).arg(path)
+        : QString("full:%1").arg(path);
+
+    return submit(key, [path, targetSize]() { return decode(path, targetSize); }, receiver, priority);
+}
+
+/**
+ * @brief 加载缩略图
+ * @param path 原图路径
+ * @param tier 缩略图档位
+ * @param receiver 请求方对象，销毁后取消请求，可为空
+ * @param priority 加载优先级
+ * @return QFuture<QPixmap> 缩略图，磁盘缓存缺失时从原图生成
+ */
+QFuture<QPixmap> ImageLoader::loadThumbnail(const QString& path, ThumbnailTier tier, QObject* receiver,
+                                            ImagePriority priority)
+{
+    return submit(thumbnailKey(path, tier), [path, tier]() { return ThumbnailCache::load(path, tier); },
+                  receiver, priority);
+}
+
+/**
+ * @brief 查询内存中已有的缩略图
+ * @param path 原图路径
+ * @param tier 缩略图档位
+ * @return QPixmap 缓存命中时返回缩略图，否则为空
+ */
+QPixmap ImageLoader::cachedThumbnail(const QString& path, ThumbnailTier tier)
+{
+    QPixmap* cached = m_cache.object(thumbnailKey(path, tier));
+    return cached ? *cached : QPixmap();
+}
+
+/**
+ * @brief 缩略图的缓存键
+ * @param path 原图路径
+ * @param tier 缩略图档位
+ * @return QString 缓存键
+ */
+QString ImageLoader::thumbnailKey(const QString& path, ThumbnailTier tier)
+{
+    return QString("thumb%1:%2").arg(static_cast<int>(tier)).arg(path);
+}
+
+/**
+ * @brief 设置内存缓存上限
+ * @param bytes 缓存字节数上限
+ */
+void ImageLoader::setCacheBudget(qint64 bytes)
+{
+    m_cache.setMaxCost(bytes);
+}
+
+/**
+ * @brief 按尺寸上限解码图片
+ * @param path 图片路径
+ * @param targetSize 解码尺寸上限（保持宽高比，不放大），无效尺寸表示原图
+ * @return QImage 解码结果
+ */
+QImage ImageLoader::decode(const QString& path, const QSize& targetSize)
+{
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+
+    if (targetSize.isValid()) {
+        QSize sourceSize = reader.size();
+        if (sourceSize.isValid()
+            && (sourceSize.width() > targetSize.width() || sourceSize.height() > targetSize.height())) {
+            reader.setScaledSize(sourceSize.scaled(targetSize, Qt::KeepAspectRatio));
+        }
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qDebug() << "图片解码失败:" << path << reader.errorString();
+    }
+    return image;
+}
+
+/**
+ * @brief 提交解码任务
+ * @param key 缓存键
+ * @param job 在线程池中执行的解码函数
+ * @param receiver 请求方对象
+ * @param priority 加载优先级
+ * @return QFuture<QPixmap> 解码结果
+ */
+QFuture<QPixmap> ImageLoader::submit(const QString& key, std::function<QImage()> job, QObject* receiver,
+                                     ImagePriority priority)
+{
+    auto promise = std::make_shared<QPromise<QPixmap>>();
+    QFuture<QPixmap> future = promise->future();
+    promise->start();
+
+    if (QPixmap* cached = m_cache.object(key)) {
+        promise->addResult(*cached);
+        promise->finish();
+        return future;
+    }
+
+    std::shared_ptr<PendingLoad> pending = m_pending.value(key);
+    if (!pending) {
+        pending = std::make_shared<PendingLoad>();
+        pending->job = std::move(job);
+        pending->priority = static_cast<int>(priority);
+        m_pending.insert(key, pending);
+        schedule(key, pending);
+    }
+
+    pending->promises.append(promise);
+    ++pending->waiters;
+    pending->cancelled = false;
+
+    if (receiver) {
+        pending->connections.append(connect(receiver, &QObject::destroyed, this, [pending]() {
+            if (--pending->waiters == 0) pending->cancelled = true;
+        }));
+    }
+
+    return future;
+}
+
+/**
+ * @brief 把解码任务放入线程池
+ * @param key 缓存键
+ * @param pending 正在解码的请求
+ */
+void ImageLoader::schedule(const QString& key, const std::shared_ptr<PendingLoad>& pending)
+{
+    m_pool.start([this, key, pending]() {
+        // 请求方在排队期间全部销毁，不再解码
+        const bool skipped = pending->cancelled;
+        QImage image = skipped ? QImage() : pending->job();
+        QMetaObject::invokeMethod(this, [this, key, image, skipped]() { complete(key, image, skipped); },
+                                  Qt::QueuedConnection);
+    }, pending->priority);
+}
+
+/**
+ * @brief 解码完成，写入缓存并通知所有请求方
+ * @param key 缓存键
+ * @param image 解码结果
+ * @param skipped 是否因请求方全部销毁而跳过了解码
+ */
+void ImageLoader::complete(const QString& key, const QImage& image, bool skipped)
+{
+    std::shared_ptr<PendingLoad> pending = m_pending.value(key);
+    if (!pending) return;
+
+    // 跳过解码后又有请求方加入，重新解码而不是返回空图
+    if (skipped && pending->waiters > 0) {
+        schedule(key, pending);
+        return;
+    }
+    m_pending.remove(key);
+
+    // 断开销毁信号的连接，请求方不再持有已完成的请求和其中的图片
+    for (const QMetaObject::Connection& connection : pending->connections) disconnect(connection);
+    pending->connections.clear();
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+    if (!pixmap.isNull()) {
+        // 超过缓存上限的单张大图 QCache 会直接拒绝，不影响已缓存的小图
+        qsizetype cost = static_cast<qsizetype>(image.sizeInBytes());
+        m_cache.insert(key, new QPixmap(pixmap), cost);
+    }
+
+    for (const auto& promise : pending->promises) {
+        promise->addResult(pixmap);
+        promise->finish();
+    }
+    pending->promises.clear();
+    pending->job = nullptr;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file ImageLoader.h
+ * @brief 异步图片加载服务头文件
+ * 
+ * 该文件定义了ImageLoader类，集中负责界面上所有本地图片的解码，
+ * 解码在独立线程池中进行并直接解到需要的尺寸，GUI 线程只做 QImage 到 QPixmap 的转换。
+ * 
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QFuture>
+#include <QPromise>
+#include <QPixmap>
+#include <QImage>
+#include <QSize>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "ThumbnailCache.h"
+
+/**
+ * @brief 加载优先级
+ *
+ * 数值越大越先被线程池取出执行
+ */
+enum class ImagePriority {
+    Low = 0,    ///< 预取等可有可无的请求
+    Normal = 1, ///< 列表项、卡片等可见内容
+    High = 2    ///< 用户点击触发的查看、复制等操作
+};
+
+/**
+ * @brief 异步图片加载服务类
+ * 
+ * 单例，只在 GUI 线程调用。每个请求返回独立的 QFuture，调用方用 then(receiver, ...) 接收结果。
+ * 同一图片同一尺寸的并发请求只解码一次；请求方对象全部销毁后，尚未开始的解码直接跳过。
+ * 解码结果按字节数计入 LRU 缓存，再次请求直接返回。
+ */
+class ImageLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 获取单例实例
+     * @return ImageLoader& 加载服务单例引用
+     */
+    static ImageLoader& instance();
+
+    /**
+     * @brief 加载图片
+     * @param path 图片路径（本地文件或资源路径）
+     * @param targetSize 解码尺寸上限，无效尺寸表示原图
+     * @param receiver 请求方对象，销毁后取消请求，可为空
+     * @param priority 加载优先级
+     * @return QFuture<QPixmap> 解码结果，文件不存在或无法解码时为空图
+     */
+    QFuture<QPixmap> load(const QString& path, const QSize& targetSize, QObject* receiver,
+                          ImagePriority priority = ImagePriority::Normal);
+
+    /**
+     * @brief 加载缩略图
+     * @param path 原图路径
+     * @param tier 缩略图档位
+     * @param receiver 请求方对象，销毁后取消请求，可为空
+     * @param priority 加载优先级
+     * @return QFuture<QPixmap> 缩略图，磁盘缓存缺失时从原图生成
+     */
+    QFuture<QPixmap> loadThumbnail(const QString& path, ThumbnailTier tier, QObject* receiver,
+                                   ImagePriority priority = ImagePriority::Normal);
+
+    /**
+     * @brief 查询内存中已有的缩略图
+     * @param path 原图路径
+     * @param tier 缩略图档位
+     * @return QPixmap 缓存命中时返回缩略图，否则为空（不会发起加载）
+     *
+     * 供列表绘制代理同步使用，未命中时再调用 loadThumbnail
+     */
+    QPixmap cachedThumbnail(const QString& path, ThumbnailTier tier);
+
+    /**
+     * @brief 设置内存缓存上限
+     * @param bytes 缓存字节数上限
+     */
+    void setCacheBudget(qint64 bytes);
+
+    /**
+     * @brief 按尺寸上限解码图片
+     * @param path 图片路径
+     * @param targetSize 解码尺寸上限（保持宽高比，不放大），无效尺寸表示原图
+     * @return QImage 解码结果
+     *
+     * 通过 QImageReader::setScaledSize 直接解到目标尺寸，JPEG 可在 DCT 阶段缩小。可在任意线程调用
+     */
+    static QImage decode(const QString& path, const QSize& targetSize);
+
+private:
+    /**
+     * @brief 私有构造函数（单例模式）
+     * @param parent 父对象指针
+     */
+    explicit ImageLoader(QObject* parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     *
+     * 丢弃尚未开始的解码并等待正在执行的解码结束
+     */
+    ~ImageLoader();
+
+    ImageLoader(const ImageLoader&) = delete;
+    ImageLoader& operator=(const ImageLoader&) = delete;
+
+    /**
+     * @brief 正在解码的请求，同一缓存键的多个请求共享
+     */
+    struct PendingLoad {
+        std::atomic_bool cancelled{false};                   ///< 请求方已全部销毁，跳过解码
+        int waiters = 0;                                      ///< 仍存活的请求方数量（仅 GUI 线程访问）
+        QList<std::shared_ptr<QPromise<QPixmap>>> promises;   ///< 等待结果的请求
+        QList<QMetaObject::Connection> connections;           ///< 请求方销毁信号的连接，完成后断开
+        std::function<QImage()> job;                          ///< 解码函数，跳过后有新请求时重新提交
+        int priority = 0;                                     ///< 线程池优先级
+    };
+
+    /**
+     * @brief 缩略图的缓存键
+     * @param path 原图路径
+     * @param tier 缩略图档位
+     * @return QString 缓存键
+     */
+    static QString thumbnailKey(const QString& path, ThumbnailTier tier);
+
+    /**
+     * @brief 提交解码任务
+     * @param key 缓存键
+     * @param job 在线程池中执行的解码函数
+     * @param receiver 请求方对象
+     * @param priority 加载优先级
+     * @return QFuture<QPixmap> 解码结果
+     */
+    QFuture<QPixmap> submit(const QString& key, std::function<QImage()> job, QObject* receiver,
+                            ImagePriority priority);
+
+    /**
+     * @brief 把解码任务放入线程池
+     * @param key 缓存键
+     * @param pending 正在解码的请求
+     */
+    void schedule(const QString& key, const std::shared_ptr<PendingLoad>& pending);
+
+    /**
+     * @brief 解码完成，写入缓存并通知所有请求方
+     * @param key 缓存键
+     * @param image 解码结果
+     * @param skipped 是否因请求方全部销毁而跳过了解码
+     *
+     * 跳过期间又有新的请求方加入时重新提交解码，不把空图交给新的请求方
+     */
+    void complete(const QString& key, const QImage& image, bool skipped);
+
+private:
+    QThreadPool m_pool;                                          ///< 解码线程池（与上传等任务使用的全局线程池分开）
+    QCache<QString, QPixmap> m_cache;                            ///< 解码结果缓存，代价为字节数
+    QHash<QString, std::shared_ptr<PendingLoad>> m_pending;      ///< 正在解码的请求
+
+    static constexpr qint64 kDefaultCacheBytes = 128LL * 1024 * 1024; ///< 默认内存缓存上限
+};
@@ -0,0 +1,74 @@
+/**
+ * @file ImagePreprocessor.h
+ * @brief 上传前图片处理头文件
+ * 
+ * 该文件定义了ImagePreprocessor类，负责在上传参考图之前按工作流的实际需求
+ * 缩小尺寸并重新编码，避免把大图原样推到服务器。
+ * 
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include "../Model/WorkflowTypes.h"
+
+/**
+ * @brief 上传前处理结果
+ */
+struct PreparedUpload {
+    bool ok = false;        ///< 是否处理成功
+    bool unchanged = false; ///< 原文件无需处理，可直接按路径上传
+    QByteArray data;        ///< 重新编码后的图片数据（unchanged 时为空）
+    QString fileName;       ///< 上传使用的文件名
+    QString mimeType;       ///< 图片MIME类型
+};
+
+/**
+ * @brief 上传前图片处理类
+ * 
+ * 纯函数集合，不持有状态，可以安全地在工作线程中调用。
+ * 解码时通过 QImageReader::setScaledSize 直接解到目标尺寸（JPEG 可在 DCT 阶段缩小），
+ * 不透明图片重新编码为 JPEG，带透明通道的图片使用低压缩等级的 PNG。
+ */
+class ImagePreprocessor
+{
+public:
+    /**
+     * @brief 处理本地图片文件
+     * @param localPath 本地图片路径
+     * @param policy 工作流的缩放策略
+     * @return PreparedUpload 处理结果
+     */
+    static PreparedUpload prepareFile(const QString& localPath, const UploadResizePolicy& policy);
+
+    /**
+     * @brief 处理内存中的图片
+     * @param image 图片数据
+     * @param fileName 期望的文件名
+     * @param policy 工作流的缩放策略，不缩放时按无损 PNG 编码
+     * @return PreparedUpload 处理结果
+     */
+    static PreparedUpload prepareImage(const QImage& image, const QString& fileName, const UploadResizePolicy& policy);
+
+    /**
+     * @brief 根据文件内容推断图片MIME类型
+     * @param localPath 本地图片路径
+     * @return QString MIME类型，无法识别时返回 application/octet-stream
+     */
+    static QString mimeTypeForFile(const QString& localPath);
+
+private:
+    /**
+     * @brief 编码图片
+     * @param image 图片数据
+     * @param baseName 不含扩展名的文件名
+     * @param lossless 是否强制无损编码
+     * @return PreparedUpload 编码结果
+     */
+    static PreparedUpload encode(const QImage& image, const QString& baseName, bool lossless);
+};
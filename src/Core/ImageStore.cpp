@@ -0,0 +1,119 @@
+/**
+ * @file ImageStore.cpp
+ * @brief 内容寻址图片存储实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "ImageStore.h"
+#include <QCryptographicHash>
+#include <QImageReader>
+#include <QBuffer>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include <QDebug>
+
+/**
+ * @brief 保存图片原始数据
+ * @param data 图片文件的原始字节（按服务端返回的编码原样保存）
+ * @return StoredImage 入库结果
+ */
+StoredImage ImageStore::store(const QByteArray& data)
+{
+    StoredImage result;
+    if (data.isEmpty()) return result;
+
+    result.hash = contentHash(data);
+    result.path = pathForHash(result.hash, sniffSuffix(data));
+    result.size = data.size();
+
+    // 路径由内容决定，文件已存在即说明内容相同，无需重复写盘
+    QFileInfo info(result.path);
+    if (info.exists() && info.size() == result.size) {
+        // 刷新修改时间，后台回收据此跳过刚被重新引用的文件
+        QFile existing(result.path);
+        if (existing.open(QIODevice::Append)) {
+            existing.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        }
+
+        result.ok = true;
+        result.existed = true;
+        return result;
+    }
+
+    if (!QDir().mkpath(info.absolutePath())) {
+        qDebug() << "无法创建图片目录:" << info.absolutePath();
+        return result;
+    }
+
+    // 先写临时文件再原子替换，中途失败不会留下半个文件
+    QSaveFile file(result.path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "无法写入图片:" << result.path << file.errorString();
+        return result;
+    }
+
+    file.write(data);
+    if (!file.commit()) {
+        qDebug() << "保存图片失败:" << result.path << file.errorString();
+        return result;
+    }
+
+    result.ok = true;
+    return result;
+}
+
+/**
+ * @brief 计算内容哈希
+ * @param data 图片数据
+ * @return QString 十六进制哈希
+ *
+ * BLAKE2b 在 64 位平台上比 SHA-256 快，且无需额外依赖
+ */
+QString ImageStore::contentHash(const QByteArray& data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Blake2b_256).toHex());
+}
+
+/**
+ * @brief 根据哈希计算存储路径
+ * @param hash 十六进制哈希
+ * @param suffix 文件扩展名（不含点）
+ * @return QString 文件完整路径
+ */
+QString ImageStore::pathForHash(const QString& hash, const QString& suffix)
+{
+    return QString("%1/%2/%3/%4.%5")
+        .arg(rootDir(), hash.left(2), hash.mid(2, 2), hash, suffix);
+}
+
+/**
+ * @brief 图片存储根目录
+ * @return QString outputs 目录路径
+ */
+QString ImageStore::rootDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/outputs";
+}
+
+/**
+ * @brief 根据文件头推断扩展名
+ * @param data 图片数据
+ * @return QString 扩展名，无法识别时为 png
+ */
+QString ImageStore::sniffSuffix(const QByteArray& data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    QByteArray format = QImageReader::imageFormat(&buffer);
+    if (format.isEmpty()) return QStringLiteral("png");
+    if (format == "jpeg") return QStringLiteral("jpg");
+    return QString::fromLatin1(format);
+}
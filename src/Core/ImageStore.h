@@ -0,0 +1,74 @@
+/**
+ * @file ImageStore.h
+ * @brief 内容寻址图片存储头文件
+ * 
+ * 该文件定义了ImageStore类，负责把生成结果按内容哈希写入分片目录，
+ * 相同内容的图片只落盘一次。
+ * 
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief 图片入库结果
+ */
+struct StoredImage {
+    bool ok = false;        ///< 是否写入成功（或已存在相同内容）
+    bool existed = false;   ///< 相同内容的文件此前已存在，本次未写盘
+    QString hash;           ///< 内容哈希（十六进制）
+    QString path;           ///< 文件完整路径
+    qint64 size = 0;        ///< 文件字节数
+};
+
+/**
+ * @brief 内容寻址图片存储类
+ * 
+ * 纯函数集合，不持有状态。文件路径由内容哈希决定：
+ * outputs/<哈希前两位>/<哈希三四位>/<哈希>.<扩展名>，
+ * 两级分片使单个目录的文件数保持在可控范围内，定位文件无需遍历目录。
+ */
+class ImageStore
+{
+public:
+    /**
+     * @brief 保存图片原始数据
+     * @param data 图片文件的原始字节（按服务端返回的编码原样保存）
+     * @return StoredImage 入库结果
+     */
+    static StoredImage store(const QByteArray& data);
+
+    /**
+     * @brief 计算内容哈希
+     * @param data 图片数据
+     * @return QString 十六进制哈希
+     */
+    static QString contentHash(const QByteArray& data);
+
+    /**
+     * @brief 根据哈希计算存储路径
+     * @param hash 十六进制哈希
+     * @param suffix 文件扩展名（不含点）
+     * @return QString 文件完整路径
+     */
+    static QString pathForHash(const QString& hash, const QString& suffix);
+
+    /**
+     * @brief 图片存储根目录
+     * @return QString outputs 目录路径
+     */
+    static QString rootDir();
+
+private:
+    /**
+     * @brief 根据文件头推断扩展名
+     * @param data 图片数据
+     * @return QString 扩展名，无法识别时为 png
+     */
+    static QString sniffSuffix(const QByteArray& data);
+};
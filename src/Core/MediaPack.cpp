@@ -0,0 +1,68 @@
+/**
+ * @file MediaPack.cpp
+ * @brief 外部媒体资源包实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "MediaPack.h"
+#include <QCoreApplication>
+#include <QResource>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+namespace {
+const char* kPackFile = "media.rcc";   ///< 资源包文件名
+const char* kMountPrefix = ":/media/"; ///< 资源包内的路径前缀
+
+/**
+ * @brief 查找并注册资源包
+ * @return bool 是否注册成功
+ */
+bool registerPack()
+{
+    // 资源包与可执行文件放在一起；macOS 应用包中放在 Resources 目录
+    const QDir appDir(QCoreApplication::applicationDirPath());
+    const QStringList candidates = {
+        appDir.filePath(kPackFile),
+        appDir.filePath(QString("../Resources/") + kPackFile),
+    };
+
+    for (const QString& path : candidates) {
+        if (!QFileInfo::exists(path)) continue;
+
+        // 未压缩的资源包由 QResource 直接内存映射，不会整体读入内存
+        if (QResource::registerResource(path)) {
+            qDebug() << "媒体资源包已加载:" << path;
+            return true;
+        }
+        qDebug() << "媒体资源包无法注册:" << path;
+    }
+
+    qDebug() << "未找到媒体资源包" << kPackFile << "，演示动画将不可用";
+    return false;
+}
+}
+
+/**
+ * @brief 确保资源包已注册
+ * @return bool 资源包是否可用
+ */
+bool MediaPack::ensureLoaded()
+{
+    // 局部静态变量的初始化是线程安全的，保证只注册一次
+    static const bool loaded = registerPack();
+    return loaded;
+}
+
+/**
+ * @brief 判断路径是否位于资源包中
+ * @param path 资源路径
+ * @return bool 是否以 ":/media/" 开头
+ */
+bool MediaPack::contains(const QString& path)
+{
+    return path.startsWith(QLatin1String(kMountPrefix));
+}
@@ -0,0 +1,40 @@
+/**
+ * @file MediaPack.h
+ * @brief 外部媒体资源包头文件
+ *
+ * 该文件定义了MediaPack类，负责按需注册构建时生成的 media.rcc。
+ * 演示动画等可选的大体积媒体不编译进程序，首次使用时才把资源包内存映射进资源系统。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QString>
+
+/**
+ * @brief 外部媒体资源包类
+ *
+ * 静态工具类，可在任意线程调用。资源包注册后挂在 ":/media/" 下，
+ * 找不到资源包时只记录一次日志，使用方按资源不存在处理即可。
+ */
+class MediaPack
+{
+public:
+    /**
+     * @brief 确保资源包已注册
+     * @return bool 资源包是否可用
+     *
+     * 只在第一次调用时查找并注册资源包，之后直接返回结果
+     */
+    static bool ensureLoaded();
+
+    /**
+     * @brief 判断路径是否位于资源包中
+     * @param path 资源路径
+     * @return bool 是否以 ":/media/" 开头
+     */
+    static bool contains(const QString& path);
+};
@@ -0,0 +1,133 @@
+/**
+ * @file SessionHistoryCache.cpp
+ * @brief 会话历史预取缓存实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "SessionHistoryCache.h"
+#include "ImageLoader.h"
+#include "../Database/DatabaseManager.h"
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+SessionHistoryCache::SessionHistoryCache(QObject* parent) : QObject(parent) {}
+
+/**
+ * @brief 预取会话的第一页消息和缩略图
+ * @param sessionId 会话ID
+ */
+void SessionHistoryCache::prefetch(int sessionId)
+{
+    if (sessionId == -1) return;
+
+    if (m_pages.contains(sessionId)) {
+        touch(sessionId);
+        return;
+    }
+    query(sessionId);
+}
+
+/**
+ * @brief 重新查询会话的第一页
+ * @param sessionId 会话ID
+ */
+void SessionHistoryCache::refresh(int sessionId)
+{
+    if (sessionId == -1) return;
+    query(sessionId);
+}
+
+/**
+ * @brief 丢弃会话的缓存
+ * @param sessionId 会话ID
+ */
+void SessionHistoryCache::invalidate(int sessionId)
+{
+    m_pages.remove(sessionId);
+    m_order.removeOne(sessionId);
+}
+
+/**
+ * @brief 获取已就绪的第一页
+ * @param sessionId 会话ID
+ * @param page 输出的分页结果
+ * @return bool 是否命中
+ */
+bool SessionHistoryCache::readyPage(int sessionId, MessagePage* page)
+{
+    auto it = m_pages.constFind(sessionId);
+    if (it == m_pages.constEnd() || !it->isFinished() || it->resultCount() == 0) return false;
+
+    *page = it->result();
+    touch(sessionId);
+    return true;
+}
+
+/**
+ * @brief 获取第一页
+ * @param sessionId 会话ID
+ * @return QFuture<MessagePage> 查询结果
+ */
+QFuture<MessagePage> SessionHistoryCache::page(int sessionId)
+{
+    auto it = m_pages.constFind(sessionId);
+    if (it != m_pages.constEnd()) {
+        QFuture<MessagePage> pending = *it;
+        touch(sessionId);
+        return pending;
+    }
+    return query(sessionId);
+}
+
+/**
+ * @brief 发起查询并登记到缓存
+ * @param sessionId 会话ID
+ * @return QFuture<MessagePage> 查询结果
+ */
+QFuture<MessagePage> SessionHistoryCache::query(int sessionId)
+{
+    QFuture<MessagePage> future = DatabaseManager::instance().getMessagePage(sessionId);
+    m_pages.insert(sessionId, future);
+    touch(sessionId);
+
+    future.then(this, [this](const MessagePage& page) {
+        warmThumbnails(page);
+    });
+    return future;
+}
+
+/**
+ * @brief 把会话移到最近使用的位置并淘汰多余条目
+ * @param sessionId 会话ID
+ */
+void SessionHistoryCache::touch(int sessionId)
+{
+    m_order.removeOne(sessionId);
+    m_order.append(sessionId);
+
+    while (m_order.size() > kCapacity) {
+        m_pages.remove(m_order.takeFirst());
+    }
+}
+
+/**
+ * @brief 预热一页中最新几张图片的缩略图
+ * @param page 分页结果
+ *
+ * 切换会话后聊天区停在底部，最先可见的是最新的图片
+ */
+void SessionHistoryCache::warmThumbnails(const MessagePage& page)
+{
+    int warmed = 0;
+    for (int i = page.messages.size() - 1; i >= 0 && warmed < kWarmImages; --i) {
+        const MessageData& msg = page.messages[i];
+        if (!msg.isImage() || msg.imagePath.isEmpty()) continue;
+
+        ImageLoader::instance().loadThumbnail(msg.imagePath, ThumbnailTier::Medium, this, ImagePriority::Low);
+        ++warmed;
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file SessionHistoryCache.h
+ * @brief 会话历史预取缓存头文件
+ *
+ * 该文件定义了SessionHistoryCache类，提前查询会话的第一页消息并预热其中图片的缩略图，
+ * 切换到已预取的会话时不必等待数据库和图片解码。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include "../Model/DataModels.h"
+
+/**
+ * @brief 会话历史预取缓存类
+ *
+ * 按会话保存第一页消息的查询 future，最多保留 kCapacity 个，按最近使用淘汰。
+ * 查询在数据库线程中执行，缩略图以低优先级在 ImageLoader 的线程池中解码，GUI 线程只做登记。
+ * 缓存内容可能落后于数据库，会话有新消息后应调用 refresh() 或 invalidate()。
+ */
+class SessionHistoryCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit SessionHistoryCache(QObject* parent = nullptr);
+
+    /**
+     * @brief 预取会话的第一页消息和缩略图
+     * @param sessionId 会话ID
+     *
+     * 已缓存或正在查询时只刷新其最近使用顺序
+     */
+    void prefetch(int sessionId);
+
+    /**
+     * @brief 重新查询会话的第一页
+     * @param sessionId 会话ID
+     *
+     * 用于离开一个会话时保存它的最新状态，之后切回可以立即显示
+     */
+    void refresh(int sessionId);
+
+    /**
+     * @brief 丢弃会话的缓存
+     * @param sessionId 会话ID
+     */
+    void invalidate(int sessionId);
+
+    /**
+     * @brief 获取已就绪的第一页
+     * @param sessionId 会话ID
+     * @param page 输出的分页结果
+     * @return bool 缓存中已有查询完成的结果时返回 true
+     */
+    bool readyPage(int sessionId, MessagePage* page);
+
+    /**
+     * @brief 获取第一页
+     * @param sessionId 会话ID
+     * @return QFuture<MessagePage> 正在进行的预取，或新发起的查询
+     */
+    QFuture<MessagePage> page(int sessionId);
+
+private:
+    /**
+     * @brief 发起查询并登记到缓存
+     * @param sessionId 会话ID
+     * @return QFuture<MessagePage> 查询结果
+     */
+    QFuture<MessagePage> query(int sessionId);
+
+    /**
+     * @brief 把会话移到最近使用的位置并淘汰多余条目
+     * @param sessionId 会话ID
+     */
+    void touch(int sessionId);
+
+    /**
+     * @brief 预热一页中最新几张图片的缩略图
+     * @param page 分页结果
+     */
+    void warmThumbnails(const MessagePage& page);
+
+private:
+    static constexpr int kCapacity = 8;          ///< 最多缓存的会话数
+    static constexpr int kWarmImages = 12;       ///< 每个会话预热的缩略图数
+
+    QHash<int, QFuture<MessagePage>> m_pages;    ///< 会话ID到第一页查询的映射
+    QList<int> m_order;                          ///< 最近使用顺序，末尾最新
+};
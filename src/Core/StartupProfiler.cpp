@@ -0,0 +1,75 @@
+/**
+ * @file StartupProfiler.cpp
+ * @brief 启动耗时分析实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "StartupProfiler.h"
+#include <QElapsedTimer>
+#include <QVector>
+#include <QDebug>
+
+namespace {
+/**
+ * @brief 已记录的阶段
+ */
+struct Phase {
+    QString name; ///< 阶段名称
+    qint64 at;    ///< 结束时间点（毫秒）
+};
+
+QElapsedTimer s_timer;     ///< 启动计时器
+QVector<Phase> s_phases;   ///< 首帧前记录的阶段
+bool s_finished = false;   ///< 是否已输出统计
+}
+
+/**
+ * @brief 开始计时
+ */
+void StartupProfiler::start()
+{
+    s_timer.start();
+    s_phases.clear();
+    s_finished = false;
+}
+
+/**
+ * @brief 记录一个阶段结束
+ * @param phase 阶段名称
+ */
+void StartupProfiler::mark(const QString& phase)
+{
+    if (!s_timer.isValid()) return;
+
+    const qint64 now = s_timer.elapsed();
+    if (s_finished) {
+        qDebug() << "[启动]" << phase << "于" << now << "ms 就绪";
+        return;
+    }
+    s_phases.append({ phase, now });
+}
+
+/**
+ * @brief 结束统计并输出各阶段耗时
+ */
+void StartupProfiler::finish()
+{
+    if (s_finished || !s_timer.isValid()) return;
+    s_finished = true;
+
+    qint64 previous = 0;
+    for (const Phase& phase : s_phases) {
+        qDebug().noquote() << QString("[启动] %1 +%2 ms (%3 ms)")
+                                  .arg(phase.name, -12).arg(phase.at - previous, 4).arg(phase.at);
+        previous = phase.at;
+    }
+
+    const qint64 total = s_timer.elapsed();
+    if (total > kBudgetMs) {
+        qDebug() << "[启动] 可交互用时" << total << "ms，超出" << kBudgetMs << "ms 目标";
+    } else {
+        qDebug() << "[启动] 可交互用时" << total << "ms";
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * @file StartupProfiler.h
+ * @brief 启动耗时分析头文件
+ *
+ * 该文件定义了StartupProfiler类，记录冷启动各阶段相对进程启动的时间点，
+ * 窗口首帧绘制完成后输出各阶段耗时和可交互时间。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QString>
+
+/**
+ * @brief 启动耗时分析类
+ *
+ * 静态工具类，只在 GUI 线程调用。main() 开头调用 start()，关键步骤结束时调用 mark()，
+ * 主窗口首帧绘制完成后调用 finish()。之后的 mark()（如会话列表、首个会话历史就绪）
+ * 仍会输出时间点，但不计入可交互时间。
+ */
+class StartupProfiler
+{
+public:
+    /**
+     * @brief 开始计时
+     */
+    static void start();
+
+    /**
+     * @brief 记录一个阶段结束
+     * @param phase 阶段名称
+     */
+    static void mark(const QString& phase);
+
+    /**
+     * @brief 结束统计并输出各阶段耗时
+     *
+     * 重复调用只有第一次生效
+     */
+    static void finish();
+
+    static constexpr qint64 kBudgetMs = 300; ///< 可交互时间目标
+};
@@ -0,0 +1,205 @@
+/**
+ * @file ThumbnailCache.cpp
+ * @brief 缩略图磁盘缓存实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "ThumbnailCache.h"
+#include "ImageLoader.h"
+#include <QCryptographicHash>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDirIterator>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QVector>
+#include <QDebug>
+#include <algorithm>
+
+/// 所有档位，generate() 和 invalidate() 按此遍历
+static const ThumbnailTier kAllTiers[] = { ThumbnailTier::Small, ThumbnailTier::Medium };
+
+/**
+ * @brief 读取缩略图，缓存缺失或失效时从原图生成
+ * @param sourcePath 原图路径
+ * @param tier 缩略图档位
+ * @return QImage 缩略图，原图不存在或无法解码时为空
+ */
+QImage ThumbnailCache::load(const QString& sourcePath, ThumbnailTier tier)
+{
+    QFileInfo source(sourcePath);
+    if (!source.exists()) return QImage();
+
+    const QString thumbPath = cachePath(sourcePath, tier);
+    QFileInfo thumb(thumbPath);
+
+    if (thumb.exists() && thumb.lastModified() >= source.lastModified()) {
+        QImage cached(thumbPath);
+        if (!cached.isNull()) return cached;
+    }
+
+    // 缓存缺失（例如引入缓存之前的旧图）：直接解码到目标尺寸
+    QImage image = ImageLoader::decode(sourcePath, boundFor(tier));
+    if (image.isNull()) return QImage();
+
+    save(image, thumbPath);
+    return image;
+}
+
+/**
+ * @brief 为刚保存的原图生成全部档位
+ * @param sourcePath 原图路径（同时作为缓存键）
+ */
+void ThumbnailCache::generate(const QString& sourcePath)
+{
+    QFile file(sourcePath);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    // 文件刚写入，仍在页缓存中；映射后直接解码，不再复制一份原始字节
+    const qint64 size = file.size();
+    uchar* mapped = file.map(0, size);
+    if (!mapped) return;
+
+    QImage image = QImage::fromData(QByteArrayView(mapped, size));
+    file.unmap(mapped);
+    if (image.isNull()) return;
+
+    for (ThumbnailTier tier : kAllTiers) {
+        save(scaleToTier(image, tier), cachePath(sourcePath, tier));
+    }
+}
+
+/**
+ * @brief 删除原图对应的全部缩略图
+ * @param sourcePath 原图路径
+ */
+void ThumbnailCache::invalidate(const QString& sourcePath)
+{
+    for (ThumbnailTier tier : kAllTiers) {
+        QFile::remove(cachePath(sourcePath, tier));
+    }
+}
+
+/**
+ * @brief 将缓存总大小控制在上限以内
+ * @param maxBytes 缓存上限
+ */
+void ThumbnailCache::trim(qint64 maxBytes)
+{
+    struct Entry {
+        QString path;
+        qint64 size;
+        qint64 modified;
+    };
+
+    QVector<Entry> entries;
+    qint64 total = 0;
+
+    QDirIterator it(rootDir(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        QFileInfo info = it.fileInfo();
+        entries.append({path, info.size(), info.lastModified().toMSecsSinceEpoch()});
+        total += info.size();
+    }
+
+    if (total <= maxBytes) return;
+
+    // 一次删到上限的 80%，避免每次新增缩略图都触发清理
+    const qint64 target = maxBytes / 5 * 4;
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.modified < b.modified;
+    });
+
+    int removed = 0;
+    for (const Entry& entry : entries) {
+        if (total <= target) break;
+        if (QFile::remove(entry.path)) {
+            total -= entry.size;
+            ++removed;
+        }
+    }
+
+    qDebug() << "缩略图缓存超出上限，已清理:" << removed;
+}
+
+/**
+ * @brief 档位的尺寸上限
+ * @param tier 缩略图档位
+ * @return QSize 缩略图不超过的宽高
+ */
+QSize ThumbnailCache::boundFor(ThumbnailTier tier)
+{
+    switch (tier) {
+    case ThumbnailTier::Small:  return QSize(256, 1024);
+    case ThumbnailTier::Medium: return QSize(512, 512);
+    }
+    return QSize(512, 512);
+}
+
+/**
+ * @brief 缩略图缓存根目录
+ * @return QString thumbnails 目录路径
+ */
+QString ThumbnailCache::rootDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/thumbnails";
+}
+
+/**
+ * @brief 计算缩略图路径
+ * @param sourcePath 原图路径
+ * @param tier 缩略图档位
+ * @return QString 缩略图完整路径
+ */
+QString ThumbnailCache::cachePath(const QString& sourcePath, ThumbnailTier tier)
+{
+    const QString key = QString::fromLatin1(
+        QCryptographicHash::hash(sourcePath.toUtf8(), QCryptographicHash::Blake2b_160).toHex());
+    const QString tierName = (tier == ThumbnailTier::Small) ? QStringLiteral("s") : QStringLiteral("m");
+
+    return QString("%1/%2/%3/%4.thumb").arg(rootDir(), tierName, key.left(2), key);
+}
+
+/**
+ * @brief 将图片缩小到档位尺寸以内（不放大）
+ * @param image 原图
+ * @param tier 缩略图档位
+ * @return QImage 缩略图
+ */
+QImage ThumbnailCache::scaleToTier(const QImage& image, ThumbnailTier tier)
+{
+    QSize bound = boundFor(tier);
+    if (image.width() <= bound.width() && image.height() <= bound.height()) return image;
+    return image.scaled(bound, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+/**
+ * @brief 写入缩略图文件
+ * @param image 缩略图
+ * @param path 目标路径
+ * @return bool 是否写入成功
+ */
+bool ThumbnailCache::save(const QImage& image, const QString& path)
+{
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return false;
+
+    // 多个线程可能同时为同一张图生成缩略图，先写临时文件再原子替换
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QImageWriter writer(&file, image.hasAlphaChannel() ? "png" : "jpeg");
+    if (!image.hasAlphaChannel()) writer.setQuality(85);
+
+    if (!writer.write(image)) {
+        qDebug() << "写入缩略图失败:" << path << writer.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
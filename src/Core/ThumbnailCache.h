@@ -0,0 +1,108 @@
+/**
+ * @file ThumbnailCache.h
+ * @brief 缩略图磁盘缓存头文件
+ * 
+ * 该文件定义了ThumbnailCache类，为生成结果按固定档位缓存缩略图，
+ * 画廊和聊天历史只需解码小图，不必每次打开都解码并缩放原图。
+ * 
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+/**
+ * @brief 缩略图档位
+ */
+enum class ThumbnailTier {
+    Small,  ///< 画廊卡片（宽 256，高不超过 1024）
+    Medium  ///< 聊天气泡（512 x 512 以内）
+};
+
+/**
+ * @brief 缩略图磁盘缓存类
+ * 
+ * 纯函数集合，不持有状态，可以在任意工作线程调用（返回 QImage 而不是 QPixmap）。
+ * 缩略图存放在 thumbnails/<档位>/<键前两位>/<键>.thumb，键由原图路径哈希得到；
+ * 原图修改时间晚于缩略图即视为失效并重新生成。格式按内容识别：
+ * 不透明图片存 JPEG，带透明通道的存 PNG。
+ */
+class ThumbnailCache
+{
+public:
+    /**
+     * @brief 读取缩略图，缓存缺失或失效时从原图生成
+     * @param sourcePath 原图路径
+     * @param tier 缩略图档位
+     * @return QImage 缩略图，原图不存在或无法解码时为空
+     */
+    static QImage load(const QString& sourcePath, ThumbnailTier tier);
+
+    /**
+     * @brief 为刚保存的原图生成全部档位
+     * @param sourcePath 原图路径（同时作为缓存键）
+     *
+     * 保存生成结果后在后台调用，原图以内存映射读取且只解码一次
+     */
+    static void generate(const QString& sourcePath);
+
+    /**
+     * @brief 删除原图对应的全部缩略图
+     * @param sourcePath 原图路径
+     */
+    static void invalidate(const QString& sourcePath);
+
+    /**
+     * @brief 将缓存总大小控制在上限以内
+     * @param maxBytes 缓存上限
+     *
+     * 超出上限时按修改时间从旧到新删除，直到降到上限的 80%。会遍历整个缓存目录，应在后台线程调用
+     */
+    static void trim(qint64 maxBytes = kMaxCacheBytes);
+
+    /**
+     * @brief 档位的尺寸上限
+     * @param tier 缩略图档位
+     * @return QSize 缩略图不超过的宽高
+     */
+    static QSize boundFor(ThumbnailTier tier);
+
+    static constexpr qint64 kMaxCacheBytes = 256LL * 1024 * 1024; ///< 默认缓存上限
+
+private:
+    /**
+     * @brief 缩略图缓存根目录
+     * @return QString thumbnails 目录路径
+     */
+    static QString rootDir();
+
+    /**
+     * @brief 计算缩略图路径
+     * @param sourcePath 原图路径
+     * @param tier 缩略图档位
+     * @return QString 缩略图完整路径
+     */
+    static QString cachePath(const QString& sourcePath, ThumbnailTier tier);
+
+    /**
+     * @brief 将图片缩小到档位尺寸以内（不放大）
+     * @param image 原图
+     * @param tier 缩略图档位
+     * @return QImage 缩略图
+     */
+    static QImage scaleToTier(const QImage& image, ThumbnailTier tier);
+
+    /**
+     * @brief 写入缩略图文件
+     * @param image 缩略图
+     * @param path 目标路径
+     * @return bool 是否写入成功
+     */
+    static bool save(const QImage& image, const QString& path);
+};
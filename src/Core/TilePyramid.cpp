@@ -0,0 +1,158 @@
+/**
+ * @file TilePyramid.cpp
+ * @brief 图片瓦片金字塔实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "TilePyramid.h"
+#include "ImageLoader.h"
+#include <QtMath>
+
+namespace {
+/**
+ * @brief 是否已取消
+ * @param cancelled 取消标记，可为空
+ * @return bool 是否已取消
+ */
+bool isCancelled(const std::atomic_bool* cancelled)
+{
+    return cancelled && cancelled->load();
+}
+}
+
+/**
+ * @brief 从图片文件构建金字塔
+ * @param path 图片路径
+ * @param cancelled 取消标记
+ * @return std::shared_ptr<const TilePyramid> 金字塔，失败或被取消时为空
+ */
+std::shared_ptr<const TilePyramid> TilePyramid::fromFile(const QString& path, const std::atomic_bool* cancelled)
+{
+    if (isCancelled(cancelled)) return nullptr;
+    return fromImage(ImageLoader::decode(path, QSize()), cancelled);
+}
+
+/**
+ * @brief 从已解码的图片构建金字塔
+ * @param image 原图
+ * @param cancelled 取消标记
+ * @return std::shared_ptr<const TilePyramid> 金字塔，失败或被取消时为空
+ */
+std::shared_ptr<const TilePyramid> TilePyramid::fromImage(QImage image, const std::atomic_bool* cancelled)
+{
+    if (image.isNull()) return nullptr;
+
+    // 统一为光栅引擎可直接绘制的格式，绘制时不再逐帧转换
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    image = std::move(image).convertToFormat(format);
+
+    auto pyramid = std::make_shared<TilePyramid>();
+    pyramid->m_size = image.size();
+
+    while (true) {
+        if (isCancelled(cancelled)) return nullptr;
+
+        pyramid->m_levels.append(cut(image));
+        if (image.width() <= kTileSize && image.height() <= kTileSize) break;
+
+        image = image.scaled(qMax(1, image.width() / 2), qMax(1, image.height() / 2),
+                             Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    return pyramid;
+}
+
+/**
+ * @brief 把一层图片切成瓦片
+ * @param image 该层图片
+ * @return Level 切好的层级
+ */
+TilePyramid::Level TilePyramid::cut(const QImage& image)
+{
+    Level level;
+    level.size = image.size();
+    level.columns = (image.width() + kTileSize - 1) / kTileSize;
+    level.rows = (image.height() + kTileSize - 1) / kTileSize;
+    level.tiles.reserve(level.columns * level.rows);
+
+    for (int row = 0; row < level.rows; ++row) {
+        for (int column = 0; column < level.columns; ++column) {
+            const QRect rect(column * kTileSize, row * kTileSize,
+                             qMin(kTileSize, image.width() - column * kTileSize),
+                             qMin(kTileSize, image.height() - row * kTileSize));
+            level.tiles.append(image.copy(rect));
+        }
+    }
+    return level;
+}
+
+/**
+ * @brief 按显示比例选择层级
+ * @param scale 原图像素到屏幕像素的比例
+ * @return int 层级
+ */
+int TilePyramid::levelFor(qreal scale) const
+{
+    if (scale <= 0) return m_levels.size() - 1;
+
+    const int level = qFloor(std::log2(1.0 / scale));
+    return qBound(0, level, m_levels.size() - 1);
+}
+
+/**
+ * @brief 覆盖指定区域的瓦片范围
+ * @param level 层级
+ * @param area 原图坐标中的区域
+ * @return QRect 瓦片行列范围
+ */
+QRect TilePyramid::tilesIn(int level, const QRectF& area) const
+{
+    const QRectF clipped = area.intersected(QRectF(QPointF(0, 0), QSizeF(m_size)));
+    if (clipped.isEmpty()) return QRect();
+
+    // 原图中一块瓦片的跨度
+    const Level& l = m_levels[level];
+    const qreal spanX = qreal(kTileSize) * m_size.width() / l.size.width();
+    const qreal spanY = qreal(kTileSize) * m_size.height() / l.size.height();
+
+    const int firstColumn = qBound(0, qFloor(clipped.left() / spanX), l.columns - 1);
+    const int lastColumn = qBound(0, qCeil(clipped.right() / spanX) - 1, l.columns - 1);
+    const int firstRow = qBound(0, qFloor(clipped.top() / spanY), l.rows - 1);
+    const int lastRow = qBound(0, qCeil(clipped.bottom() / spanY) - 1, l.rows - 1);
+    return QRect(QPoint(firstColumn, firstRow), QPoint(lastColumn, lastRow));
+}
+
+/**
+ * @brief 获取瓦片
+ * @param level 层级
+ * @param column 列号
+ * @param row 行号
+ * @return const QImage& 瓦片图片
+ */
+const QImage& TilePyramid::tile(int level, int column, int row) const
+{
+    const Level& l = m_levels[level];
+    return l.tiles[row * l.columns + column];
+}
+
+/**
+ * @brief 瓦片在原图坐标中的区域
+ * @param level 层级
+ * @param column 列号
+ * @param row 行号
+ * @return QRectF 瓦片覆盖的原图区域
+ *
+ * 各层尺寸逐级向下取整，按该层与原图的比例映射回去，相邻瓦片首尾相接没有缝隙
+ */
+QRectF TilePyramid::tileRect(int level, int column, int row) const
+{
+    const Level& l = m_levels[level];
+    const qreal sx = qreal(m_size.width()) / l.size.width();
+    const qreal sy = qreal(m_size.height()) / l.size.height();
+    const QImage& image = l.tiles[row * l.columns + column];
+
+    return QRectF(column * kTileSize * sx, row * kTileSize * sy, image.width() * sx, image.height() * sy);
+}
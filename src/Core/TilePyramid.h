@@ -0,0 +1,123 @@
+/**
+ * @file TilePyramid.h
+ * @brief 图片瓦片金字塔头文件
+ *
+ * 该文件定义了TilePyramid类，把大图切成固定大小的瓦片并逐级缩小一半，
+ * 查看器按当前缩放只绘制对应层级中可见的瓦片，绘制开销与图片尺寸无关。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief 图片瓦片金字塔类
+ *
+ * 第 0 层为原图，第 n 层边长为原图的 1/2^n，最后一层能放进单个瓦片。
+ * 构建完成后只读，可以在线程间共享；构建在工作线程进行，耗时主要在原图解码。
+ */
+class TilePyramid
+{
+public:
+    /**
+     * @brief 从图片文件构建金字塔
+     * @param path 图片路径
+     * @param cancelled 取消标记，置位后尽快返回空指针，可为空
+     * @return std::shared_ptr<const TilePyramid> 金字塔，解码失败或被取消时为空
+     *
+     * 可在任意线程调用
+     */
+    static std::shared_ptr<const TilePyramid> fromFile(const QString& path, const std::atomic_bool* cancelled = nullptr);
+
+    /**
+     * @brief 从已解码的图片构建金字塔
+     * @param image 原图
+     * @param cancelled 取消标记，置位后尽快返回空指针，可为空
+     * @return std::shared_ptr<const TilePyramid> 金字塔，图片为空或被取消时为空
+     *
+     * 可在任意线程调用
+     */
+    static std::shared_ptr<const TilePyramid> fromImage(QImage image, const std::atomic_bool* cancelled = nullptr);
+
+    /**
+     * @brief 原图尺寸
+     * @return QSize 原图宽高
+     */
+    QSize size() const { return m_size; }
+
+    /**
+     * @brief 层数
+     * @return int 层数，至少为 1
+     */
+    int levelCount() const { return m_levels.size(); }
+
+    /**
+     * @brief 按显示比例选择层级
+     * @param scale 原图像素到屏幕像素的比例
+     * @return int 不比显示比例更粗糙的最小一层
+     *
+     * 选中层级绘制时只会缩小到 1/2 以内，平滑缩放的开销和质量都有保证
+     */
+    int levelFor(qreal scale) const;
+
+    /**
+     * @brief 覆盖指定区域的瓦片范围
+     * @param level 层级
+     * @param area 原图坐标中的区域
+     * @return QRect 列号为 x，行号为 y 的闭区间；区域与原图不相交时为空
+     */
+    QRect tilesIn(int level, const QRectF& area) const;
+
+    /**
+     * @brief 获取瓦片
+     * @param level 层级
+     * @param column 列号
+     * @param row 行号
+     * @return const QImage& 瓦片图片（边缘瓦片小于 kTileSize）
+     */
+    const QImage& tile(int level, int column, int row) const;
+
+    /**
+     * @brief 瓦片在原图坐标中的区域
+     * @param level 层级
+     * @param column 列号
+     * @param row 行号
+     * @return QRectF 瓦片覆盖的原图区域
+     */
+    QRectF tileRect(int level, int column, int row) const;
+
+    static constexpr int kTileSize = 512; ///< 瓦片边长（像素）
+
+private:
+    /**
+     * @brief 单个层级
+     */
+    struct Level {
+        QSize size;            ///< 该层图片尺寸
+        int columns = 0;       ///< 列数
+        int rows = 0;          ///< 行数
+        QVector<QImage> tiles; ///< 按行排列的瓦片
+    };
+
+    /**
+     * @brief 把一层图片切成瓦片
+     * @param image 该层图片
+     * @return Level 切好的层级
+     */
+    static Level cut(const QImage& image);
+
+private:
+    QSize m_size;            ///< 原图尺寸
+    QVector<Level> m_levels; ///< 各层级，0 为原图
+};
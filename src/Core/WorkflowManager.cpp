@@ -13,6 +13,7 @@
 #include <QJsonValue>
 #include <QDebug>
 #include <QRandomGenerator>
+#include <QCryptographicHash>
 
 /**
  * @brief 构造函数
@@ -51,6 +52,79 @@ QJsonObject WorkflowManager::buildWorkflow(WorkflowType type, const QMap<QString
     }
 }
 
+/**
+ * @brief 获取工作流类型对应的模板资源路径
+ * @param type 工作流类型
+ * @return QString 资源路径，未知类型返回空
+ */
+QString WorkflowManager::templatePath(WorkflowType type)
+{
+    switch (type) {
+    case WorkflowType::TextToImage:   return ":/workflows/t2i";
+    case WorkflowType::Upscale:       return ":/workflows/upscale";
+    case WorkflowType::ImageToImage:  return ":/workflows/render";
+    case WorkflowType::VisionCaption: return ":/workflows/vision";
+    default:                          return QString();
+    }
+}
+
+/**
+ * @brief 获取工作流对参考图的上传前缩放策略
+ * @param type 工作流类型
+ * @return UploadResizePolicy 缩放策略
+ */
+UploadResizePolicy WorkflowManager::uploadResizePolicy(WorkflowType type)
+{
+    if (m_resizePolicies.contains(type)) return m_resizePolicies.value(type);
+
+    UploadResizePolicy policy;
+    QString path = templatePath(type);
+    QJsonObject workflow = path.isEmpty() ? QJsonObject() : loadTemplate(path);
+
+    for (auto it = workflow.constBegin(); it != workflow.constEnd(); ++it) {
+        QJsonObject node = it.value().toObject();
+        if (node["class_type"].toString() != "MySmartResize") continue;
+
+        QJsonObject inputs = node["inputs"].toObject();
+        QString mode = inputs["mode"].toString();
+        policy.targetValue = inputs["target_value"].toInt();
+
+        if (mode == "Long Edge Limit") {
+            policy.mode = UploadResizePolicy::Mode::LongEdge;
+        } else if (mode == "Megapixel Limit") {
+            policy.mode = UploadResizePolicy::Mode::Megapixel;
+        } else {
+            qDebug() << "未识别的 MySmartResize 模式，不做客户端缩放:" << mode;
+        }
+        break;
+    }
+
+    m_resizePolicies.insert(type, policy);
+    return policy;
+}
+
+/**
+ * @brief 获取工作流模板的内容哈希
+ * @param type 工作流类型
+ * @return QString 模板文件的 SHA-256 十六进制字符串，模板不存在时返回空
+ */
+QString WorkflowManager::templateHash(WorkflowType type)
+{
+    if (m_templateHashes.contains(type)) return m_templateHashes.value(type);
+
+    QFile file(templatePath(type));
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法读取模板计算哈希:" << file.fileName();
+        return QString();
+    }
+
+    QString hash = QString::fromLatin1(
+        QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha256).toHex());
+
+    m_templateHashes.insert(type, hash);
+    return hash;
+}
+
 /**
  * @brief 构建文生图工作流
  * @param params 用户输入参数
@@ -58,7 +132,7 @@ QJsonObject WorkflowManager::buildWorkflow(WorkflowType type, const QMap<QString
  */
 QJsonObject WorkflowManager::buildTextToImage(const QMap<QString, QVariant>& params)
 {
-    QJsonObject workflow = loadTemplate(":/workflows/t2i");
+    QJsonObject workflow = loadTemplate(templatePath(WorkflowType::TextToImage));
     if (workflow.isEmpty()) return QJsonObject();
 
     if (params.contains("prompt")) {
@@ -84,7 +158,7 @@ QJsonObject WorkflowManager::buildTextToImage(const QMap<QString, QVariant>& par
  */
 QJsonObject WorkflowManager::buildUpscale(const QMap<QString, QVariant>& params)
 {
-    QJsonObject workflow = loadTemplate(":/workflows/upscale");
+    QJsonObject workflow = loadTemplate(templatePath(WorkflowType::Upscale));
     if (workflow.isEmpty()) return QJsonObject();
 
     if (params.contains("image_path")) {
@@ -161,10 +235,10 @@ QJsonObject WorkflowManager::loadTemplate(const QString& resourcePath)
  */
 QJsonObject WorkflowManager::buildVisionCaption(const QMap<QString, QVariant>& params)
 {
-    QJsonObject workflow = loadTemplate(":/workflows/vision");
+    QJsonObject workflow = loadTemplate(templatePath(WorkflowType::VisionCaption));
 
     if (workflow.isEmpty()) {
-        qDebug() << "无法加载反推模板 :/workflows/vision";
+        qDebug() << "无法加载反推模板" << templatePath(WorkflowType::VisionCaption);
         return QJsonObject();
     }
 
@@ -191,7 +265,7 @@ QJsonObject WorkflowManager::buildVisionCaption(const QMap<QString, QVariant>& p
  */
 QJsonObject WorkflowManager::buildImageToImage(const QMap<QString, QVariant>& params)
 {
-    QJsonObject workflow = loadTemplate(":/workflows/render");
+    QJsonObject workflow = loadTemplate(templatePath(WorkflowType::ImageToImage));
     if (workflow.isEmpty()) return QJsonObject();
 
     if (params.contains("image_path")) {
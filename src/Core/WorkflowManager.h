@@ -43,7 +43,30 @@ public:
      */
     QJsonObject buildWorkflow(WorkflowType type, const QMap<QString, QVariant>& params);
 
+    /**
+     * @brief 获取工作流对参考图的上传前缩放策略
+     * @param type 工作流类型
+     * @return UploadResizePolicy 从模板的 MySmartResize 节点解析出的策略，没有该节点时不缩放
+     */
+    UploadResizePolicy uploadResizePolicy(WorkflowType type);
+
+    /**
+     * @brief 获取工作流模板的内容哈希
+     * @param type 工作流类型
+     * @return QString 模板文件的 SHA-256 十六进制字符串，模板不存在时返回空
+     *
+     * 随生成记录一起保存，用于复现时确认模板版本
+     */
+    QString templateHash(WorkflowType type);
+
 private:
+    /**
+     * @brief 获取工作流类型对应的模板资源路径
+     * @param type 工作流类型
+     * @return QString 资源路径，未知类型返回空
+     */
+    static QString templatePath(WorkflowType type);
+
     /**
      * @brief 加载资源文件中的JSON模板
      * @param resourcePath 资源文件路径
@@ -87,4 +110,8 @@ private:
      * @return QJsonObject 视觉反推工作流JSON对象
      */
     QJsonObject buildVisionCaption(const QMap<QString, QVariant>& params);
+
+private:
+    QMap<WorkflowType, UploadResizePolicy> m_resizePolicies; ///< 已解析的缩放策略缓存
+    QMap<WorkflowType, QString> m_templateHashes; ///< 模板哈希缓存
 };
@@ -1,22 +1,34 @@
 /**
  * @file DatabaseManager.cpp
  * @brief 数据库管理器实现文件
- * 
+ *
  * 该文件实现了DatabaseManager类，负责应用程序的数据库操作。
  * 使用单例模式管理数据库连接，提供会话和消息的增删改查接口。
- * 
+ * SQLite 连接运行在独立的工作线程上，所有接口均返回 QFuture，GUI 线程不执行任何 SQL。
+ *
  * @author CloudArt Team
  * @version 1.0
  * @date 2024
  */
 
 #include "DatabaseManager.h"
+#include "../Core/ImageStore.h"
+#include "../Core/ThumbnailCache.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QDebug>
 #include <QVariant>
+#include <QSet>
+#include <QRegularExpression>
+#include <algorithm>
+#include <limits>
+
+/// 数据库线程使用的命名连接（QSqlDatabase 连接只能在创建它的线程使用）
+static const char kConnectionName[] = "cloudart_db";
 
 /**
  * @brief 获取单例实例
@@ -39,220 +51,1346 @@ DatabaseManager::DatabaseManager(QObject *parent) : QObject(parent) {}
  */
 DatabaseManager::~DatabaseManager()
 {
-    if (m_db.isOpen()) m_db.close();
+    shutdown();
 }
 
 /**
  * @brief 初始化数据库
- * @return bool 初始化是否成功
- * 
- * 打开数据库连接并创建必要的数据表
+ * @return QFuture<bool> 初始化是否成功
+ *
+ * 启动数据库线程，并在该线程上打开连接、创建必要的数据表
+ */
+QFuture<bool> DatabaseManager::init()
+{
+    if (m_thread) return m_initFuture;
+
+    m_thread = new QThread(this);
+    m_thread->setObjectName("DatabaseThread");
+
+    m_worker = new QObject();
+    m_worker->moveToThread(m_thread);
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread->start();
+
+    m_initFuture = enqueue([this]() {
+        QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+
+        QDir dir(dataDir);
+        if (!dir.exists()) dir.mkpath(".");
+
+        QString dbPath = dataDir + "/cloudart.db";
+        qDebug() << "数据库路径:" << dbPath;
+
+        m_db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+        m_db.setDatabaseName(dbPath);
+
+        if (!m_db.open()) {
+            qDebug() << "打开数据库失败:" << m_db.lastError().text();
+            return false;
+        }
+
+        configureConnection();
+
+        m_flushTimer = new QTimer(m_worker);
+        m_flushTimer->setSingleShot(true);
+        m_flushTimer->setInterval(kFlushIntervalMs);
+        connect(m_flushTimer, &QTimer::timeout, m_worker, [this]() { flushWrites(); });
+
+        if (!migrate()) return false;
+
+        loadSearchIndexState();
+
+        m_gcTimer = new QTimer(m_worker);
+        m_gcTimer->setSingleShot(true);
+        connect(m_gcTimer, &QTimer::timeout, m_worker, [this]() { collectGarbage(); });
+        scheduleGarbageCollection(kGcStartupDelayMs);
+        return true;
+    });
+
+    return m_initFuture;
+}
+
+/**
+ * @brief 关闭数据库
+ *
+ * 等待已排队的操作执行完毕、提交未完成的写批次后关闭连接并退出数据库线程
+ */
+void DatabaseManager::shutdown()
+{
+    if (!m_thread || !m_thread->isRunning()) return;
+
+    enqueue([this]() {
+        if (m_gcTimer) m_gcTimer->stop();
+        if (m_backfillTimer) m_backfillTimer->stop();
+        m_orphanScan.reset();
+        flushWrites();
+        if (m_db.isOpen()) m_db.close();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(kConnectionName);
+    }).waitForFinished();
+
+    m_thread->quit();
+    m_thread->wait();
+    m_worker = nullptr; // 已随线程结束通过 deleteLater 释放
+}
+
+/**
+ * @brief 数据库迁移脚本
+ * @return QVector<QStringList> 第 i 项为升级到版本 i+1 需执行的语句
+ *
+ * 版本号记录在 PRAGMA user_version 中。只允许在末尾追加新版本，已发布的版本不可修改。
+ */
+static const QVector<QStringList>& migrations()
+{
+    static const QVector<QStringList> steps = {
+        // v1：初始表结构（旧版本数据库已存在这些表，user_version 为 0）
+        {
+            "CREATE TABLE IF NOT EXISTS tb_sessions ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "title TEXT NOT NULL, "
+            "created_at INTEGER"
+            ")",
+            "CREATE TABLE IF NOT EXISTS tb_messages ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "session_id INTEGER, "
+            "role TEXT, "
+            "content TEXT, "
+            "image_path TEXT, "
+            "timestamp INTEGER"
+            ")"
+        },
+        // v2：role 改为整数存储（0=用户，1=AI），并为时间线与会话列表建立索引
+        {
+            "CREATE TABLE tb_messages_v2 ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "session_id INTEGER NOT NULL, "
+            "role INTEGER NOT NULL DEFAULT 0, "
+            "content TEXT DEFAULT '', "
+            "image_path TEXT DEFAULT '', "
+            "timestamp INTEGER NOT NULL DEFAULT 0"
+            ")",
+            "INSERT INTO tb_messages_v2 (id, session_id, role, content, image_path, timestamp) "
+            "SELECT id, IFNULL(session_id, -1), CASE role WHEN 'user' THEN 0 ELSE 1 END, "
+            "IFNULL(content, ''), IFNULL(image_path, ''), IFNULL(timestamp, 0) FROM tb_messages",
+            "DROP TABLE tb_messages",
+            "ALTER TABLE tb_messages_v2 RENAME TO tb_messages",
+            // 会话时间线：按会话过滤并按时间有序读取，无需排序
+            "CREATE INDEX idx_messages_session_time ON tb_messages (session_id, timestamp, id)",
+            "CREATE INDEX idx_sessions_created ON tb_sessions (created_at DESC)"
+        },
+        // v3：图库只收录 AI 图片的部分索引，(timestamp, id) 键集分页可直接沿索引有序读取
+        {
+            "CREATE INDEX idx_messages_gallery ON tb_messages (timestamp, id, image_path, role, session_id) "
+            "WHERE role = 1 AND image_path != ''"
+        },
+        // v4：生成任务元数据，按工作流、服务器、种子和时间筛选
+        {
+            "CREATE TABLE tb_generations ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "message_id INTEGER, "
+            "prompt_id TEXT, "
+            "workflow_type INTEGER NOT NULL, "
+            "template_hash TEXT, "
+            "params TEXT, "
+            "seed INTEGER, "
+            "width INTEGER, "
+            "height INTEGER, "
+            "backend_url TEXT, "
+            "submitted_at INTEGER, "
+            "started_at INTEGER, "
+            "executed_at INTEGER, "
+            "finished_at INTEGER, "
+            "upload_ms INTEGER, "
+            "queue_ms INTEGER, "
+            "execute_ms INTEGER, "
+            "download_ms INTEGER, "
+            "total_ms INTEGER"
+            ")",
+            // 按消息取最近一次生成的尺寸（画廊排版），覆盖 width/height 后无需回表
+            "CREATE INDEX idx_generations_message ON tb_generations (message_id, id, width, height)",
+            "CREATE INDEX idx_generations_type_time ON tb_generations (workflow_type, submitted_at)",
+            "CREATE INDEX idx_generations_backend_time ON tb_generations (backend_url, submitted_at)",
+            "CREATE INDEX idx_generations_seed ON tb_generations (seed)"
+        },
+        // v5（可选）：全文索引。trigram 分词按三字符切分，对中文提示词同样有效并支持任意子串匹配；
+        // 两个字的查询由双字索引覆盖（无内容表，索引词由程序生成）。
+        // 已有消息不在迁移中建索引，由启动后的后台任务按 tb_search_backfill 记录的进度分批补建
+        {
+            "CREATE TABLE tb_search_backfill ("
+            "done_upto INTEGER NOT NULL, "
+            "pending_max INTEGER NOT NULL"
+            ")",
+            "INSERT INTO tb_search_backfill (done_upto, pending_max) SELECT 0, IFNULL(MAX(id), 0) FROM tb_messages",
+            "CREATE VIRTUAL TABLE tb_messages_fts USING fts5("
+            "content, content = 'tb_messages', content_rowid = 'id', tokenize = 'trigram')",
+            "CREATE VIRTUAL TABLE tb_messages_bigram USING fts5("
+            "grams, content = '', detail = 'none', tokenize = 'unicode61')",
+            // 新消息的 ID 都大于补建范围，直接入索引
+            "CREATE TRIGGER trg_messages_fts_insert AFTER INSERT ON tb_messages BEGIN "
+            "INSERT INTO tb_messages_fts (rowid, content) VALUES (new.id, new.content); "
+            "END",
+            // 尚未补建的消息不在索引中，删除或更新时不能从索引里删除，留给补建按当前内容建立
+            "CREATE TRIGGER trg_messages_fts_delete AFTER DELETE ON tb_messages "
+            "WHEN NOT EXISTS (SELECT 1 FROM tb_search_backfill WHERE old.id > done_upto AND old.id <= pending_max) BEGIN "
+            "INSERT INTO tb_messages_fts (tb_messages_fts, rowid, content) VALUES ('delete', old.id, old.content); "
+            "END",
+            "CREATE TRIGGER trg_messages_fts_update AFTER UPDATE OF content ON tb_messages "
+            "WHEN NOT EXISTS (SELECT 1 FROM tb_search_backfill WHERE old.id > done_upto AND old.id <= pending_max) BEGIN "
+            "INSERT INTO tb_messages_fts (tb_messages_fts, rowid, content) VALUES ('delete', old.id, old.content); "
+            "INSERT INTO tb_messages_fts (rowid, content) VALUES (new.id, new.content); "
+            "END"
+        },
+        // v6：内容寻址图片表，引用计数由 tb_messages 上的触发器维护
+        {
+            "CREATE TABLE tb_images ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "hash TEXT UNIQUE, "
+            "path TEXT NOT NULL UNIQUE, "
+            "size INTEGER, "
+            "ref_count INTEGER NOT NULL DEFAULT 0, "
+            "created_at INTEGER"
+            ")",
+            // 旧版本按时间戳命名的图片没有哈希，按路径登记并统计已有引用
+            "INSERT INTO tb_images (path, ref_count, created_at) "
+            "SELECT image_path, COUNT(*), MIN(timestamp) FROM tb_messages "
+            "WHERE image_path != '' GROUP BY image_path",
+            "CREATE TRIGGER trg_messages_image_insert AFTER INSERT ON tb_messages "
+            "WHEN NEW.image_path != '' BEGIN "
+            "UPDATE tb_images SET ref_count = ref_count + 1 WHERE path = NEW.image_path; "
+            "END",
+            "CREATE TRIGGER trg_messages_image_delete AFTER DELETE ON tb_messages "
+            "WHEN OLD.image_path != '' BEGIN "
+            "UPDATE tb_images SET ref_count = ref_count - 1 WHERE path = OLD.image_path; "
+            "END",
+            "CREATE TRIGGER trg_messages_image_update AFTER UPDATE OF image_path ON tb_messages "
+            "WHEN OLD.image_path IS NOT NEW.image_path BEGIN "
+            "UPDATE tb_images SET ref_count = ref_count - 1 WHERE path = OLD.image_path; "
+            "UPDATE tb_images SET ref_count = ref_count + 1 WHERE path = NEW.image_path; "
+            "END"
+        },
+        // v7：未被引用的图片按登记时间排列，供后台回收按批读取
+        {
+            "CREATE INDEX idx_images_orphan ON tb_images (created_at) WHERE ref_count <= 0"
+        }
+    };
+    return steps;
+}
+
+/**
+ * @brief 是否为可选的迁移版本
+ * @param version 迁移版本号
+ * @return bool 是否可选
+ *
+ * 可选版本依赖 SQLite 的编译选项（如 FTS5），执行失败时回滚表结构变更，记入 tb_skipped_migrations
+ * 后继续升级后续版本。对应功能暂不可用，不影响其他功能，每次启动时重试
+ */
+static bool isOptionalMigration(int version)
+{
+    return version == 5;
+}
+
+/**
+ * @brief 执行一个版本的迁移语句
+ * @param query 数据库连接上的查询对象
+ * @param version 迁移版本号
+ * @return bool 是否全部执行成功，调用方负责事务
+ */
+static bool runMigrationStep(QSqlQuery& query, int version)
+{
+    for (const QString& sql : migrations()[version - 1]) {
+        if (!query.exec(sql)) {
+            qDebug() << "数据库迁移到 v" << version << "失败:" << query.lastError() << sql;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 配置连接参数
+ *
+ * 启用 WAL（读写互不阻塞），同步级别降为 NORMAL（WAL 下仍保证一致性），
+ * 并开启内存映射读取以减少大库的系统调用开销
+ */
+void DatabaseManager::configureConnection()
+{
+    QSqlQuery query(m_db);
+
+    const QStringList pragmas = {
+        "PRAGMA journal_mode = WAL",
+        "PRAGMA synchronous = NORMAL",
+        "PRAGMA mmap_size = 268435456",
+        "PRAGMA temp_store = MEMORY",
+        "PRAGMA cache_size = -16000"
+    };
+
+    for (const QString& sql : pragmas) {
+        if (!query.exec(sql)) qDebug() << "设置失败:" << sql << query.lastError();
+    }
+}
+
+/**
+ * @brief 执行数据库迁移
+ * @return bool 迁移是否成功
+ *
+ * 先重试此前跳过的可选版本，再从当前 user_version 开始逐个版本升级，
+ * 每个版本在独立事务中执行，失败则回滚并停止
+ */
+bool DatabaseManager::migrate()
+{
+    QSqlQuery query(m_db);
+
+    int version = 0;
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        version = query.value(0).toInt();
+    }
+
+    const QVector<QStringList>& steps = migrations();
+
+    if (version > steps.size()) {
+        qDebug() << "数据库版本" << version << "高于程序支持的版本" << steps.size();
+        return false;
+    }
+
+    // 之前因 SQLite 缺少编译选项而跳过的可选版本，换用支持的 SQLite 后在这里补上
+    QVector<int> skipped;
+    if (query.exec("SELECT version FROM tb_skipped_migrations ORDER BY version")) {
+        while (query.next()) skipped.append(query.value(0).toInt());
+    }
+    for (int target : skipped) {
+        m_db.transaction();
+
+        bool ok = runMigrationStep(query, target);
+        if (ok) {
+            query.prepare("DELETE FROM tb_skipped_migrations WHERE version = :version");
+            query.bindValue(":version", target);
+            ok = query.exec();
+        }
+
+        if (!ok) {
+            m_db.rollback();
+            continue;
+        }
+
+        m_db.commit();
+        qDebug() << "已补做可选的数据库版本 v" << target;
+    }
+
+    for (int target = version + 1; target <= steps.size(); ++target) {
+        m_db.transaction();
+
+        // user_version 同样受事务保护，与表结构变更一起提交
+        bool ok = runMigrationStep(query, target)
+                  && query.exec(QString("PRAGMA user_version = %1").arg(target));
+
+        if (!ok) {
+            m_db.rollback();
+            if (!isOptionalMigration(target)) return false;
+
+            // 记下跳过的版本，版本号照常前进，后续版本不受影响
+            qDebug() << "跳过可选的数据库版本 v" << target;
+            m_db.transaction();
+            ok = query.exec("CREATE TABLE IF NOT EXISTS tb_skipped_migrations (version INTEGER PRIMARY KEY)");
+            if (ok) {
+                query.prepare("INSERT OR IGNORE INTO tb_skipped_migrations (version) VALUES (:version)");
+                query.bindValue(":version", target);
+                ok = query.exec();
+            }
+            ok = ok && query.exec(QString("PRAGMA user_version = %1").arg(target));
+            if (!ok) {
+                m_db.rollback();
+                return false;
+            }
+            m_db.commit();
+            continue;
+        }
+
+        m_db.commit();
+        qDebug() << "数据库已升级到 v" << target;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 生成内容的双字索引词
+ * @param content 消息内容
+ * @return QString 以空格分隔、去重后的相邻两字组合
+ *
+ * trigram 索引无法匹配两个字的查询，而中文关键词大多是两个字。相邻的两个文字（字母、数字或汉字）
+ * 组成一个索引词，由 unicode61 分词按空格切开，查询时整体匹配一个词
  */
-bool DatabaseManager::init()
+static QString searchBigrams(const QString& content)
 {
-    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    const QString folded = content.toCaseFolded();
+
+    QSet<QString> grams;
+    for (int i = 0; i + 1 < folded.size(); ++i) {
+        if (folded[i].isLetterOrNumber() && folded[i + 1].isLetterOrNumber()) grams.insert(folded.mid(i, 2));
+    }
+    return QStringList(grams.begin(), grams.end()).join(' ');
+}
+
+/**
+ * @brief 读取全文索引状态
+ */
+void DatabaseManager::loadSearchIndexState()
+{
+    QSqlQuery query(m_db);
+
+    // v5 是可选版本，SQLite 未编译 FTS5 时索引表不存在，搜索回退为 LIKE
+    m_ftsAvailable = query.exec("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' "
+                                "AND name IN ('tb_messages_fts', 'tb_messages_bigram')")
+                     && query.next() && query.value(0).toInt() == 2;
+    if (!m_ftsAvailable) {
+        qDebug() << "FTS5 不可用，搜索将回退为 LIKE";
+        return;
+    }
+
+    m_backfillDone = m_backfillEnd = 0;
+    if (query.exec("SELECT done_upto, pending_max FROM tb_search_backfill") && query.next()) {
+        m_backfillDone = query.value(0).toLongLong();
+        m_backfillEnd = query.value(1).toLongLong();
+    }
+    if (m_backfillDone >= m_backfillEnd) return;
+
+    qDebug() << "全文索引待补建，消息ID" << m_backfillDone << "至" << m_backfillEnd;
+
+    m_backfillTimer = new QTimer(m_worker);
+    m_backfillTimer->setSingleShot(true);
+    connect(m_backfillTimer, &QTimer::timeout, m_worker, [this]() { backfillSearchIndex(); });
+    m_backfillTimer->start(kBackfillStartupDelayMs);
+}
+
+/**
+ * @brief 补建一批消息的全文索引
+ */
+void DatabaseManager::backfillSearchIndex()
+{
+    if (m_backfillDone >= m_backfillEnd) return;
+
+    // 补建在独立事务中进行，先结束当前写批次
+    flushWrites();
+
+    const qint64 from = m_backfillDone;
+    const qint64 to = qMin(from + kBackfillBatchSize, m_backfillEnd);
+    const bool finished = to >= m_backfillEnd;
 
-    QDir dir(dataDir);
-    if (!dir.exists()) dir.mkpath(".");
+    m_db.transaction();
 
-    QString dbPath = dataDir + "/cloudart.db";
-    qDebug() << "数据库路径:" << dbPath;
+    QSqlQuery query(m_db);
+    query.prepare("INSERT INTO tb_messages_fts (rowid, content) "
+                  "SELECT id, content FROM tb_messages WHERE id > :from AND id <= :to");
+    query.bindValue(":from", from);
+    query.bindValue(":to", to);
+    bool ok = query.exec();
 
-    m_db = QSqlDatabase::addDatabase("QSQLITE");
-    m_db.setDatabaseName(dbPath);
+    QSqlQuery grams(m_db);
+    grams.prepare("INSERT INTO tb_messages_bigram (rowid, grams) VALUES (:id, :grams)");
 
-    if (!m_db.open()) {
-        qDebug() << "打开数据库失败:" << m_db.lastError().text();
+    query.prepare("SELECT id, content FROM tb_messages WHERE id > :from AND id <= :to");
+    query.bindValue(":from", from);
+    query.bindValue(":to", to);
+    ok = ok && query.exec();
+    while (ok && query.next()) {
+        grams.bindValue(":id", query.value(0).toLongLong());
+        grams.bindValue(":grams", searchBigrams(query.value(1).toString()));
+        ok = grams.exec();
+    }
+
+    // 进度与索引同一事务提交，中途退出后下次启动从断点继续
+    if (ok) {
+        query.prepare(finished ? QString("DELETE FROM tb_search_backfill")
+                               : QString("UPDATE tb_search_backfill SET done_upto = :to"));
+        if (!finished) query.bindValue(":to", to);
+        ok = query.exec();
+    }
+
+    if (!ok || !m_db.commit()) {
+        qDebug() << "补建全文索引失败:" << query.lastError() << grams.lastError();
+        m_db.rollback();
+        m_backfillTimer->start(kBackfillStartupDelayMs);
+        return;
+    }
+
+    m_backfillDone = finished ? m_backfillEnd : to;
+    if (finished) {
+        qDebug() << "全文索引补建完成";
+        return;
+    }
+    m_backfillTimer->start(kBackfillIntervalMs);
+}
+
+/**
+ * @brief 消息是否已进入全文索引
+ * @param id 消息ID
+ * @return bool 补建已覆盖该消息或该消息在迁移后写入
+ */
+bool DatabaseManager::isSearchIndexed(qint64 id) const
+{
+    return m_ftsAvailable && (id <= m_backfillDone || id > m_backfillEnd);
+}
+
+/**
+ * @brief 写入或删除消息的双字索引
+ * @param id 消息ID
+ * @param content 消息内容，删除时必须与写入时相同
+ * @param remove true 删除，false 写入
+ *
+ * 无内容表删除时需给出原索引词。删除消息时不清理，残留的索引词在查询时与消息表连接后被过滤
+ */
+void DatabaseManager::updateBigramIndex(qint64 id, const QString& content, bool remove)
+{
+    if (!isSearchIndexed(id)) return;
+
+    QSqlQuery query(m_db);
+    query.prepare(remove ? QString("INSERT INTO tb_messages_bigram (tb_messages_bigram, rowid, grams) "
+                                   "VALUES ('delete', :id, :grams)")
+                         : QString("INSERT INTO tb_messages_bigram (rowid, grams) VALUES (:id, :grams)"));
+    query.bindValue(":id", id);
+    query.bindValue(":grams", searchBigrams(content));
+    if (!query.exec()) qDebug() << "更新双字索引失败:" << query.lastError();
+}
+
+/**
+ * @brief 开始写批次
+ * @return bool 批次是否已打开，开启事务失败时为 false
+ *
+ * 批次从第一条写操作开始计时，到期或达到上限即提交，避免每条消息单独提交一次事务
+ */
+bool DatabaseManager::beginWriteBatch()
+{
+    if (m_batchOpen) return true;
+
+    if (!m_db.transaction()) {
+        qDebug() << "开启写批次失败，按自动提交执行:" << m_db.lastError();
         return false;
     }
 
-    createTables();
+    m_batchOpen = true;
+    m_flushTimer->start();
     return true;
 }
 
 /**
- * @brief 创建数据表
- * 
- * 创建会话表和消息表（如果不存在）
+ * @brief 提交当前写批次
+ */
+void DatabaseManager::flushWrites()
+{
+    if (m_flushTimer) m_flushTimer->stop();
+
+    bool committed = true;
+    if (m_batchOpen) {
+        committed = m_db.commit();
+        if (!committed) {
+            qDebug() << "提交写批次失败:" << m_db.lastError();
+            m_db.rollback();
+        }
+        m_batchOpen = false;
+    }
+
+    const QList<std::function<void(bool)>> writes = std::move(m_pendingWrites);
+    m_pendingWrites.clear();
+
+    for (const auto& complete : writes) complete(committed);
+}
+
+/**
+ * @brief 安排一次后台回收
+ * @param delayMs 延迟毫秒数
+ *
+ * 已有回收在等待时不重复安排，避免连续删除会话时反复推迟
+ */
+void DatabaseManager::scheduleGarbageCollection(int delayMs)
+{
+    if (m_gcTimer && !m_gcTimer->isActive()) m_gcTimer->start(delayMs);
+}
+
+/**
+ * @brief 执行一轮后台回收
+ *
+ * 每轮最多处理 kGcBatchSize 个文件，未处理完则隔 kGcIntervalMs 再继续，
+ * 其间排队的查询和写入照常执行，不会长时间占用数据库线程
+ */
+void DatabaseManager::collectGarbage()
+{
+    // 回收只看已提交的引用，先结束当前写批次
+    flushWrites();
+
+    bool more = collectOrphanRecords();
+    if (!more) more = sweepOrphanFiles();
+
+    if (more) scheduleGarbageCollection(kGcIntervalMs);
+}
+
+/**
+ * @brief 回收引用计数归零的图片
+ * @return bool 是否还有待回收的记录
+ */
+bool DatabaseManager::collectOrphanRecords()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 cutoff = now - kGcGracePeriodMs;
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT id, path FROM tb_images WHERE ref_count <= 0 AND created_at < :cutoff "
+                  "ORDER BY created_at LIMIT :limit");
+    query.bindValue(":cutoff", cutoff);
+    query.bindValue(":limit", kGcBatchSize);
+
+    if (!query.exec()) {
+        qDebug() << "查询待回收图片失败:" << query.lastError();
+        return false;
+    }
+
+    QVector<QPair<int, QString>> candidates;
+    while (query.next()) candidates.append({query.value(0).toInt(), query.value(1).toString()});
+    query.finish();
+
+    if (candidates.isEmpty()) return false;
+
+    m_db.transaction();
+
+    QSqlQuery remove(m_db);
+    remove.prepare("DELETE FROM tb_images WHERE id = :id");
+    QSqlQuery refresh(m_db);
+    refresh.prepare("UPDATE tb_images SET created_at = :now WHERE id = :id");
+
+    int removed = 0;
+    for (const auto& [imageId, path] : candidates) {
+        // 相同内容刚被再次保存（文件时间被刷新），记录很快会重新被引用，顺延而不是删除
+        QFileInfo info(path);
+        if (info.exists() && info.lastModified().toMSecsSinceEpoch() >= cutoff) {
+            refresh.bindValue(":now", now);
+            refresh.bindValue(":id", imageId);
+            refresh.exec();
+            continue;
+        }
+
+        if (info.exists() && !removeImageFile(path)) continue;
+
+        remove.bindValue(":id", imageId);
+        if (remove.exec()) ++removed;
+    }
+
+    m_db.commit();
+
+    if (removed > 0) qDebug() << "已回收未引用的图片:" << removed;
+    return candidates.size() == kGcBatchSize;
+}
+
+/**
+ * @brief 清理未登记的图片文件
+ * @return bool 是否还有待扫描的文件
+ *
+ * 处理引入引用计数之前删除会话遗留在 outputs 中的文件。每次启动只完整扫描一遍，
+ * 目录迭代器跨轮次保留，每轮只检查 kGcBatchSize 个文件。
+ * 只处理 ImageStore 按内容寻址写入的文件（aa/bb/<64 位十六进制哈希>.<扩展名>），并按哈希判断是否已登记，
+ * 用户自己放入的文件、旧版本按时间戳命名的图片以及路径写法不同（分隔符、大小写、符号链接）的记录都不受影响
  */
-void DatabaseManager::createTables()
+bool DatabaseManager::sweepOrphanFiles()
 {
-    QSqlQuery query;
+    static const QRegularExpression kStoredName(
+        QStringLiteral("^([0-9a-f]{2})/([0-9a-f]{2})/(\\1\\2[0-9a-f]{60})\\.[a-z0-9]+$"));
+
+    if (m_orphanScanDone) return false;
+
+    if (!m_orphanScan) {
+        m_orphanScan = std::make_unique<QDirIterator>(ImageStore::rootDir(), QDir::Files,
+                                                      QDirIterator::Subdirectories);
+    }
 
-    bool success = query.exec(
-        "CREATE TABLE IF NOT EXISTS tb_sessions ("
-        "id INTEGER PRIMARY KEY AUTOINCREMENT, "
-        "title TEXT NOT NULL, "
-        "created_at INTEGER"
-        ")"
-        );
-    if (!success) qDebug() << "tb_sessions 建表失败:" << query.lastError();
+    const qint64 cutoff = QDateTime::currentMSecsSinceEpoch() - kGcGracePeriodMs;
+
+    const QDir root(ImageStore::rootDir());
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT 1 FROM tb_images WHERE hash = :hash");
+
+    int removed = 0;
+    for (int checked = 0; checked < kGcBatchSize; ++checked) {
+        if (!m_orphanScan->hasNext()) {
+            m_orphanScan.reset();
+            m_orphanScanDone = true;
+            break;
+        }
+
+        QString path = m_orphanScan->next();
+        QFileInfo info = m_orphanScan->fileInfo();
+
+        const QRegularExpressionMatch match = kStoredName.match(root.relativeFilePath(path));
+        if (!match.hasMatch()) continue;
+
+        // 刚写入、尚未来得及登记的文件不动
+        if (info.lastModified().toMSecsSinceEpoch() >= cutoff) continue;
+
+        query.bindValue(":hash", match.captured(3));
+        if (!query.exec() || query.next()) continue;
+
+        if (removeImageFile(path)) ++removed;
+    }
 
-    success = query.exec(
-        "CREATE TABLE IF NOT EXISTS tb_messages ("
-        "id INTEGER PRIMARY KEY AUTOINCREMENT, "
-        "session_id INTEGER, "
-        "role TEXT, "
-        "content TEXT, "
-        "image_path TEXT, "
-        "timestamp INTEGER"
-        ")"
-        );
-    if (!success) qDebug() << "tb_messages 建表失败:" << query.lastError();
+    if (removed > 0) qDebug() << "已清理未登记的图片文件:" << removed;
+    return !m_orphanScanDone;
+}
+
+/**
+ * @brief 删除图片文件
+ * @param path 文件完整路径
+ * @return bool 文件是否已不存在
+ *
+ * 顺带删除变空的分片目录，目录非空时 rmdir 会直接失败，无需预先检查
+ */
+bool DatabaseManager::removeImageFile(const QString& path)
+{
+    if (!QFile::remove(path) && QFile::exists(path)) {
+        qDebug() << "删除图片文件失败:" << path;
+        return false;
+    }
+
+    ThumbnailCache::invalidate(path);
+
+    const QString root = QDir::cleanPath(ImageStore::rootDir());
+    QString dirPath = QFileInfo(path).absolutePath();
+    while (dirPath.startsWith(root + "/") && QDir().rmdir(dirPath)) {
+        dirPath = QFileInfo(dirPath).absolutePath();
+    }
+    return true;
 }
 
 /**
  * @brief 创建新会话
  * @param name 会话名称
- * @return int 新创建的会话ID，失败返回-1
+ * @return QFuture<int> 新创建的会话ID，失败返回-1
  */
-int DatabaseManager::createSession(const QString& name)
+QFuture<int> DatabaseManager::createSession(const QString& name)
 {
-    QSqlQuery query;
-    query.prepare("INSERT INTO tb_sessions (title, created_at) VALUES (:name, :time)");
+    return enqueue([this, name]() {
+        flushWrites();
 
-    query.bindValue(":name", name);
-    query.bindValue(":time", QDateTime::currentMSecsSinceEpoch());
+        QSqlQuery query(m_db);
+        query.prepare("INSERT INTO tb_sessions (title, created_at) VALUES (:name, :time)");
 
-    if (query.exec()) {
-        return query.lastInsertId().toInt();
-    }
+        query.bindValue(":name", name);
+        query.bindValue(":time", QDateTime::currentMSecsSinceEpoch());
+
+        if (query.exec()) {
+            return query.lastInsertId().toInt();
+        }
 
-    qDebug() << "创建会话失败:" << query.lastError();
-    return -1;
+        qDebug() << "创建会话失败:" << query.lastError();
+        return -1;
+    });
 }
 
 /**
  * @brief 获取所有会话
- * @return QVector<SessionData> 所有会话的数据列表
- * 
+ * @return QFuture<QVector<SessionData>> 所有会话的数据列表
+ *
  * 用于初始化左侧会话列表
  */
-QVector<SessionData> DatabaseManager::getAllSessions()
+QFuture<QVector<SessionData>> DatabaseManager::getAllSessions()
 {
-    QVector<SessionData> list;
-    QSqlQuery query("SELECT * FROM tb_sessions ORDER BY created_at DESC");
+    return enqueue([this]() {
+        QVector<SessionData> list;
+        QSqlQuery query("SELECT id, title, created_at FROM tb_sessions ORDER BY created_at DESC", m_db);
 
-    while (query.next()) {
-        SessionData session;
-        session.id = query.value("id").toInt();
-        session.name = query.value("title").toString();
-        session.createdAt = query.value("created_at").toLongLong();
-        list.append(session);
-    }
-    return list;
+        while (query.next()) {
+            SessionData session;
+            session.id = query.value("id").toInt();
+            session.name = query.value("title").toString();
+            session.createdAt = query.value("created_at").toLongLong();
+            list.append(session);
+        }
+        return list;
+    });
 }
 
 /**
  * @brief 重命名会话
  * @param id 会话ID
  * @param newName 新会话名称
- * @return bool 重命名是否成功
+ * @return QFuture<bool> 重命名是否成功
  */
-bool DatabaseManager::renameSession(int id, const QString& newName)
+QFuture<bool> DatabaseManager::renameSession(int id, const QString& newName)
 {
-    QSqlQuery query;
-    query.prepare("UPDATE tb_sessions SET title = :name WHERE id = :id");
-    query.bindValue(":name", newName);
-    query.bindValue(":id", id);
-    return query.exec();
+    return enqueue([this, id, newName]() {
+        flushWrites();
+
+        QSqlQuery query(m_db);
+        query.prepare("UPDATE tb_sessions SET title = :name WHERE id = :id");
+        query.bindValue(":name", newName);
+        query.bindValue(":id", id);
+        return query.exec();
+    });
 }
 
 /**
  * @brief 删除会话
  * @param id 会话ID
- * @return bool 删除是否成功
+ * @return QFuture<bool> 删除是否成功
+ *
+ * 生成记录、消息和会话在同一事务中删除，任一步失败整体回滚。
+ * 图片引用计数由触发器同步扣减，文件随后由后台回收删除
  */
-bool DatabaseManager::deleteSession(int id)
+QFuture<bool> DatabaseManager::deleteSession(int id)
 {
-    QSqlQuery queryMsg;
-    queryMsg.prepare("DELETE FROM tb_messages WHERE session_id = :sid");
-    queryMsg.bindValue(":sid", id);
-    queryMsg.exec();
+    return enqueue([this, id]() {
+        flushWrites();
 
-    QSqlQuery query;
-    query.prepare("DELETE FROM tb_sessions WHERE id = :id");
-    query.bindValue(":id", id);
-    return query.exec();
+        const QStringList statements = {
+            "DELETE FROM tb_generations WHERE message_id IN "
+            "(SELECT id FROM tb_messages WHERE session_id = :sid)",
+            "DELETE FROM tb_messages WHERE session_id = :sid",
+            "DELETE FROM tb_sessions WHERE id = :sid"
+        };
+
+        if (!m_db.transaction()) {
+            qDebug() << "删除会话失败，无法开启事务:" << m_db.lastError();
+            return false;
+        }
+
+        QSqlQuery query(m_db);
+        for (const QString& sql : statements) {
+            query.prepare(sql);
+            query.bindValue(":sid", id);
+            if (!query.exec()) {
+                qDebug() << "删除会话失败:" << query.lastError();
+                m_db.rollback();
+                return false;
+            }
+        }
+
+        if (!m_db.commit()) {
+            qDebug() << "删除会话提交失败:" << m_db.lastError();
+            m_db.rollback();
+            return false;
+        }
+
+        scheduleGarbageCollection(kGcIntervalMs);
+        return true;
+    });
 }
 
 /**
  * @brief 添加新消息
  * @param msg 消息数据
- * @return int 新消息的ID，失败返回-1
+ * @return QFuture<int> 新消息的ID，失败返回-1
+ */
+QFuture<int> DatabaseManager::addMessage(const MessageData& msg)
+{
+    // 时间戳在提交时确定，避免排队延迟影响消息顺序
+    const qint64 time = QDateTime::currentMSecsSinceEpoch();
+
+    return enqueueWrite([this, msg, time]() {
+        QSqlQuery query(m_db);
+        query.prepare("INSERT INTO tb_messages (session_id, role, content, image_path, timestamp) "
+                      "VALUES (:sid, :role, :content, :img, :time)");
+
+        query.bindValue(":sid", msg.sessionId);
+        query.bindValue(":role", static_cast<int>(msg.role));
+        query.bindValue(":content", msg.text);
+        query.bindValue(":img", msg.imagePath);
+        query.bindValue(":time", time);
+
+        if (query.exec()) {
+            const int id = query.lastInsertId().toInt();
+            updateBigramIndex(id, msg.text, false);
+            return id;
+        }
+
+        qDebug() << "插入消息失败:" << query.lastError();
+        return -1;
+    });
+}
+
+/**
+ * @brief 更新消息文本
+ * @param id 消息ID
+ * @param text 新的文本内容
+ * @return QFuture<bool> 更新是否成功
  */
-int DatabaseManager::addMessage(const MessageData& msg)
+QFuture<bool> DatabaseManager::updateMessageText(int id, const QString& text)
 {
-    QSqlQuery query;
-    query.prepare("INSERT INTO tb_messages (session_id, role, content, image_path, timestamp) "
-                  "VALUES (:sid, :role, :content, :img, :time)");
+    return enqueueWrite([this, id, text]() { return writeMessageText(id, text); });
+}
+
+/**
+ * @brief 更新尚未返回ID的消息文本
+ * @param pendingId addMessage 返回的 future
+ * @param text 新的文本内容
+ * @return QFuture<bool> 更新是否成功
+ */
+QFuture<bool> DatabaseManager::updateMessageText(const QFuture<int>& pendingId, const QString& text)
+{
+    return enqueueWrite([this, pendingId, text]() {
+        // 插入任务先于本任务入队，此时结果已就绪
+        int id = pendingId.isResultReadyAt(0) ? pendingId.result() : -1;
+        if (id == -1) return false;
+
+        return writeMessageText(id, text);
+    });
+}
+
+/**
+ * @brief 写入消息文本并同步双字索引
+ * @param id 消息ID
+ * @param text 新的文本内容
+ * @return bool 更新是否成功
+ */
+bool DatabaseManager::writeMessageText(int id, const QString& text)
+{
+    // 双字索引是无内容表，删除旧索引词需要原内容
+    QSqlQuery query(m_db);
+    if (isSearchIndexed(id)) {
+        query.prepare("SELECT content FROM tb_messages WHERE id = :id");
+        query.bindValue(":id", id);
+        if (query.exec() && query.next()) updateBigramIndex(id, query.value(0).toString(), true);
+    }
 
-    query.bindValue(":sid", msg.sessionId);
-    query.bindValue(":role", msg.role == MessageRole::User ? "user" : "ai");
-    query.bindValue(":content", msg.text);
-    query.bindValue(":img", msg.imagePath);
-    query.bindValue(":time", QDateTime::currentMSecsSinceEpoch());
+    query.prepare("UPDATE tb_messages SET content = :content WHERE id = :id");
+    query.bindValue(":content", text);
+    query.bindValue(":id", id);
 
     if (query.exec()) {
-        return query.lastInsertId().toInt();
+        if (query.numRowsAffected() > 0) updateBigramIndex(id, text, false);
+        return true;
     }
 
-    qDebug() << "插入消息失败:" << query.lastError();
-    return -1;
+    qDebug() << "更新消息失败:" << query.lastError();
+    return false;
+}
+
+/// 片段高亮的起止标记，转义后替换为富文本标签
+static const QChar kHighlightOpen(0x02);
+static const QChar kHighlightClose(0x03);
+
+/**
+ * @brief 把带高亮标记的纯文本片段转成富文本
+ * @param raw 带标记的片段
+ * @return QString 已转义的富文本
+ */
+static QString highlightSnippet(const QString& raw)
+{
+    QString html = raw.toHtmlEscaped();
+    html.replace(kHighlightOpen, "<span style='color:#19C37D; font-weight:bold;'>");
+    html.replace(kHighlightClose, "</span>");
+    html.replace('\n', ' ');
+    return html;
+}
+
+/**
+ * @brief 在内容中截取命中位置附近的片段
+ * @param content 消息内容
+ * @param text 搜索文本
+ * @return QString 带高亮标记的片段
+ */
+static QString likeSnippet(const QString& content, const QString& text)
+{
+    const int context = 16;
+    int pos = content.indexOf(text, 0, Qt::CaseInsensitive);
+    if (pos < 0) return content.left(context * 2);
+
+    int start = qMax(0, pos - context);
+    int end = qMin(content.size(), pos + text.size() + context);
+
+    return (start > 0 ? QString("…") : QString())
+           + content.mid(start, pos - start)
+           + kHighlightOpen + content.mid(pos, text.size()) + kHighlightClose
+           + content.mid(pos + text.size(), end - pos - text.size())
+           + (end < content.size() ? QString("…") : QString());
 }
 
 /**
- * @brief 获取指定会话的所有消息
+ * @brief 全文搜索消息内容（提示词与反推文本）
+ * @param text 搜索文本
+ * @param offset 跳过的结果数（分页）
+ * @param limit 每页条数
+ * @param window 首页返回的结果范围，首页传入默认值
+ * @return QFuture<SearchPage> 按相关度排序的命中结果及结果范围
+ */
+QFuture<SearchPage> DatabaseManager::search(const QString& text, int offset, int limit, const SearchWindow& window)
+{
+    return enqueue([this, text, offset, limit, window]() {
+        SearchPage page;
+        page.window = window;
+        const QString needle = text.trimmed();
+        if (needle.isEmpty()) return page;
+
+        // 首页确定结果范围和检索方式，翻页时沿用，之后新增的消息或补建完成都不会打乱已加载的各页
+        const bool firstPage = !window.isValid();
+        if (firstPage) {
+            QSqlQuery maxId("SELECT IFNULL(MAX(id), 0) FROM tb_messages", m_db);
+            page.window.ceiling = maxId.next() ? maxId.value(0).toLongLong() : 0;
+            page.window.indexed = m_ftsAvailable && m_backfillDone >= m_backfillEnd;
+        }
+        const qint64 ceiling = page.window.ceiling;
+
+        // 整体作为短语匹配，避免用户输入被解析为 FTS 语法
+        const QString phrase = "\"" + QString(needle).replace("\"", "\"\"") + "\"";
+        QString pattern = needle;
+        pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+        pattern = "%" + pattern + "%";
+
+        // 逐行读取结果，ftsSnippet 为 true 时第 6 列已是带标记的片段，否则是消息原文
+        auto collect = [&page, &needle](QSqlQuery& query, bool ftsSnippet) {
+            if (!query.exec()) {
+                qDebug() << "搜索失败:" << query.lastError();
+                return;
+            }
+            while (query.next()) {
+                SearchHit hit;
+                hit.messageId = query.value(0).toInt();
+                hit.sessionId = query.value(1).toInt();
+                hit.sessionTitle = query.value(2).toString();
+                hit.role = static_cast<MessageRole>(query.value(3).toInt());
+                hit.timestamp = query.value(4).toLongLong();
+
+                QString raw = query.value(5).toString();
+                hit.snippet = highlightSnippet(ftsSnippet ? raw : likeSnippet(raw, needle));
+
+                page.hits.append(hit);
+            }
+        };
+
+        const bool bigram = needle.size() == 2 && needle[0].isLetterOrNumber() && needle[1].isLetterOrNumber();
+        QSqlQuery query(m_db);
+
+        if (page.window.indexed && needle.size() >= 3) {
+            // 高频词可能命中数十万行，bm25 全量打分要数百毫秒。
+            // 首页先沿 rowid 倒序找到最近第 N 条命中的位置（只走倒排表，不打分），只在这个窗口内排序，
+            // 更早的命中按新旧接在窗口之后。窗口随结果范围传回，各页始终在同一窗口内排序
+            if (firstPage) {
+                query.prepare("SELECT rowid FROM tb_messages_fts WHERE tb_messages_fts MATCH :query "
+                              "AND rowid <= :ceiling ORDER BY rowid DESC LIMIT 1 OFFSET :skip");
+                query.bindValue(":query", phrase);
+                query.bindValue(":ceiling", ceiling);
+                query.bindValue(":skip", kSearchRankWindow - 1);
+                page.window.rankFloor = (query.exec() && query.next()) ? query.value(0).toLongLong() : 0;
+            }
+            const qint64 floor = page.window.rankFloor;
+
+            // 找到边界时窗口内恰好有 kSearchRankWindow 条命中
+            const int ranked = floor > 0 ? kSearchRankWindow : std::numeric_limits<int>::max();
+            if (offset < ranked) {
+                query.prepare("SELECT m.id, m.session_id, s.title, m.role, m.timestamp, "
+                              "snippet(tb_messages_fts, 0, :open, :close, '…', 24) "
+                              "FROM tb_messages_fts "
+                              "JOIN tb_messages m ON m.id = tb_messages_fts.rowid "
+                              "LEFT JOIN tb_sessions s ON s.id = m.session_id "
+                              "WHERE tb_messages_fts MATCH :query "
+                              "AND tb_messages_fts.rowid BETWEEN :floor AND :ceiling "
+                              "ORDER BY rank LIMIT :limit OFFSET :offset");
+                query.bindValue(":open", QString(kHighlightOpen));
+                query.bindValue(":close", QString(kHighlightClose));
+                query.bindValue(":query", phrase);
+                query.bindValue(":floor", floor);
+                query.bindValue(":ceiling", ceiling);
+                query.bindValue(":limit", qMin(limit, ranked - offset));
+                query.bindValue(":offset", offset);
+                collect(query, true);
+            }
+
+            if (floor > 0 && page.hits.size() < limit) {
+                query.prepare("SELECT m.id, m.session_id, s.title, m.role, m.timestamp, "
+                              "snippet(tb_messages_fts, 0, :open, :close, '…', 24) "
+                              "FROM tb_messages_fts "
+                              "JOIN tb_messages m ON m.id = tb_messages_fts.rowid "
+                              "LEFT JOIN tb_sessions s ON s.id = m.session_id "
+                              "WHERE tb_messages_fts MATCH :query AND tb_messages_fts.rowid < :floor "
+                              "ORDER BY tb_messages_fts.rowid DESC LIMIT :limit OFFSET :offset");
+                query.bindValue(":open", QString(kHighlightOpen));
+                query.bindValue(":close", QString(kHighlightClose));
+                query.bindValue(":query", phrase);
+                query.bindValue(":floor", floor);
+                query.bindValue(":limit", limit - page.hits.size());
+                query.bindValue(":offset", qMax(0, offset - ranked));
+                collect(query, true);
+            }
+        } else if (page.window.indexed && bigram) {
+            // 双字索引只用于筛选候选，已删除消息的残留索引词经连接过滤，内容再用 LIKE 确认一次
+            query.prepare("SELECT m.id, m.session_id, s.title, m.role, m.timestamp, m.content "
+                          "FROM tb_messages_bigram "
+                          "JOIN tb_messages m ON m.id = tb_messages_bigram.rowid "
+                          "LEFT JOIN tb_sessions s ON s.id = m.session_id "
+                          "WHERE tb_messages_bigram MATCH :query AND tb_messages_bigram.rowid <= :ceiling "
+                          "AND m.content LIKE :pattern ESCAPE '\\' "
+                          "ORDER BY tb_messages_bigram.rowid DESC LIMIT :limit OFFSET :offset");
+            query.bindValue(":query", "\"" + needle.toCaseFolded() + "\"");
+            query.bindValue(":ceiling", ceiling);
+            query.bindValue(":pattern", pattern);
+            query.bindValue(":limit", limit);
+            query.bindValue(":offset", offset);
+            collect(query, false);
+        } else {
+            // 沿主键倒序扫描，凑满一页即停止；单个字命中很多，只扫描最近的 kLikeScanLimit 条，
+            // 避免罕见字扫完整张表
+            const qint64 floor = needle.size() == 1 ? ceiling - kLikeScanLimit : 0;
+
+            query.prepare("SELECT m.id, m.session_id, s.title, m.role, m.timestamp, m.content "
+                          "FROM tb_messages m "
+                          "LEFT JOIN tb_sessions s ON s.id = m.session_id "
+                          "WHERE m.id > :floor AND m.id <= :ceiling AND m.content LIKE :pattern ESCAPE '\\' "
+                          "ORDER BY m.id DESC LIMIT :limit OFFSET :offset");
+            query.bindValue(":floor", floor);
+            query.bindValue(":ceiling", ceiling);
+            query.bindValue(":pattern", pattern);
+            query.bindValue(":limit", limit);
+            query.bindValue(":offset", offset);
+            collect(query, false);
+        }
+
+        return page;
+    });
+}
+
+/**
+ * @brief 登记图片文件
+ * @param hash 内容哈希
+ * @param path 文件完整路径
+ * @param size 文件字节数
+ * @return QFuture<bool> 是否登记成功（相同内容已登记时同样返回 true）
+ *
+ * 必须先于引用该图片的 addMessage 调用，消息插入触发器才能累加引用计数
+ */
+QFuture<bool> DatabaseManager::registerImage(const QString& hash, const QString& path, qint64 size)
+{
+    return enqueueWrite([this, hash, path, size]() {
+        QSqlQuery query(m_db);
+        query.prepare("INSERT OR IGNORE INTO tb_images (hash, path, size, ref_count, created_at) "
+                      "VALUES (:hash, :path, :size, 0, :time)");
+        query.bindValue(":hash", hash);
+        query.bindValue(":path", path);
+        query.bindValue(":size", size);
+        query.bindValue(":time", QDateTime::currentMSecsSinceEpoch());
+
+        if (!query.exec()) {
+            qDebug() << "登记图片失败:" << query.lastError();
+            return false;
+        }
+        return true;
+    });
+}
+
+/**
+ * @brief 阶段耗时
+ * @param from 阶段开始时间
+ * @param to 阶段结束时间
+ * @return QVariant 耗时毫秒数，任一端未观测到时为 NULL
+ */
+static QVariant stageDuration(qint64 from, qint64 to)
+{
+    if (from <= 0 || to <= 0 || to < from) return QVariant(QMetaType::fromType<qint64>());
+    return to - from;
+}
+
+/**
+ * @brief 添加生成任务元数据
+ * @param pendingMessageId 结果消息的 addMessage future，无效 future 表示结果未落库
+ * @param record 生成任务元数据
+ * @return QFuture<int> 新记录的ID，失败返回-1
+ */
+QFuture<int> DatabaseManager::addGeneration(const QFuture<int>& pendingMessageId, const GenerationRecord& record)
+{
+    return enqueueWrite([this, pendingMessageId, record]() {
+        // 消息插入先于本任务入队，此时结果已就绪
+        int messageId = (pendingMessageId.isValid() && pendingMessageId.isResultReadyAt(0))
+                            ? pendingMessageId.result() : -1;
+
+        QSqlQuery query(m_db);
+        query.prepare("INSERT INTO tb_generations (message_id, prompt_id, workflow_type, template_hash, params, "
+                      "seed, width, height, backend_url, submitted_at, started_at, executed_at, finished_at, "
+                      "upload_ms, queue_ms, execute_ms, download_ms, total_ms) "
+                      "VALUES (:mid, :pid, :type, :hash, :params, :seed, :w, :h, :url, "
+                      ":submitted, :started, :executed, :finished, :upload, :queue, :execute, :download, :total)");
+
+        query.bindValue(":mid", messageId != -1 ? QVariant(messageId) : QVariant(QMetaType::fromType<int>()));
+        query.bindValue(":pid", record.promptId);
+        query.bindValue(":type", record.workflowType);
+        query.bindValue(":hash", record.templateHash);
+        query.bindValue(":params", record.paramsJson);
+        query.bindValue(":seed", record.seed != -1 ? QVariant(record.seed) : QVariant(QMetaType::fromType<qint64>()));
+        query.bindValue(":w", record.width);
+        query.bindValue(":h", record.height);
+        query.bindValue(":url", record.backendUrl);
+        query.bindValue(":submitted", record.submittedAt);
+        query.bindValue(":started", record.startedAt);
+        query.bindValue(":executed", record.executedAt);
+        query.bindValue(":finished", record.finishedAt);
+        query.bindValue(":upload", record.uploadMs);
+
+        // 未收到 execution_start（如命中服务器缓存）时，排队与执行合并计入 execute_ms
+        qint64 execStart = record.startedAt > 0 ? record.startedAt : record.submittedAt;
+        qint64 execEnd = record.executedAt > 0 ? record.executedAt : record.finishedAt;
+        query.bindValue(":queue", stageDuration(record.submittedAt, record.startedAt));
+        query.bindValue(":execute", stageDuration(execStart, execEnd));
+        query.bindValue(":download", stageDuration(record.executedAt, record.finishedAt));
+        query.bindValue(":total", stageDuration(record.submittedAt, record.finishedAt));
+
+        if (query.exec()) {
+            return query.lastInsertId().toInt();
+        }
+
+        qDebug() << "插入生成记录失败:" << query.lastError();
+        return -1;
+    });
+}
+
+/**
+ * @brief 分页获取会话消息
+ * @param sessionId 会话ID
+ * @param before 分页游标，无效游标表示从最新一页开始
+ * @param limit 每页条数
+ * @return QFuture<MessagePage> 早于游标的最新一页消息
+ *
+ * 沿 (session_id, timestamp, id) 索引倒序读取 limit + 1 行，多出的一行仅用于判断是否还有更早的消息
+ */
+QFuture<MessagePage> DatabaseManager::getMessagePage(int sessionId, const MessageCursor& before, int limit)
+{
+    return enqueue([this, sessionId, before, limit]() { return readMessagePage(sessionId, before, limit); });
+}
+
+/**
+ * @brief 获取从指定消息到最新的会话消息
+ * @param sessionId 会话ID
+ * @param messageId 定位的消息ID
+ * @param context 额外带上的更早消息条数
+ * @return QFuture<MessagePage> 指定消息及之后的全部消息，外加更早的 context 条
+ */
+QFuture<MessagePage> DatabaseManager::getMessagePageFrom(int sessionId, int messageId, int context)
+{
+    return enqueue([this, sessionId, messageId, context]() {
+        // 沿会话时间线索引统计目标消息及之后的条数，再按普通分页一次读出
+        QSqlQuery query(m_db);
+        query.prepare("SELECT COUNT(*) FROM tb_messages WHERE session_id = :sid "
+                      "AND (timestamp, id) >= (SELECT timestamp, id FROM tb_messages WHERE id = :mid)");
+        query.bindValue(":sid", sessionId);
+        query.bindValue(":mid", messageId);
+
+        int newer = 0;
+        if (query.exec() && query.next()) {
+            newer = query.value(0).toInt();
+        } else {
+            qDebug() << "定位消息失败:" << query.lastError();
+        }
+
+        return readMessagePage(sessionId, MessageCursor(), newer + context);
+    });
+}
+
+/**
+ * @brief 读取一页会话消息
  * @param sessionId 会话ID
- * @return QVector<MessageData> 消息数据列表
+ * @param before 分页游标，无效游标表示从最新一页开始
+ * @param limit 每页条数
+ * @return MessagePage 早于游标的最新一页消息
  */
-QVector<MessageData> DatabaseManager::getMessages(int sessionId)
+MessagePage DatabaseManager::readMessagePage(int sessionId, const MessageCursor& before, int limit)
 {
-    QVector<MessageData> list;
-    QSqlQuery query;
-    query.prepare("SELECT * FROM tb_messages WHERE session_id = :sid ORDER BY timestamp ASC");
+    MessagePage page;
+    QSqlQuery query(m_db);
+
+    if (before.isValid()) {
+        query.prepare("SELECT id, role, content, image_path, timestamp FROM tb_messages "
+                      "WHERE session_id = :sid AND (timestamp, id) < (:ts, :id) "
+                      "ORDER BY timestamp DESC, id DESC LIMIT :limit");
+        query.bindValue(":ts", before.timestamp);
+        query.bindValue(":id", before.id);
+    } else {
+        query.prepare("SELECT id, role, content, image_path, timestamp FROM tb_messages "
+                      "WHERE session_id = :sid "
+                      "ORDER BY timestamp DESC, id DESC LIMIT :limit");
+    }
     query.bindValue(":sid", sessionId);
+    query.bindValue(":limit", limit + 1);
 
     if (!query.exec()) {
         qDebug() << "查询消息失败:" << query.lastError();
-        return list;
+        return page;
     }
 
     while (query.next()) {
-        int id = query.value("id").toInt();
-        int sid = query.value("session_id").toInt();
-        QString roleStr = query.value("role").toString();
-        QString content = query.value("content").toString();
-        QString imgPath = query.value("image_path").toString();
-        qint64 time = query.value("timestamp").toLongLong();
+        if (page.messages.size() == limit) {
+            page.hasMore = true;
+            break;
+        }
+
+        MessageRole role = static_cast<MessageRole>(query.value(1).toInt());
 
-        MessageRole role = (roleStr == "user") ? MessageRole::User : MessageRole::AI;
+        MessageData msg(sessionId, role, query.value(2).toString(), query.value(3).toString());
+        msg.id = query.value(0).toInt();
+        msg.timestamp = query.value(4).toLongLong();
 
-        MessageData msg(sid, role, content, imgPath);
-        msg.id = id;
-        msg.timestamp = time;
+        page.messages.append(msg);
+    }
 
-        list.append(msg);
+    if (!page.messages.isEmpty()) {
+        page.next.timestamp = page.messages.last().timestamp;
+        page.next.id = page.messages.last().id;
     }
-    return list;
+
+    // 查询为倒序，界面按时间正序显示
+    std::reverse(page.messages.begin(), page.messages.end());
+    return page;
 }
 
 /**
- * @brief 获取所有生成的图片路径
- * @return QVector<QString> 图片路径列表（按时间倒序）
+ * @brief 分页获取生成的图片
+ * @param before 分页游标，无效游标表示从最新一页开始
+ * @param limit 每页条数
+ * @return QFuture<GalleryPage> 早于游标的最新一页图片（按时间倒序）
+ *
+ * 只读取画廊需要的列：消息沿图库部分覆盖索引有序读取，尺寸由 idx_generations_message 覆盖，都无需回表
  */
-QVector<QString> DatabaseManager::getAllAiImages()
+QFuture<GalleryPage> DatabaseManager::getAiImagePage(const MessageCursor& before, int limit)
 {
-    QVector<QString> list;
-    QSqlQuery query;
-    query.prepare("SELECT image_path FROM tb_messages WHERE role = 'ai' AND image_path != '' ORDER BY timestamp DESC");
+    return enqueue([this, before, limit]() {
+        GalleryPage page;
+        QSqlQuery query(m_db);
+
+        // 尺寸取自生成记录，画廊在缩略图加载前就能按真实比例排版
+        const QString columns =
+            "id, session_id, image_path, timestamp, "
+            "(SELECT width FROM tb_generations g WHERE g.message_id = m.id ORDER BY g.id DESC LIMIT 1), "
+            "(SELECT height FROM tb_generations g WHERE g.message_id = m.id ORDER BY g.id DESC LIMIT 1)";
+
+        if (before.isValid()) {
+            query.prepare(QString("SELECT %1 FROM tb_messages m "
+                                  "WHERE role = 1 AND image_path != '' AND (timestamp, id) < (:ts, :id) "
+                                  "ORDER BY timestamp DESC, id DESC LIMIT :limit").arg(columns));
+            query.bindValue(":ts", before.timestamp);
+            query.bindValue(":id", before.id);
+        } else {
+            query.prepare(QString("SELECT %1 FROM tb_messages m "
+                                  "WHERE role = 1 AND image_path != '' "
+                                  "ORDER BY timestamp DESC, id DESC LIMIT :limit").arg(columns));
+        }
+        query.bindValue(":limit", limit + 1);
+
+        if (!query.exec()) {
+            qDebug() << "查询历史图片失败:" << query.lastError();
+            return page;
+        }
 
-    if (query.exec()) {
         while (query.next()) {
-            list.append(query.value("image_path").toString());
+            if (page.images.size() == limit) {
+                page.hasMore = true;
+                break;
+            }
+
+            GalleryImage image;
+            image.messageId = query.value(0).toInt();
+            image.sessionId = query.value(1).toInt();
+            image.path = query.value(2).toString();
+            image.timestamp = query.value(3).toLongLong();
+            image.size = QSize(query.value(4).toInt(), query.value(5).toInt());
+            page.images.append(image);
         }
-    } else {
-        qDebug() << "查询历史图片失败:" << query.lastError();
-    }
-    return list;
+
+        if (!page.images.isEmpty()) {
+            page.next.timestamp = page.images.last().timestamp;
+            page.next.id = page.images.last().messageId;
+        }
+        return page;
+    });
 }
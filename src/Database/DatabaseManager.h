@@ -4,6 +4,7 @@
  * 
  * 该文件定义了DatabaseManager类，负责应用程序的数据库操作。
  * 使用单例模式管理数据库连接，提供会话和消息的增删改查接口。
+ * SQLite 连接运行在独立的工作线程上，所有接口均返回 QFuture，GUI 线程不执行任何 SQL。
  * 
  * @author CloudArt Team
  * @version 1.0
@@ -15,6 +16,16 @@
 #include <QObject>
 #include <QSqlDatabase>
 #include <QVector>
+#include <QFuture>
+#include <QPromise>
+#include <QThread>
+#include <QTimer>
+#include <QDirIterator>
+#include <QDebug>
+#include <QList>
+#include <functional>
+#include <memory>
+#include <type_traits>
 #include "../Model/DataModels.h"
 
 /**
@@ -22,6 +33,12 @@
  * 
  * 采用单例模式管理数据库连接，提供会话和消息的持久化存储功能。
  * 支持会话的创建、查询、重命名、删除以及消息的添加和查询操作。
+ *
+ * 所有操作按提交顺序排队到数据库线程执行，结果通过 QFuture 返回。
+ * 调用方使用 future.then(this, ...) 在 GUI 线程接收结果；写操作可直接忽略返回值。
+ *
+ * 消息的插入与更新采用延迟写入：同一刷新周期内的写操作合并为一个事务提交，
+ * 提交成功后对应的 future 才完成。同一连接上的读操作可以看到尚未提交的写入。
  */
 class DatabaseManager : public QObject
 {
@@ -36,65 +53,145 @@ public:
 
     /**
      * @brief 初始化数据库
-     * @return bool 初始化是否成功
+     * @return QFuture<bool> 初始化是否成功
      * 
-     * 打开数据库连接并创建必要的数据表
+     * 启动数据库线程，并在该线程上打开连接、创建必要的数据表。
+     * 不等待打开结果：之后排队的操作都在初始化之后执行，界面可以与建表、迁移并行构建。
+     * 重复调用直接返回首次的结果。
      */
-    bool init();
+    QFuture<bool> init();
+
+    /**
+     * @brief 关闭数据库
+     *
+     * 等待已排队的操作执行完毕后关闭连接并退出数据库线程，应在事件循环结束后调用
+     */
+    void shutdown();
 
     /**
      * @brief 创建新会话
      * @param name 会话名称
-     * @return int 新创建的会话ID，失败返回-1
+     * @return QFuture<int> 新创建的会话ID，失败返回-1
      */
-    int createSession(const QString& name);
+    QFuture<int> createSession(const QString& name);
 
     /**
      * @brief 获取所有会话
-     * @return QVector<SessionData> 所有会话的数据列表
+     * @return QFuture<QVector<SessionData>> 所有会话的数据列表
      * 
      * 用于初始化左侧会话列表
      */
-    QVector<SessionData> getAllSessions();
+    QFuture<QVector<SessionData>> getAllSessions();
 
     /**
      * @brief 重命名会话
      * @param id 会话ID
      * @param newName 新会话名称
-     * @return bool 重命名是否成功
+     * @return QFuture<bool> 重命名是否成功
      */
-    bool renameSession(int id, const QString& newName);
+    QFuture<bool> renameSession(int id, const QString& newName);
 
     /**
      * @brief 删除会话
      * @param id 会话ID
-     * @return bool 删除是否成功
+     * @return QFuture<bool> 删除是否成功
      * 
      * 删除会话时会连带删除该会话下的所有消息
      */
-    bool deleteSession(int id);
+    QFuture<bool> deleteSession(int id);
 
     /**
      * @brief 添加新消息
      * @param msg 消息数据
-     * @return int 新消息的ID，失败返回-1
+     * @return QFuture<int> 新消息的ID，失败返回-1
+     */
+    QFuture<int> addMessage(const MessageData& msg);
+
+    /**
+     * @brief 更新消息文本
+     * @param id 消息ID
+     * @param text 新的文本内容
+     * @return QFuture<bool> 更新是否成功
+     *
+     * 用于流式输出过程中增量落库
+     */
+    QFuture<bool> updateMessageText(int id, const QString& text);
+
+    /**
+     * @brief 更新尚未返回ID的消息文本
+     * @param pendingId addMessage 返回的 future
+     * @param text 新的文本内容
+     * @return QFuture<bool> 更新是否成功
+     *
+     * 任务按提交顺序执行，轮到本任务时插入必然已完成，因此无需在 GUI 线程等待ID
+     */
+    QFuture<bool> updateMessageText(const QFuture<int>& pendingId, const QString& text);
+
+    /**
+     * @brief 全文搜索消息内容（提示词与反推文本）
+     * @param text 搜索文本
+     * @param offset 跳过的结果数（分页）
+     * @param limit 每页条数
+     * @param window 首页返回的结果范围，首页传入默认值
+     * @return QFuture<SearchPage> 按相关度排序的命中结果及结果范围
+     *
+     * 三个字符及以上使用 FTS5 trigram 索引，最近的 kSearchRankWindow 条命中按 bm25 排序，更早的按新旧排在其后；
+     * 两个字（中文关键词的常见长度）使用双字索引，按新旧排序。
+     * 单个字只扫描最近的 kLikeScanLimit 条消息；索引补建完成前或 FTS5 不可用时回退为 LIKE 全表扫描
      */
-    int addMessage(const MessageData& msg);
+    QFuture<SearchPage> search(const QString& text, int offset = 0, int limit = 30,
+                               const SearchWindow& window = SearchWindow());
 
     /**
-     * @brief 获取指定会话的所有消息
+     * @brief 登记图片文件
+     * @param hash 内容哈希
+     * @param path 文件完整路径
+     * @param size 文件字节数
+     * @return QFuture<bool> 是否登记成功（相同内容已登记时同样返回 true）
+     *
+     * 引用计数由消息表触发器维护，需在引用该图片的 addMessage 之前调用
+     */
+    QFuture<bool> registerImage(const QString& hash, const QString& path, qint64 size);
+
+    /**
+     * @brief 添加生成任务元数据
+     * @param pendingMessageId 结果消息的 addMessage future，无效 future 表示结果未落库
+     * @param record 生成任务元数据
+     * @return QFuture<int> 新记录的ID，失败返回-1
+     *
+     * 与消息写入同批提交，消息ID在数据库线程上直接从 future 读取
+     */
+    QFuture<int> addGeneration(const QFuture<int>& pendingMessageId, const GenerationRecord& record);
+
+    /**
+     * @brief 分页获取会话消息
      * @param sessionId 会话ID
-     * @return QVector<MessageData> 消息数据列表
-     * 
-     * 用于点击会话后加载历史消息
+     * @param before 分页游标，无效游标表示从最新一页开始
+     * @param limit 每页条数
+     * @return QFuture<MessagePage> 早于游标的最新一页消息
+     *
+     * 用于点击会话后先加载最新一页，向上滚动时再加载更早的消息
+     */
+    QFuture<MessagePage> getMessagePage(int sessionId, const MessageCursor& before = MessageCursor(), int limit = 50);
+
+    /**
+     * @brief 获取从指定消息到最新的会话消息
+     * @param sessionId 会话ID
+     * @param messageId 定位的消息ID
+     * @param context 额外带上的更早消息条数
+     * @return QFuture<MessagePage> 指定消息及之后的全部消息，外加更早的 context 条
+     *
+     * 用于打开搜索结果：界面从最新消息连续显示到目标消息，更早的消息仍按返回的游标向上翻页
      */
-    QVector<MessageData> getMessages(int sessionId);
+    QFuture<MessagePage> getMessagePageFrom(int sessionId, int messageId, int context = 20);
 
     /**
-     * @brief 获取所有生成的图片路径
-     * @return QVector<QString> 图片路径列表（按时间倒序）
+     * @brief 分页获取生成的图片
+     * @param before 分页游标，无效游标表示从最新一页开始
+     * @param limit 每页条数
+     * @return QFuture<GalleryPage> 早于游标的最新一页图片（按时间倒序）
      */
-    QVector<QString> getAllAiImages();
+    QFuture<GalleryPage> getAiImagePage(const MessageCursor& before = MessageCursor(), int limit = 60);
 
 private:
     /**
@@ -119,12 +216,244 @@ private:
     DatabaseManager& operator=(const DatabaseManager&) = delete;
 
     /**
-     * @brief 创建数据表
-     * 
-     * 创建会话表和消息表（如果不存在）
+     * @brief 配置连接参数
+     *
+     * 启用 WAL、内存映射等连接级 PRAGMA，仅在数据库线程调用
+     */
+    void configureConnection();
+
+    /**
+     * @brief 执行数据库迁移
+     * @return bool 迁移是否成功
+     *
+     * 根据 PRAGMA user_version 将旧库原地升级到最新表结构，仅在数据库线程调用
+     */
+    bool migrate();
+
+    /**
+     * @brief 读取全文索引状态
+     *
+     * 检查 v5 迁移是否建立了索引表，有未完成的补建时安排后台补建，仅在数据库线程调用
+     */
+    void loadSearchIndexState();
+
+    /**
+     * @brief 补建一批消息的全文索引
+     *
+     * 每轮为 kBackfillBatchSize 条已有消息建立 trigram 和双字索引并记录进度，
+     * 未完成则隔 kBackfillIntervalMs 再继续，其间排队的查询照常执行，仅在数据库线程调用
+     */
+    void backfillSearchIndex();
+
+    /**
+     * @brief 消息是否已进入全文索引
+     * @param id 消息ID
+     * @return bool 补建已覆盖该消息或该消息在迁移后写入
+     */
+    bool isSearchIndexed(qint64 id) const;
+
+    /**
+     * @brief 写入或删除消息的双字索引
+     * @param id 消息ID
+     * @param content 消息内容，删除时必须与写入时相同
+     * @param remove true 删除，false 写入
+     *
+     * 双字索引无法由触发器生成，在写入消息的任务中同步维护，仅在数据库线程调用
+     */
+    void updateBigramIndex(qint64 id, const QString& content, bool remove);
+
+    /**
+     * @brief 写入消息文本并同步双字索引
+     * @param id 消息ID
+     * @param text 新的文本内容
+     * @return bool 更新是否成功
+     *
+     * 仅在数据库线程调用
+     */
+    bool writeMessageText(int id, const QString& text);
+
+    /**
+     * @brief 读取一页会话消息
+     * @param sessionId 会话ID
+     * @param before 分页游标，无效游标表示从最新一页开始
+     * @param limit 每页条数
+     * @return MessagePage 早于游标的最新一页消息
+     *
+     * 仅在数据库线程调用
+     */
+    MessagePage readMessagePage(int sessionId, const MessageCursor& before, int limit);
+
+    /**
+     * @brief 开始写批次
+     * @return bool 批次是否已打开，开启事务失败时为 false
+     *
+     * 若当前没有打开的批次则开启事务并启动刷新定时器，仅在数据库线程调用
+     */
+    bool beginWriteBatch();
+
+    /**
+     * @brief 提交当前写批次
+     *
+     * 提交事务并完成批次内所有写操作的 future，提交失败则回滚并取消这些 future，仅在数据库线程调用
+     */
+    void flushWrites();
+
+    /**
+     * @brief 安排一次后台回收
+     * @param delayMs 延迟毫秒数
+     *
+     * 仅在数据库线程调用
+     */
+    void scheduleGarbageCollection(int delayMs);
+
+    /**
+     * @brief 执行一轮后台回收
+     *
+     * 先回收引用计数归零的图片记录及文件，再增量清理 outputs 中未登记的文件，仅在数据库线程调用
+     */
+    void collectGarbage();
+
+    /**
+     * @brief 回收引用计数归零的图片
+     * @return bool 是否还有待回收的记录
+     */
+    bool collectOrphanRecords();
+
+    /**
+     * @brief 清理未登记的图片文件
+     * @return bool 是否还有待扫描的文件
+     */
+    bool sweepOrphanFiles();
+
+    /**
+     * @brief 删除图片文件及变空的分片目录
+     * @param path 文件完整路径
+     * @return bool 文件是否已不存在
+     */
+    bool removeImageFile(const QString& path);
+
+    /**
+     * @brief 创建已取消的 future
+     * @return QFuture 已取消的 future，then() 续体不会被执行
+     */
+    template <typename Result>
+    static QFuture<Result> cancelledFuture();
+
+    /**
+     * @brief 将任务排队到数据库线程执行
+     * @param job 在数据库线程上执行的任务，返回值作为 future 的结果
+     * @return QFuture 任务结果
+     */
+    template <typename Job>
+    QFuture<std::invoke_result_t<Job>> enqueue(Job job);
+
+    /**
+     * @brief 将写任务排队到数据库线程，并入当前写批次
+     * @param job 在数据库线程上执行的写任务
+     * @return QFuture 任务结果，批次提交后完成
+     *
+     * 结果在任务执行后立即写入 future，队列中后续任务可直接读取；调用方的续体要等批次提交后才执行
      */
-    void createTables();
+    template <typename Job>
+    QFuture<std::invoke_result_t<Job>> enqueueWrite(Job job);
 
 private:
-    QSqlDatabase m_db; ///< 数据库连接对象
+    QSqlDatabase m_db;              ///< 数据库连接对象（仅在数据库线程访问）
+    QThread* m_thread = nullptr;    ///< 数据库线程
+    QObject* m_worker = nullptr;    ///< 驻留在数据库线程上的任务接收对象
+    QFuture<bool> m_initFuture;     ///< 初始化结果
+    bool m_ftsAvailable = false;    ///< FTS5 全文索引表是否存在（仅在数据库线程访问）
+
+    static constexpr int kFlushIntervalMs = 200; ///< 写批次的最长等待时间
+    static constexpr int kMaxBatchSize = 500;    ///< 单个写批次的最大操作数
+    static constexpr int kSearchRankWindow = 2000; ///< 全文搜索只对最近的这么多条命中做相关度排序
+    static constexpr int kLikeScanLimit = 50000;   ///< 单字搜索只扫描最近的这么多条消息
+    static constexpr int kBackfillStartupDelayMs = 5000; ///< 启动后开始补建索引的延迟，先让界面的首批查询执行
+    static constexpr int kBackfillIntervalMs = 50;       ///< 分批补建的间隔
+    static constexpr int kBackfillBatchSize = 500;       ///< 每轮补建的消息ID跨度
+    static constexpr int kGcStartupDelayMs = 60000;     ///< 启动后首次回收的延迟，避开启动高峰
+    static constexpr int kGcIntervalMs = 2000;          ///< 分批回收的间隔
+    static constexpr int kGcBatchSize = 100;            ///< 每轮最多处理的文件数
+    static constexpr qint64 kGcGracePeriodMs = 600000;  ///< 未被引用的图片至少保留这么久，覆盖落盘到写入消息之间的窗口
+
+    // 以下成员仅在数据库线程访问
+    bool m_batchOpen = false;                             ///< 是否有未提交的写批次
+    QTimer* m_flushTimer = nullptr;                       ///< 写批次刷新定时器
+    QList<std::function<void(bool)>> m_pendingWrites;     ///< 等待提交结果的写操作
+    QTimer* m_gcTimer = nullptr;                          ///< 后台回收定时器
+    std::unique_ptr<QDirIterator> m_orphanScan;           ///< 未登记文件扫描进度，跨轮次保留
+    bool m_orphanScanDone = false;                        ///< 本次运行是否已完成未登记文件扫描
+    QTimer* m_backfillTimer = nullptr;                    ///< 索引补建定时器
+    qint64 m_backfillDone = 0;                            ///< 已补建到的消息ID
+    qint64 m_backfillEnd = 0;                             ///< 需补建的最大消息ID（迁移时已有的消息），等于已补建进度时表示完成
 };
+
+template <typename Result>
+QFuture<Result> DatabaseManager::cancelledFuture()
+{
+    // 数据库未启动或已关闭：直接取消，调用方的 then() 续体不会被执行
+    qDebug() << "数据库线程未运行，操作已取消";
+
+    QPromise<Result> promise;
+    QFuture<Result> future = promise.future();
+    promise.start();
+    future.cancel();
+    promise.finish();
+    return future;
+}
+
+template <typename Job>
+QFuture<std::invoke_result_t<Job>> DatabaseManager::enqueue(Job job)
+{
+    using Result = std::invoke_result_t<Job>;
+
+    if (!m_worker) return cancelledFuture<Result>();
+
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+
+    // 队列连接保证任务在数据库线程上按提交顺序执行
+    QMetaObject::invokeMethod(m_worker, [promise, job]() mutable {
+        if constexpr (std::is_void_v<Result>) {
+            job();
+        } else {
+            promise->addResult(job());
+        }
+        promise->finish();
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+template <typename Job>
+QFuture<std::invoke_result_t<Job>> DatabaseManager::enqueueWrite(Job job)
+{
+    using Result = std::invoke_result_t<Job>;
+
+    if (!m_worker) return cancelledFuture<Result>();
+
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+
+    QMetaObject::invokeMethod(m_worker, [this, promise, job]() mutable {
+        // 无法开启事务时按自动提交执行，立即完成 future，不让它等到下一个批次
+        if (!beginWriteBatch()) {
+            promise->addResult(job());
+            promise->finish();
+            return;
+        }
+
+        promise->addResult(job());
+
+        m_pendingWrites.append([promise](bool committed) {
+            if (!committed) promise->future().cancel();
+            promise->finish();
+        });
+
+        if (m_pendingWrites.size() >= kMaxBatchSize) flushWrites();
+    }, Qt::QueuedConnection);
+
+    return future;
+}
@@ -12,15 +12,17 @@
 #pragma once
 #include <QString>
 #include <QDateTime>
+#include <QVector>
+#include <QSize>
 
 /**
  * @brief 消息发送者角色枚举
  * 
- * 定义消息发送者的角色类型，对应数据库里的role字段。
+ * 定义消息发送者的角色类型，对应数据库里的role字段（按整数存储，取值不可更改）。
  */
 enum class MessageRole {
-    User, ///< 用户角色
-    AI    ///< AI角色
+    User = 0, ///< 用户角色
+    AI = 1    ///< AI角色
 };
 
 /**
@@ -86,3 +88,111 @@ struct MessageData {
         timestamp = QDateTime::currentMSecsSinceEpoch();
     }
 };
+
+/**
+ * @brief 分页游标
+ *
+ * 键集分页的位置标记，指向上一页中最旧的一行。
+ * 下一页只取 (timestamp, id) 严格小于该位置的记录，翻页耗时与数据量和页码无关。
+ */
+struct MessageCursor {
+    qint64 timestamp = 0;       ///< 上一页最旧记录的时间戳
+    int id = -1;                ///< 上一页最旧记录的ID（时间戳相同时区分先后）
+
+    /**
+     * @brief 判断游标是否有效
+     * @return bool 无效游标表示从最新一页开始
+     */
+    bool isValid() const { return id != -1; }
+};
+
+/**
+ * @brief 消息分页结果
+ */
+struct MessagePage {
+    QVector<MessageData> messages; ///< 本页消息（按时间正序）
+    MessageCursor next;            ///< 加载更早一页所用的游标
+    bool hasMore = false;          ///< 是否还有更早的消息
+};
+
+/**
+ * @brief 画廊图片条目
+ *
+ * 只包含画廊需要的列，不读取消息正文
+ */
+struct GalleryImage {
+    int messageId = -1;         ///< 所属消息ID
+    int sessionId = -1;         ///< 所属会话ID
+    QString path;               ///< 本地图片路径
+    qint64 timestamp = 0;       ///< 生成时间戳
+    QSize size;                 ///< 原图尺寸，未记录时为空
+};
+
+/**
+ * @brief 画廊分页结果
+ */
+struct GalleryPage {
+    QVector<GalleryImage> images;  ///< 本页图片（按时间倒序）
+    MessageCursor next;            ///< 加载更早一页所用的游标
+    bool hasMore = false;          ///< 是否还有更早的图片
+};
+
+/**
+ * @brief 生成任务元数据
+ *
+ * 记录一次生成由哪个工作流、哪些参数、哪台服务器产生，以及各阶段的时间点，
+ * 用于结果复现和服务器延迟统计。时间戳均为毫秒，0 表示该阶段未发生或未观测到。
+ */
+struct GenerationRecord {
+    QString promptId;           ///< 服务器返回的任务ID
+    int workflowType = -1;      ///< 工作流类型（WorkflowType 的整数值）
+    QString templateHash;       ///< 工作流模板的 SHA-256
+    QString paramsJson;         ///< 绑定到模板的全部参数（JSON）
+    qint64 seed = -1;           ///< 随机种子，-1 表示无
+    int width = 0;              ///< 输出宽度（文本结果为 0）
+    int height = 0;             ///< 输出高度（文本结果为 0）
+    QString backendUrl;         ///< 执行任务的服务器地址
+
+    qint64 uploadMs = 0;        ///< 参考图上传耗时
+    qint64 submittedAt = 0;     ///< 提交任务的时间
+    qint64 startedAt = 0;       ///< 服务器开始执行的时间
+    qint64 executedAt = 0;      ///< 输出节点执行完毕的时间
+    qint64 finishedAt = 0;      ///< 结果落地（下载完成或文本结束）的时间
+};
+
+/**
+ * @brief 搜索结果条目
+ */
+struct SearchHit {
+    int messageId = -1;         ///< 命中的消息ID
+    int sessionId = -1;         ///< 所属会话ID
+    QString sessionTitle;       ///< 所属会话标题
+    MessageRole role = MessageRole::User; ///< 消息发送者角色
+    QString snippet;            ///< 命中片段（已转义的富文本，命中词高亮）
+    qint64 timestamp = 0;       ///< 消息时间戳
+};
+
+/**
+ * @brief 一次搜索的结果范围
+ *
+ * 首页查询时确定，翻页时原样传回，保证各页在同一批消息、同一排序窗口内取结果，不重复也不遗漏
+ */
+struct SearchWindow {
+    qint64 ceiling = -1;        ///< 首页查询时的最大消息ID，之后新增的消息不进入本次结果
+    qint64 rankFloor = 0;       ///< 参与相关度排序的最小消息ID，更早的命中排在其后按新旧排序
+    bool indexed = false;       ///< 首页是否使用了全文索引，翻页沿用同一方式
+
+    /**
+     * @brief 是否已由首页确定
+     * @return bool 是否有效
+     */
+    bool isValid() const { return ceiling >= 0; }
+};
+
+/**
+ * @brief 搜索分页结果
+ */
+struct SearchPage {
+    QVector<SearchHit> hits;    ///< 本页命中结果
+    SearchWindow window;        ///< 结果范围，加载下一页时传回
+};
@@ -0,0 +1,168 @@
+/**
+ * @file GalleryModel.cpp
+ * @brief 生成历史画廊模型实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "GalleryModel.h"
+#include "../Database/DatabaseManager.h"
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+GalleryModel::GalleryModel(QObject* parent) : QAbstractListModel(parent) {}
+
+/**
+ * @brief 获取行数
+ * @param parent 父索引
+ * @return int 已加载的图片数量
+ */
+int GalleryModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_images.size();
+}
+
+/**
+ * @brief 获取数据
+ * @param index 索引
+ * @param role 数据角色
+ * @return QVariant 数据
+ */
+QVariant GalleryModel::data(const QModelIndex& index, int role) const
+{
+    const GalleryImage* image = imageAt(index);
+    if (!image) return QVariant();
+
+    if (role == Qt::DisplayRole || role == Qt::ToolTipRole) return image->path;
+    return QVariant();
+}
+
+/**
+ * @brief 获取索引对应的图片
+ * @param index 索引
+ * @return const GalleryImage* 图片指针，索引无效时为空
+ */
+const GalleryImage* GalleryModel::imageAt(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_images.size()) return nullptr;
+    return &m_images[index.row()];
+}
+
+/**
+ * @brief 是否还能加载更早的图片
+ * @param parent 父索引
+ * @return bool 还有下一页且当前没有在加载
+ */
+bool GalleryModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_hasMore && !m_fetching;
+}
+
+/**
+ * @brief 异步加载下一页
+ * @param parent 父索引
+ */
+void GalleryModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) return;
+
+    const int serial = m_serial;
+    m_fetching = true;
+
+    DatabaseManager::instance().getAiImagePage(m_cursor).then(this, [this, serial](const GalleryPage& page) {
+        if (serial != m_serial) return;
+
+        m_fetching = false;
+        m_loaded = true;
+        m_cursor = page.next;
+        m_hasMore = page.hasMore;
+
+        QVector<GalleryImage> fresh;
+        fresh.reserve(page.images.size());
+        for (const GalleryImage& image : page.images) {
+            if (m_paths.contains(image.path)) continue;
+            m_paths.insert(image.path);
+            fresh.append(image);
+        }
+
+        if (!fresh.isEmpty()) {
+            beginInsertRows(QModelIndex(), m_images.size(), m_images.size() + fresh.size() - 1);
+            m_images += fresh;
+            endInsertRows();
+        }
+
+        const QVector<GalleryImage> early = std::exchange(m_early, {});
+        for (const GalleryImage& image : early) prepend(image);
+
+        emit pageLoaded();
+    });
+}
+
+/**
+ * @brief 丢弃已加载的图片并从第一页重新加载
+ */
+void GalleryModel::reload()
+{
+    ++m_serial;
+
+    beginResetModel();
+    m_images.clear();
+    m_paths.clear();
+    m_early.clear();
+    m_cursor = MessageCursor();
+    m_hasMore = true;
+    m_fetching = false;
+    m_loaded = false;
+    endResetModel();
+
+    fetchMore(QModelIndex());
+}
+
+/**
+ * @brief 在顶部插入新生成的图片
+ * @param image 图片数据
+ */
+void GalleryModel::prepend(const GalleryImage& image)
+{
+    if (!m_loaded) {
+        if (m_fetching) m_early.append(image);
+        return;
+    }
+    if (m_paths.contains(image.path)) return;
+
+    m_paths.insert(image.path);
+    beginInsertRows(QModelIndex(), 0, 0);
+    m_images.prepend(image);
+    endInsertRows();
+}
+
+/**
+ * @brief 移除属于指定会话的图片
+ * @param sessionId 已删除的会话ID
+ */
+void GalleryModel::removeSession(int sessionId)
+{
+    m_early.erase(std::remove_if(m_early.begin(), m_early.end(),
+                                 [sessionId](const GalleryImage& image) { return image.sessionId == sessionId; }),
+                  m_early.end());
+
+    // 从后往前按连续区间删除，前面的行号不受影响
+    for (int end = m_images.size() - 1; end >= 0; --end) {
+        if (m_images[end].sessionId != sessionId) continue;
+
+        int start = end;
+        while (start > 0 && m_images[start - 1].sessionId == sessionId) --start;
+
+        beginRemoveRows(QModelIndex(), start, end);
+        for (int row = start; row <= end; ++row) m_paths.remove(m_images[row].path);
+        m_images.remove(start, end - start + 1);
+        endRemoveRows();
+
+        end = start;
+    }
+}
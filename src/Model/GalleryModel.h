@@ -0,0 +1,114 @@
+/**
+ * @file GalleryModel.h
+ * @brief 生成历史画廊模型头文件
+ *
+ * 该文件定义了GalleryModel类，作为历史画廊视图的数据源。
+ * 图片按时间倒序分页从数据库读取，视图滚动到底部附近时通过 fetchMore 加载下一页。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QSet>
+#include <QVector>
+#include "DataModels.h"
+
+/**
+ * @brief 生成历史画廊模型类
+ *
+ * 继承自QAbstractListModel，只保存图片路径和尺寸，缩略图由绘制代理按需加载。
+ * 新生成的图片通过 prepend() 插入到顶部，不需要重新查询已加载的页。
+ */
+class GalleryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit GalleryModel(QObject* parent = nullptr);
+
+    /**
+     * @brief 获取行数
+     * @param parent 父索引（列表模型恒为无效索引）
+     * @return int 已加载的图片数量
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief 获取数据
+     * @param index 索引
+     * @param role 数据角色
+     * @return QVariant DisplayRole/ToolTipRole 返回图片路径；绘制使用 imageAt()
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 是否还能加载更早的图片
+     * @param parent 父索引
+     * @return bool 还有下一页且当前没有在加载
+     */
+    bool canFetchMore(const QModelIndex& parent) const override;
+
+    /**
+     * @brief 异步加载下一页
+     * @param parent 父索引
+     */
+    void fetchMore(const QModelIndex& parent) override;
+
+    /**
+     * @brief 获取索引对应的图片
+     * @param index 索引
+     * @return const GalleryImage* 图片指针，索引无效时为空
+     */
+    const GalleryImage* imageAt(const QModelIndex& index) const;
+
+    /**
+     * @brief 丢弃已加载的图片并从第一页重新加载
+     */
+    void reload();
+
+    /**
+     * @brief 在顶部插入新生成的图片
+     * @param image 图片数据
+     *
+     * 路径已在列表中时忽略；第一页仍在查询时先暂存，第一页返回后再插入
+     */
+    void prepend(const GalleryImage& image);
+
+    /**
+     * @brief 移除属于指定会话的图片
+     * @param sessionId 已删除的会话ID
+     *
+     * 只删除对应的行，其余已加载的页和滚动位置保持不变
+     */
+    void removeSession(int sessionId);
+
+    /**
+     * @brief 第一页是否已返回
+     * @return bool 已返回过至少一页
+     */
+    bool isLoaded() const { return m_loaded; }
+
+signals:
+    /**
+     * @brief 一页数据加载完成
+     */
+    void pageLoaded();
+
+private:
+    QVector<GalleryImage> m_images; ///< 已加载的图片（时间倒序）
+    QSet<QString> m_paths;          ///< 已加载的图片路径，相同内容的图片只显示一次
+    QVector<GalleryImage> m_early;  ///< 第一页返回前到达的新图片
+    MessageCursor m_cursor;         ///< 已加载的最旧图片位置
+    bool m_hasMore = false;         ///< 是否还有更早的图片
+    bool m_fetching = false;        ///< 是否正在加载下一页
+    bool m_loaded = false;          ///< 是否已返回过至少一页
+    int m_serial = 0;               ///< 加载序号，reload() 后丢弃旧的分页结果
+};
@@ -0,0 +1,195 @@
+/**
+ * @file MessageModel.cpp
+ * @brief 聊天消息列表模型实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "MessageModel.h"
+
+/**
+ * @brief 从数据库消息构造条目
+ * @param msg 消息数据
+ * @return ChatItem 聊天条目
+ */
+ChatItem ChatItem::fromMessage(const MessageData& msg)
+{
+    ChatItem item;
+    item.messageId = msg.id;
+    item.role = msg.role;
+    item.kind = msg.isImage() ? Kind::Image : Kind::Text;
+    item.text = msg.text;
+    item.imagePath = msg.imagePath;
+    return item;
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+MessageModel::MessageModel(QObject* parent) : QAbstractListModel(parent) {}
+
+/**
+ * @brief 获取行数
+ * @param parent 父索引
+ * @return int 条目数量
+ */
+int MessageModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_items.size();
+}
+
+/**
+ * @brief 获取数据
+ * @param index 索引
+ * @param role 数据角色
+ * @return QVariant 数据
+ */
+QVariant MessageModel::data(const QModelIndex& index, int role) const
+{
+    const ChatItem* item = itemAt(index);
+    if (!item) return QVariant();
+
+    if (role == Qt::DisplayRole) return item->text;
+    return QVariant();
+}
+
+/**
+ * @brief 获取索引对应的条目
+ * @param index 索引
+ * @return const ChatItem* 条目指针，索引无效时为空
+ */
+const ChatItem* MessageModel::itemAt(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_items.size()) return nullptr;
+    return &m_items[index.row()];
+}
+
+/**
+ * @brief 在末尾追加条目
+ * @param item 条目数据
+ * @return int 新条目的 key
+ */
+int MessageModel::append(ChatItem item)
+{
+    item.key = m_nextKey++;
+
+    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
+    m_items.append(std::move(item));
+    endInsertRows();
+
+    return m_items.last().key;
+}
+
+/**
+ * @brief 在末尾追加一批条目
+ * @param items 按时间正序排列的条目
+ */
+void MessageModel::append(const QVector<ChatItem>& items)
+{
+    if (items.isEmpty()) return;
+
+    beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + items.size() - 1);
+    for (ChatItem item : items) {
+        item.key = m_nextKey++;
+        m_items.append(std::move(item));
+    }
+    endInsertRows();
+}
+
+/**
+ * @brief 在顶部插入一批更早的条目
+ * @param items 按时间正序排列的条目
+ */
+void MessageModel::prepend(const QVector<ChatItem>& items)
+{
+    if (items.isEmpty()) return;
+
+    QVector<ChatItem> merged;
+    merged.reserve(items.size() + m_items.size());
+    for (ChatItem item : items) {
+        item.key = m_nextKey++;
+        merged.append(std::move(item));
+    }
+    merged += m_items;
+
+    beginInsertRows(QModelIndex(), 0, items.size() - 1);
+    m_items = std::move(merged);
+    endInsertRows();
+}
+
+/**
+ * @brief 修改条目
+ * @param key 条目 key
+ * @param change 修改函数
+ * @return bool 条目是否存在
+ */
+bool MessageModel::update(int key, const std::function<void(ChatItem&)>& change)
+{
+    int row = rowForKey(key);
+    if (row < 0) return false;
+
+    change(m_items[row]);
+    m_items[row].key = key;
+
+    QModelIndex idx = index(row);
+    emit dataChanged(idx, idx);
+    return true;
+}
+
+/**
+ * @brief 删除条目
+ * @param key 条目 key
+ * @return bool 条目是否存在
+ */
+bool MessageModel::remove(int key)
+{
+    int row = rowForKey(key);
+    if (row < 0) return false;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_items.removeAt(row);
+    endRemoveRows();
+    return true;
+}
+
+/**
+ * @brief 查找条目所在行
+ * @param key 条目 key
+ * @return int 行号，不存在时为 -1
+ */
+int MessageModel::rowForKey(int key) const
+{
+    for (int row = m_items.size() - 1; row >= 0; --row) {
+        if (m_items[row].key == key) return row;
+    }
+    return -1;
+}
+
+/**
+ * @brief 查找数据库消息所在行
+ * @param messageId 数据库消息ID
+ * @return int 行号，不存在时为 -1
+ */
+int MessageModel::rowForMessage(int messageId) const
+{
+    if (messageId == -1) return -1;
+
+    for (int row = m_items.size() - 1; row >= 0; --row) {
+        if (m_items[row].messageId == messageId) return row;
+    }
+    return -1;
+}
+
+/**
+ * @brief 清空所有条目
+ */
+void MessageModel::clear()
+{
+    if (m_items.isEmpty()) return;
+
+    beginResetModel();
+    m_items.clear();
+    endResetModel();
+}
@@ -0,0 +1,153 @@
+/**
+ * @file MessageModel.h
+ * @brief 聊天消息列表模型头文件
+ * 
+ * 该文件定义了MessageModel类，作为聊天区域 QListView 的数据源。
+ * 模型只保存轻量的条目数据，图片按路径在绘制时异步加载，不随条目常驻内存。
+ * 
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QPixmap>
+#include <QVector>
+#include <functional>
+#include "DataModels.h"
+
+/**
+ * @brief 聊天条目
+ * 
+ * 历史消息只记录图片路径；实时结果和用户上传的图片尚未落盘时才在内存中持有显示尺寸的图片，
+ * 用户图片有本地文件时记录其路径，没有时（如剪贴板粘贴）另外保留原图。
+ */
+struct ChatItem {
+    /**
+     * @brief 条目类型
+     */
+    enum class Kind {
+        Text,   ///< 文本消息
+        Image,  ///< 图片消息
+        Loading ///< 等待生成结果的占位
+    };
+
+    int key = -1;                         ///< 界面内唯一标识，插入时由模型分配
+    int messageId = -1;                   ///< 数据库消息ID，-1 表示未知
+    MessageRole role = MessageRole::User; ///< 消息角色
+    Kind kind = Kind::Text;               ///< 条目类型
+    QString text;                         ///< 文本内容
+    QString imagePath;                    ///< 本地原图路径
+    QPixmap image;                        ///< 尚未落盘的图片（已缩到显示尺寸以内）
+    QPixmap original;                     ///< 没有本地路径的用户图片原图，复制、保存和查看时使用
+    QString serverFileName;               ///< 服务器文件名（用于高清修复）
+    bool isPreview = false;               ///< 图片是否只是预览图（原图仍在下载）
+
+    /**
+     * @brief 从数据库消息构造条目
+     * @param msg 消息数据
+     * @return ChatItem 聊天条目
+     */
+    static ChatItem fromMessage(const MessageData& msg);
+};
+
+/**
+ * @brief 聊天消息列表模型类
+ * 
+ * 继承自QAbstractListModel，行按时间正序排列。条目以 key 标识，
+ * 行号会因顶部插入历史而变化，外部持有 key 而不是行号。
+ */
+class MessageModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit MessageModel(QObject* parent = nullptr);
+
+    /**
+     * @brief 获取行数
+     * @param parent 父索引（列表模型恒为无效索引）
+     * @return int 条目数量
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief 获取数据
+     * @param index 索引
+     * @param role 数据角色
+     * @return QVariant DisplayRole 返回文本，其余角色为空；绘制使用 itemAt()
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 获取索引对应的条目
+     * @param index 索引
+     * @return const ChatItem* 条目指针，索引无效时为空
+     */
+    const ChatItem* itemAt(const QModelIndex& index) const;
+
+    /**
+     * @brief 在末尾追加条目
+     * @param item 条目数据（key 由模型分配）
+     * @return int 新条目的 key
+     */
+    int append(ChatItem item);
+
+    /**
+     * @brief 在末尾追加一批条目
+     * @param items 按时间正序排列的条目
+     */
+    void append(const QVector<ChatItem>& items);
+
+    /**
+     * @brief 在顶部插入一批更早的条目
+     * @param items 按时间正序排列的条目
+     */
+    void prepend(const QVector<ChatItem>& items);
+
+    /**
+     * @brief 修改条目
+     * @param key 条目 key
+     * @param change 修改函数
+     * @return bool 条目是否存在
+     */
+    bool update(int key, const std::function<void(ChatItem&)>& change);
+
+    /**
+     * @brief 删除条目
+     * @param key 条目 key
+     * @return bool 条目是否存在
+     */
+    bool remove(int key);
+
+    /**
+     * @brief 查找条目所在行
+     * @param key 条目 key
+     * @return int 行号，不存在时为 -1
+     *
+     * 从末尾向前查找，实时更新的条目通常位于末尾
+     */
+    int rowForKey(int key) const;
+
+    /**
+     * @brief 查找数据库消息所在行
+     * @param messageId 数据库消息ID
+     * @return int 行号，不存在时为 -1
+     */
+    int rowForMessage(int messageId) const;
+
+    /**
+     * @brief 清空所有条目
+     */
+    void clear();
+
+private:
+    QVector<ChatItem> m_items; ///< 条目列表（时间正序）
+    int m_nextKey = 0;         ///< 下一个可分配的 key
+};
@@ -0,0 +1,43 @@
+/**
+ * @file SessionFilterModel.cpp
+ * @brief 会话标题过滤模型实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "SessionFilterModel.h"
+#include "SessionModel.h"
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+SessionFilterModel::SessionFilterModel(QObject* parent) : QSortFilterProxyModel(parent) {}
+
+/**
+ * @brief 设置过滤文本
+ * @param text 过滤文本
+ */
+void SessionFilterModel::setFilterText(const QString& text)
+{
+    const QString needle = text.trimmed().toCaseFolded();
+    if (needle == m_needle) return;
+
+    m_needle = needle;
+    invalidateRowsFilter();
+}
+
+/**
+ * @brief 判断源模型中的行是否显示
+ * @param sourceRow 源模型行号
+ * @param sourceParent 源模型父索引
+ * @return bool 是否显示
+ */
+bool SessionFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    if (m_needle.isEmpty()) return true;
+
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    return index.data(SessionModel::SearchKeyRole).toString().contains(m_needle);
+}
@@ -0,0 +1,50 @@
+/**
+ * @file SessionFilterModel.h
+ * @brief 会话标题过滤模型头文件
+ *
+ * 该文件定义了SessionFilterModel类，在 SessionModel 之上按输入内容即时过滤会话标题。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QSortFilterProxyModel>
+
+/**
+ * @brief 会话标题过滤模型类
+ *
+ * 继承自QSortFilterProxyModel，与 SessionModel 缓存的折叠标题做子串匹配，
+ * 不区分大小写，每次按键只做内存比较，不访问数据库。
+ */
+class SessionFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit SessionFilterModel(QObject* parent = nullptr);
+
+    /**
+     * @brief 设置过滤文本
+     * @param text 过滤文本，为空时显示全部会话
+     */
+    void setFilterText(const QString& text);
+
+protected:
+    /**
+     * @brief 判断源模型中的行是否显示
+     * @param sourceRow 源模型行号
+     * @param sourceParent 源模型父索引
+     * @return bool 标题包含过滤文本时返回 true
+     */
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    QString m_needle; ///< 大小写折叠后的过滤文本
+};
@@ -0,0 +1,188 @@
+/**
+ * @file SessionModel.cpp
+ * @brief 会话列表模型实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "SessionModel.h"
+#include "../Database/DatabaseManager.h"
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+SessionModel::SessionModel(QObject* parent) : QAbstractListModel(parent) {}
+
+/**
+ * @brief 获取行数
+ * @param parent 父索引
+ * @return int 会话数量
+ */
+int SessionModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_sessions.size();
+}
+
+/**
+ * @brief 获取数据
+ * @param index 索引
+ * @param role 数据角色
+ * @return QVariant 数据
+ */
+QVariant SessionModel::data(const QModelIndex& index, int role) const
+{
+    const SessionData* session = index.isValid() ? sessionAt(index.row()) : nullptr;
+    if (!session) return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+    case Qt::ToolTipRole:
+        return session->name;
+    case SearchKeyRole:
+        return m_searchKeys[index.row()];
+    case IdRole:
+        return session->id;
+    case CreatedAtRole:
+        return session->createdAt;
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief 修改数据（行内重命名）
+ * @param index 索引
+ * @param value 新标题
+ * @param role 数据角色
+ * @return bool 是否修改成功
+ */
+bool SessionModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    const SessionData* session = index.isValid() ? sessionAt(index.row()) : nullptr;
+    const QString name = value.toString().trimmed();
+    if (!session || role != Qt::EditRole || name.isEmpty()) return false;
+
+    renameSession(session->id, name);
+    return true;
+}
+
+/**
+ * @brief 条目标志
+ * @param index 索引
+ * @return Qt::ItemFlags 条目标志
+ */
+Qt::ItemFlags SessionModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+/**
+ * @brief 获取指定行的会话
+ * @param row 行号
+ * @return const SessionData* 会话指针，行号无效时为空
+ */
+const SessionData* SessionModel::sessionAt(int row) const
+{
+    if (row < 0 || row >= m_sessions.size()) return nullptr;
+    return &m_sessions[row];
+}
+
+/**
+ * @brief 查找会话所在行
+ * @param id 会话ID
+ * @return int 行号，不存在时为 -1
+ */
+int SessionModel::rowForId(int id) const
+{
+    for (int row = 0; row < m_sessions.size(); ++row) {
+        if (m_sessions[row].id == id) return row;
+    }
+    return -1;
+}
+
+/**
+ * @brief 从数据库加载全部会话
+ * @return QFuture<void> 模型重置完成后完成
+ */
+QFuture<void> SessionModel::load()
+{
+    return DatabaseManager::instance().getAllSessions().then(this, [this](const QVector<SessionData>& sessions) {
+        beginResetModel();
+        m_sessions = sessions;
+        m_searchKeys.clear();
+        m_searchKeys.reserve(sessions.size());
+        for (const SessionData& session : sessions) m_searchKeys.append(session.name.toCaseFolded());
+        endResetModel();
+    });
+}
+
+/**
+ * @brief 新建会话
+ * @param name 会话名称
+ * @return QFuture<int> 新会话ID，失败返回-1
+ */
+QFuture<int> SessionModel::createSession(const QString& name)
+{
+    const qint64 createdAt = QDateTime::currentMSecsSinceEpoch();
+
+    return DatabaseManager::instance().createSession(name).then(this, [this, name, createdAt](int id) {
+        if (id == -1) return id;
+
+        SessionData session(id, name);
+        session.createdAt = createdAt;
+
+        beginInsertRows(QModelIndex(), 0, 0);
+        m_sessions.prepend(session);
+        m_searchKeys.prepend(name.toCaseFolded());
+        endInsertRows();
+        return id;
+    });
+}
+
+/**
+ * @brief 重命名会话
+ * @param id 会话ID
+ * @param name 新名称
+ */
+void SessionModel::renameSession(int id, const QString& name)
+{
+    const int row = rowForId(id);
+    if (row == -1 || m_sessions[row].name == name) return;
+
+    m_sessions[row].name = name;
+    m_searchKeys[row] = name.toCaseFolded();
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, { Qt::DisplayRole, Qt::EditRole, Qt::ToolTipRole, SearchKeyRole });
+
+    DatabaseManager::instance().renameSession(id, name).then(this, [id](bool ok) {
+        if (!ok) qDebug() << "会话" << id << "重命名写入失败";
+    });
+}
+
+/**
+ * @brief 删除会话
+ * @param id 会话ID
+ * @return QFuture<bool> 删除是否成功
+ */
+QFuture<bool> SessionModel::removeSession(int id)
+{
+    return DatabaseManager::instance().deleteSession(id).then(this, [this, id](bool ok) {
+        if (!ok) {
+            qDebug() << "会话" << id << "删除失败";
+            return false;
+        }
+
+        const int row = rowForId(id);
+        if (row != -1) {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_sessions.removeAt(row);
+            m_searchKeys.removeAt(row);
+            endRemoveRows();
+        }
+        return true;
+    });
+}
@@ -0,0 +1,128 @@
+/**
+ * @file SessionModel.h
+ * @brief 会话列表模型头文件
+ *
+ * 该文件定义了SessionModel类，位于 DatabaseManager 之前，作为会话列表的唯一数据源。
+ * 新建、重命名和删除会话时只修改对应的行并发出插入/更新/删除通知，不再重新查询整个列表。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFuture>
+#include <QVector>
+#include "DataModels.h"
+
+/**
+ * @brief 会话列表模型类
+ *
+ * 继承自QAbstractListModel，行按创建时间倒序排列，新会话插入到第一行。
+ * 界面通过 rowsInserted / dataChanged / rowsAboutToBeRemoved 增量更新，
+ * 只有启动时的 load() 会读取全部会话。
+ */
+class SessionModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Roles {
+        IdRole = Qt::UserRole + 1, ///< 会话ID
+        CreatedAtRole,             ///< 创建时间戳
+        SearchKeyRole              ///< 大小写折叠后的标题，供过滤使用
+    };
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit SessionModel(QObject* parent = nullptr);
+
+    /**
+     * @brief 获取行数
+     * @param parent 父索引（列表模型恒为无效索引）
+     * @return int 会话数量
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief 获取数据
+     * @param index 索引
+     * @param role 数据角色
+     * @return QVariant DisplayRole/EditRole 返回标题，其余自定义角色见 Roles
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 修改数据（行内重命名）
+     * @param index 索引
+     * @param value 新标题
+     * @param role 数据角色，只接受 EditRole
+     * @return bool 是否修改成功
+     */
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+    /**
+     * @brief 条目标志
+     * @param index 索引
+     * @return Qt::ItemFlags 可选中、可编辑
+     */
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /**
+     * @brief 获取指定行的会话
+     * @param row 行号
+     * @return const SessionData* 会话指针，行号无效时为空
+     */
+    const SessionData* sessionAt(int row) const;
+
+    /**
+     * @brief 查找会话所在行
+     * @param id 会话ID
+     * @return int 行号，不存在时为 -1
+     */
+    int rowForId(int id) const;
+
+    /**
+     * @brief 从数据库加载全部会话
+     * @return QFuture<void> 模型重置完成后完成
+     *
+     * 只在启动时调用一次，之后的变化都通过下面的增量接口进入模型
+     */
+    QFuture<void> load();
+
+    /**
+     * @brief 新建会话
+     * @param name 会话名称
+     * @return QFuture<int> 新会话ID，失败返回-1；完成时新行已插入到第一行
+     */
+    QFuture<int> createSession(const QString& name);
+
+    /**
+     * @brief 重命名会话
+     * @param id 会话ID
+     * @param name 新名称
+     *
+     * 立即更新对应行并写入数据库
+     */
+    void renameSession(int id, const QString& name);
+
+    /**
+     * @brief 删除会话
+     * @param id 会话ID
+     * @return QFuture<bool> 删除是否成功
+     *
+     * 会话及其消息在数据库线程中删除，删除成功后才移除对应行，失败时列表保持不变
+     */
+    QFuture<bool> removeSession(int id);
+
+private:
+    QVector<SessionData> m_sessions; ///< 会话列表（创建时间倒序）
+    QVector<QString> m_searchKeys;   ///< 与会话一一对应的折叠标题，过滤时不必逐行重新折叠
+};
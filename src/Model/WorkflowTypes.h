@@ -3,7 +3,7 @@
  * @brief 工作流类型定义头文件
  * 
  * 该文件定义了工作流相关的枚举类型和数据结构。
- * 包含工作流类型枚举和工作流信息结构体定义。
+ * 包含工作流类型枚举、工作流信息结构体和上传前缩放策略定义。
  * 
  * @author CloudArt Team
  * @version 1.0
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <QString>
+#include <QSize>
+#include <QtMath>
 
 /**
  * @brief 工作流类型枚举
@@ -57,3 +59,47 @@ struct WorkflowInfo {
                  const QString& gifPath = "", const QString& description = "", WorkflowType type = WorkflowType::TextToImage)
         : id(id), name(name), imagePath(imagePath), gifPath(gifPath), description(description), type(type) {}
 };
+
+/**
+ * @brief 上传前缩放策略
+ *
+ * 对应工作流模板中 MySmartResize 节点的配置。服务端反正会把参考图缩到这个尺寸，
+ * 客户端提前缩放可以避免把大图原样推过隧道。
+ */
+struct UploadResizePolicy {
+    /**
+     * @brief 缩放模式
+     */
+    enum class Mode {
+        None,      ///< 不缩放（如高清修复需要原图）
+        LongEdge,  ///< 长边不超过 targetValue
+        Megapixel  ///< 总像素不超过 targetValue × targetValue
+    };
+
+    Mode mode = Mode::None; ///< 缩放模式
+    int targetValue = 0;    ///< 目标值（像素）
+
+    /**
+     * @brief 计算源图片缩放后的尺寸
+     * @param source 源图片尺寸
+     * @return QSize 目标尺寸，无需缩放时返回源尺寸
+     */
+    QSize targetSize(const QSize& source) const
+    {
+        if (mode == Mode::None || targetValue <= 0 || source.isEmpty()) return source;
+
+        double factor = 1.0;
+        if (mode == Mode::LongEdge) {
+            int longEdge = qMax(source.width(), source.height());
+            if (longEdge > targetValue) factor = double(targetValue) / longEdge;
+        } else {
+            double pixels = double(source.width()) * source.height();
+            double limit = double(targetValue) * targetValue;
+            if (pixels > limit) factor = qSqrt(limit / pixels);
+        }
+
+        if (factor >= 1.0) return source;
+
+        return QSize(qMax(1, int(source.width() * factor)), qMax(1, int(source.height() * factor)));
+    }
+};
@@ -7,6 +7,7 @@
  */
 
 #include "ComfyApiService.h"
+#include "../Core/ImagePreprocessor.h"
 #include <QNetworkRequest>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -21,6 +22,38 @@
 #include <QFileInfo>
 #include <QSslConfiguration>
 #include <QSslSocket>
+#include <QDir>
+#include <QSaveFile>
+#include <QBuffer>
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 创建硬链接
+ * @param source 源文件路径
+ * @param target 链接路径
+ * @return bool 是否创建成功（跨卷等情况会失败）
+ */
+static bool createHardLink(const QString& source, const QString& target)
+{
+#ifdef Q_OS_WIN
+    return CreateHardLinkW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(target).utf16()),
+                           reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(source).utf16()),
+                           nullptr) != 0;
+#else
+    return ::link(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0;
+#endif
+}
 
 /**
  * @brief 构造函数
@@ -111,6 +144,22 @@ void ComfyApiService::connectToHost(const QString& fullUrl)
     m_webSocket->open(QUrl(wsUrl));
 }
 
+/**
+ * @brief 设置同机直连目录
+ * @param comfyDir ComfyUI 根目录，为空表示关闭直连
+ */
+void ComfyApiService::setLocalComfyDir(const QString& comfyDir)
+{
+    m_localComfyDir = comfyDir.trimmed();
+    if (m_localComfyDir.endsWith("/") || m_localComfyDir.endsWith("\\")) {
+        m_localComfyDir.chop(1);
+    }
+
+    if (!m_localComfyDir.isEmpty()) {
+        qDebug() << "已启用同机直连模式:" << m_localComfyDir;
+    }
+}
+
 /**
  * @brief 发送提示词生成任务
  * @param workflow 工作流JSON对象
@@ -184,6 +233,19 @@ void ComfyApiService::onTextMessageReceived(const QString &message)
         return;
     }
 
+    if (msgType == "execution_start") {
+        emit executionStarted(data["prompt_id"].toString());
+        return;
+    }
+
+    if (msgType == "execution_error" || msgType == "execution_interrupted") {
+        QString promptId = data["prompt_id"].toString();
+        QString error = data["exception_message"].toString();
+        qDebug() << "任务未完成:" << msgType << promptId << error;
+        emit executionFailed(promptId, error);
+        return;
+    }
+
     if (msgType == "executed") {
         QString nodeId = QString::number(data["node"].toInt());
         if (nodeId == "0") nodeId = data["node"].toString();
@@ -193,6 +255,8 @@ void ComfyApiService::onTextMessageReceived(const QString &message)
         qDebug() << "检查结束条件 | 收到ID:" << nodeId << " | 目标ID: 4 | 任务匹配:" << (promptId == m_currentPromptId);
 
         if (promptId == m_currentPromptId && (nodeId == "20" || nodeId == "1" || nodeId == "9")) {
+            emit promptExecuted(promptId);
+
             QJsonObject output = data["output"].toObject();
             QJsonArray images = output["images"].toArray();
             if (!images.isEmpty()) {
@@ -205,6 +269,7 @@ void ComfyApiService::onTextMessageReceived(const QString &message)
 
         if (promptId == m_currentPromptId && nodeId == "4") {
             qDebug() << "触发反推强制解锁";
+            emit promptExecuted(promptId);
             emit streamTokenReceived("", true);
         }
     }
@@ -218,12 +283,151 @@ void ComfyApiService::onTextMessageReceived(const QString &message)
  * @param promptId 提示词ID
  */
 void ComfyApiService::getImage(const QString& filename, const QString& subfolder, const QString& type, const QString& promptId)
+{
+    if (!m_localComfyDir.isEmpty()) {
+        if (loadLocalOutput(filename, subfolder, type, promptId)) return;
+        qDebug() << "本地读取结果失败，回退到 HTTP 下载";
+    }
+
+    QNetworkReply* reply = requestView(filename, subfolder, type, promptId, true);
+    connect(reply, &QNetworkReply::finished, this, &ComfyApiService::onImagePreviewFinished);
+}
+
+/**
+ * @brief 同机模式下直接从输出目录读取结果
+ * @param filename 图片文件名
+ * @param subfolder 子文件夹路径
+ * @param type 图片类型
+ * @param promptId 提示词ID
+ * @return bool 是否读取成功
+ */
+bool ComfyApiService::loadLocalOutput(const QString& filename, const QString& subfolder, const QString& type, const QString& promptId)
+{
+    // 类型、子目录和文件名都来自服务端消息：类型只接受 ComfyUI 的三个目录，
+    // 最终路径再与 ComfyUI 根目录比较，防止 ../ 跳出
+    QString typeDir = type.isEmpty() ? QString("output") : type;
+    if (typeDir != "output" && typeDir != "temp" && typeDir != "input") {
+        qDebug() << "拒绝读取未知类型的文件:" << typeDir;
+        return false;
+    }
+
+    QString rootDir = QDir::cleanPath(m_localComfyDir);
+    QString fullPath = QDir::cleanPath(rootDir + "/" + typeDir + "/" + subfolder + "/" + filename);
+
+    if (!fullPath.startsWith(rootDir + "/")) {
+        qDebug() << "拒绝读取目录外的文件:" << fullPath;
+        return false;
+    }
+
+    QFile file(fullPath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    qint64 size = file.size();
+    uchar* mapped = file.map(0, size);
+    if (!mapped) return false;
+
+    // 解码、哈希和落盘都直接使用映射内存，不把整个文件复制进进程；映射在信号处理完毕后释放
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size);
+
+    QPixmap pixmap;
+    bool ok = pixmap.loadFromData(data);
+
+    if (!ok) {
+        qDebug() << "本地图片数据损坏:" << fullPath;
+        file.unmap(mapped);
+        return false;
+    }
+
+    qDebug() << "本地直读结果成功:" << fullPath;
+    emit imageReceived(promptId, filename, pixmap, data);
+    file.unmap(mapped);
+    return true;
+}
+
+/**
+ * @brief 在 input 目录中为文件分配一个不冲突的文件名
+ * @param fileName 期望的文件名
+ * @return QString 可用的完整路径，input 目录不存在时返回空
+ */
+QString ComfyApiService::reserveLocalInputPath(const QString& fileName)
+{
+    QDir inputDir(m_localComfyDir + "/input");
+    if (!inputDir.exists()) {
+        qDebug() << "ComfyUI input 目录不存在:" << inputDir.path();
+        return QString();
+    }
+
+    QFileInfo info(fileName);
+    QString name = info.fileName();
+
+    // 与 ComfyUI 上传接口一致：重名时追加 " (n)"
+    int counter = 1;
+    while (inputDir.exists(name)) {
+        name = QString("%1 (%2).%3").arg(info.completeBaseName()).arg(counter++).arg(info.suffix());
+    }
+
+    return inputDir.filePath(name);
+}
+
+/**
+ * @brief 同机模式下把本地文件放进 ComfyUI 的 input 目录
+ * @param localPath 本地图片路径
+ * @return QString ComfyUI 可识别的文件名，失败返回空
+ */
+QString ComfyApiService::placeLocalInput(const QString& localPath)
+{
+    QString target = reserveLocalInputPath(localPath);
+    if (target.isEmpty()) return QString();
+
+    if (!createHardLink(localPath, target) && !QFile::copy(localPath, target)) {
+        qDebug() << "无法放置图片到 input 目录:" << target;
+        return QString();
+    }
+
+    return QFileInfo(target).fileName();
+}
+
+/**
+ * @brief 同机模式下把内存中的图片数据写入 input 目录
+ * @param encodedData 已编码的图片字节
+ * @param fileName 期望的文件名
+ * @return QString ComfyUI 可识别的文件名，失败返回空
+ */
+QString ComfyApiService::placeLocalInputData(const QByteArray& encodedData, const QString& fileName)
+{
+    QString target = reserveLocalInputPath(fileName);
+    if (target.isEmpty()) return QString();
+
+    QSaveFile file(target);
+    if (!file.open(QIODevice::WriteOnly) || file.write(encodedData) != encodedData.size() || !file.commit()) {
+        qDebug() << "无法写入图片到 input 目录:" << target;
+        return QString();
+    }
+
+    return QFileInfo(target).fileName();
+}
+
+/**
+ * @brief 请求 /view 接口
+ * @param filename 图片文件名
+ * @param subfolder 子文件夹路径
+ * @param type 图片类型
+ * @param promptId 提示词ID
+ * @param preview 是否请求压缩预览
+ * @return QNetworkReply* 网络应答对象
+ */
+QNetworkReply* ComfyApiService::requestView(const QString& filename, const QString& subfolder, const QString& type,
+                                            const QString& promptId, bool preview)
 {
     QUrl url(m_apiBaseUrl + "/view");
     QUrlQuery query;
     query.addQueryItem("filename", filename);
     query.addQueryItem("subfolder", subfolder);
     query.addQueryItem("type", type);
+    if (preview) {
+        // ComfyUI 的 /view 支持 preview=格式;质量，服务端重新编码后体积远小于原始 PNG
+        query.addQueryItem("preview", "jpeg;85");
+    }
     url.setQuery(query);
 
     QNetworkRequest request(url);
@@ -236,8 +440,42 @@ void ComfyApiService::getImage(const QString& filename, const QString& subfolder
 
     reply->setProperty("promptId", promptId);
     reply->setProperty("filename", filename);
+    reply->setProperty("subfolder", subfolder);
+    reply->setProperty("type", type);
 
-    connect(reply, &QNetworkReply::finished, this, &ComfyApiService::onImageDownloadFinished);
+    return reply;
+}
+
+/**
+ * @brief 处理预览图下载完成
+ */
+void ComfyApiService::onImagePreviewFinished()
+{
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    QString promptId = reply->property("promptId").toString();
+    QString filename = reply->property("filename").toString();
+
+    if (reply->error() == QNetworkReply::NoError) {
+        QPixmap pixmap;
+        if (pixmap.loadFromData(reply->readAll())) {
+            qDebug() << "预览图下载成功:" << filename;
+            emit imagePreviewReceived(promptId, filename, pixmap);
+        } else {
+            qDebug() << "预览图解码失败，直接下载原图";
+        }
+    } else {
+        qDebug() << "预览图下载失败:" << reply->errorString();
+    }
+
+    QNetworkReply* fullReply = requestView(filename,
+                                           reply->property("subfolder").toString(),
+                                           reply->property("type").toString(),
+                                           promptId, false);
+    connect(fullReply, &QNetworkReply::finished, this, &ComfyApiService::onImageDownloadFinished);
+
+    reply->deleteLater();
 }
 
 /**
@@ -257,7 +495,7 @@ void ComfyApiService::onImageDownloadFinished()
         if (pixmap.loadFromData(data)) {
             qDebug() << "图片下载成功:" << filename;
 
-            emit imageReceived(promptId, filename, pixmap);
+            emit imageReceived(promptId, filename, pixmap, data);
         } else {
             qDebug() << "图片数据损坏";
         }
@@ -270,13 +508,54 @@ void ComfyApiService::onImageDownloadFinished()
 /**
  * @brief 上传图片到服务器
  * @param localPath 本地图片路径
+ * @param policy 工作流的缩放策略
  */
-void ComfyApiService::uploadImage(const QString& localPath)
+void ComfyApiService::uploadImage(const QString& localPath, const UploadResizePolicy& policy)
 {
+    if (policy.mode == UploadResizePolicy::Mode::None) {
+        uploadFile(localPath);
+        return;
+    }
+
+    QPointer<ComfyApiService> self(this);
+
+    QThreadPool::globalInstance()->start([self, localPath, policy](){
+        PreparedUpload prepared = ImagePreprocessor::prepareFile(localPath, policy);
+
+        QMetaObject::invokeMethod(qApp, [self, localPath, prepared](){
+            if (!self) return;
+
+            if (!prepared.ok || prepared.unchanged) {
+                // 无需处理或预处理失败时按原文件上传，由服务端兜底
+                self->uploadFile(localPath);
+            } else {
+                self->uploadImage(prepared.data, prepared.fileName, prepared.mimeType);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief 按原文件流式上传
+ * @param localPath 本地图片路径
+ */
+void ComfyApiService::uploadFile(const QString& localPath)
+{
+    if (!m_localComfyDir.isEmpty()) {
+        QString serverName = placeLocalInput(localPath);
+        if (!serverName.isEmpty()) {
+            qDebug() << "图片已直接放入 input 目录:" << serverName;
+            notifyUploaded(serverName);
+            return;
+        }
+        qDebug() << "本地放置失败，回退到 HTTP 上传";
+    }
+
     QFile* file = new QFile(localPath);
     if (!file->open(QIODevice::ReadOnly)) {
         qDebug() << "无法打开本地图片:" << localPath;
         delete file;
+        emit uploadFailed(QString("无法打开本地图片: %1").arg(localPath));
         return;
     }
 
@@ -285,7 +564,7 @@ void ComfyApiService::uploadImage(const QString& localPath)
     QHttpPart imagePart;
     QString fileName = QFileInfo(localPath).fileName();
 
-    imagePart.setHeader(QNetworkRequest::ContentTypeHeader, QVariant("image/png"));
+    imagePart.setHeader(QNetworkRequest::ContentTypeHeader, QVariant(ImagePreprocessor::mimeTypeForFile(localPath)));
     imagePart.setHeader(QNetworkRequest::ContentDispositionHeader,
                         QVariant(QString("form-data; name=\"image\"; filename=\"%1\"").arg(fileName)));
 
@@ -294,11 +573,80 @@ void ComfyApiService::uploadImage(const QString& localPath)
 
     multiPart->append(imagePart);
 
+    qDebug() << "正在上传图片:" << localPath;
+    postUpload(multiPart);
+}
+
+/**
+ * @brief 上传已编码的图片数据
+ * @param encodedData 已编码的图片字节
+ * @param fileName 服务器端使用的文件名
+ * @param mimeType 图片MIME类型
+ */
+void ComfyApiService::uploadImage(const QByteArray& encodedData, const QString& fileName, const QString& mimeType)
+{
+    if (!m_localComfyDir.isEmpty()) {
+        QString serverName = placeLocalInputData(encodedData, fileName);
+        if (!serverName.isEmpty()) {
+            qDebug() << "图片数据已直接写入 input 目录:" << serverName;
+            notifyUploaded(serverName);
+            return;
+        }
+        qDebug() << "本地写入失败，回退到 HTTP 上传";
+    }
+
+    QHttpMultiPart *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
+
+    QHttpPart imagePart;
+    imagePart.setHeader(QNetworkRequest::ContentTypeHeader, QVariant(mimeType));
+    imagePart.setHeader(QNetworkRequest::ContentDispositionHeader,
+                        QVariant(QString("form-data; name=\"image\"; filename=\"%1\"").arg(fileName)));
+    imagePart.setBody(encodedData);
+
+    multiPart->append(imagePart);
+
+    qDebug() << "正在上传内存图片:" << fileName << encodedData.size() << "字节";
+    postUpload(multiPart);
+}
+
+/**
+ * @brief 上传内存中的图片
+ * @param image 图片数据
+ * @param fileName 服务器端使用的文件名
+ * @param policy 工作流的缩放策略
+ *
+ * 缩放与编码在线程池中完成，编码结果回到本对象所在线程后再发起上传。
+ */
+void ComfyApiService::uploadImage(const QImage& image, const QString& fileName, const UploadResizePolicy& policy)
+{
+    QPointer<ComfyApiService> self(this);
+
+    QThreadPool::globalInstance()->start([self, image, fileName, policy](){
+        PreparedUpload prepared = ImagePreprocessor::prepareImage(image, fileName, policy);
+
+        // 本对象可能在编码期间被删除，投递到应用对象，回到 GUI 线程后再检查
+        QMetaObject::invokeMethod(qApp, [self, prepared, fileName](){
+            if (!self) return;
+
+            if (!prepared.ok) {
+                qDebug() << "内存图片编码失败:" << fileName;
+                emit self->uploadFailed(QString("图片编码失败: %1").arg(fileName));
+                return;
+            }
+            self->uploadImage(prepared.data, prepared.fileName, prepared.mimeType);
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief 发送 multipart 上传请求
+ * @param multiPart 已组装好的表单，所有权转交给应答对象
+ */
+void ComfyApiService::postUpload(QHttpMultiPart* multiPart)
+{
     QUrl url(m_apiBaseUrl + "/upload/image");
     QNetworkRequest request(url);
 
-    qDebug() << "正在上传图片:" << localPath;
-
     QNetworkReply* reply = m_networkManager->post(request, multiPart);
     multiPart->setParent(reply);
 
@@ -319,7 +667,21 @@ void ComfyApiService::uploadImage(const QString& localPath)
             emit imageUploaded(serverName);
         } else {
             qDebug() << "上传失败:" << reply->errorString();
+            emit uploadFailed(reply->errorString());
         }
         reply->deleteLater();
     });
 }
+
+/**
+ * @brief 以异步方式发出上传成功信号
+ * @param serverName 服务器文件名
+ *
+ * 同机直连时没有网络往返，仍然排队发出，保持与 HTTP 上传一致的异步语义。
+ */
+void ComfyApiService::notifyUploaded(const QString& serverName)
+{
+    QMetaObject::invokeMethod(this, [this, serverName](){
+        emit imageUploaded(serverName);
+    }, Qt::QueuedConnection);
+}
@@ -14,10 +14,12 @@
 
 #include <QObject>
 #include <QPixmap>
+#include <QImage>
 #include <QJsonObject>
 #include <QNetworkReply>
 #include <QUuid>
 #include <QHttpMultiPart>
+#include "../Model/WorkflowTypes.h"
 
 // 前向声明
 class QNetworkAccessManager;
@@ -52,6 +54,27 @@ public:
      */
     void connectToHost(const QString& baseUrl);
 
+    /**
+     * @brief 设置同机直连目录
+     * @param comfyDir ComfyUI 根目录（包含 input/output），为空表示关闭直连
+     *
+     * 开启后上传改为直接把文件硬链接/复制到 input 目录，结果直接读取 output 目录中的文件，
+     * 失败时回退到 HTTP。
+     */
+    void setLocalComfyDir(const QString& comfyDir);
+
+    /**
+     * @brief 获取当前连接的服务器地址
+     * @return QString 规范化后的 API 基础URL
+     */
+    QString baseUrl() const { return m_apiBaseUrl; }
+
+    /**
+     * @brief 获取最近提交的任务ID
+     * @return QString 任务ID
+     */
+    QString currentPromptId() const { return m_currentPromptId; }
+
     /**
      * @brief 发送提示词生成任务
      * @param workflow 工作流JSON对象
@@ -64,14 +87,38 @@ public:
      * @param subfolder 子文件夹路径
      * @param type 图片类型
      * @param promptId 提示词ID
+     *
+     * 先下载服务器压缩过的 JPEG 预览图（imagePreviewReceived），
+     * 随后在后台继续下载原图（imageReceived）。
      */
     void getImage(const QString& filename, const QString& subfolder, const QString& type, const QString& promptId);
 
     /**
      * @brief 上传图片到服务器
      * @param localPath 本地图片路径
+     * @param policy 工作流的缩放策略，需要缩放时先在工作线程缩小并重新编码
      */
-    void uploadImage(const QString& localPath);
+    void uploadImage(const QString& localPath, const UploadResizePolicy& policy = UploadResizePolicy());
+
+    /**
+     * @brief 上传已编码的图片数据
+     * @param encodedData 已编码的图片字节
+     * @param fileName 服务器端使用的文件名
+     * @param mimeType 图片MIME类型
+     *
+     * 直接作为 multipart 的 body 发送，不经过临时文件。
+     */
+    void uploadImage(const QByteArray& encodedData, const QString& fileName, const QString& mimeType = "image/png");
+
+    /**
+     * @brief 上传内存中的图片（如剪贴板图片、已生成的结果）
+     * @param image 图片数据
+     * @param fileName 服务器端使用的文件名
+     * @param policy 工作流的缩放策略，不缩放时按无损 PNG 编码
+     *
+     * 缩放与编码在工作线程完成，不阻塞界面。
+     */
+    void uploadImage(const QImage& image, const QString& fileName, const UploadResizePolicy& policy = UploadResizePolicy());
 
 signals:
     /**
@@ -99,13 +146,44 @@ signals:
 
     void promptQueued(const QString& promptId);
 
+    /**
+     * @brief 服务器开始执行任务信号
+     * @param promptId 提示词ID
+     */
+    void executionStarted(const QString& promptId);
+
+    /**
+     * @brief 任务输出节点执行完毕信号
+     * @param promptId 提示词ID
+     *
+     * 在开始下载结果之前发出，用于区分执行耗时与下载耗时
+     */
+    void promptExecuted(const QString& promptId);
+
+    /**
+     * @brief 任务执行失败或被中断信号
+     * @param promptId 提示词ID
+     * @param msg 服务器给出的错误信息，中断时为空
+     */
+    void executionFailed(const QString& promptId, const QString& msg);
+
     /**
      * @brief 图片下载完成信号
      * @param promptId 提示词ID
      * @param filename 文件名
      * @param img 图片数据
+     * @param data 图片文件原始字节，用于原样落盘。同机模式下引用结果文件的内存映射，
+     *             只在槽函数执行期间有效，需要延后或跨线程使用时先复制
      */
-    void imageReceived(const QString& promptId, const QString& filename, const QPixmap& img);
+    void imageReceived(const QString& promptId, const QString& filename, const QPixmap& img, const QByteArray& data);
+
+    /**
+     * @brief 预览图下载完成信号
+     * @param promptId 提示词ID
+     * @param filename 文件名
+     * @param img 压缩后的预览图（原图仍在后台下载）
+     */
+    void imagePreviewReceived(const QString& promptId, const QString& filename, const QPixmap& img);
 
     /**
      * @brief 图片上传成功信号
@@ -113,6 +191,14 @@ signals:
      */
     void imageUploaded(const QString& serverFileName);
 
+    /**
+     * @brief 图片上传失败信号
+     * @param reason 失败原因
+     *
+     * 预处理编码、读取本地文件或 HTTP 上传任一环节失败时发出，等待上传结果的一方据此解除锁定
+     */
+    void uploadFailed(const QString& reason);
+
     /**
      * @brief 流式文字接收信号
      * @param token 接收到的文本
@@ -137,10 +223,81 @@ private slots:
      */
     void onImageDownloadFinished();
 
+    /**
+     * @brief 处理预览图下载完成
+     *
+     * 无论预览是否成功，都会接着请求原图。
+     */
+    void onImagePreviewFinished();
+
+private:
+    /**
+     * @brief 同机模式下把本地文件放进 ComfyUI 的 input 目录
+     * @param localPath 本地图片路径
+     * @return QString ComfyUI 可识别的文件名，失败返回空
+     */
+    QString placeLocalInput(const QString& localPath);
+
+    /**
+     * @brief 同机模式下把内存中的图片数据写入 input 目录
+     * @param encodedData 已编码的图片字节
+     * @param fileName 期望的文件名
+     * @return QString ComfyUI 可识别的文件名，失败返回空
+     */
+    QString placeLocalInputData(const QByteArray& encodedData, const QString& fileName);
+
+    /**
+     * @brief 在 input 目录中为文件分配一个不冲突的文件名
+     * @param fileName 期望的文件名
+     * @return QString 可用的完整路径，input 目录不存在时返回空
+     */
+    QString reserveLocalInputPath(const QString& fileName);
+
+    /**
+     * @brief 按原文件流式上传
+     * @param localPath 本地图片路径
+     */
+    void uploadFile(const QString& localPath);
+
+    /**
+     * @brief 发送 multipart 上传请求
+     * @param multiPart 已组装好的表单，所有权转交给应答对象
+     */
+    void postUpload(QHttpMultiPart* multiPart);
+
+    /**
+     * @brief 以异步方式发出上传成功信号
+     * @param serverName 服务器文件名
+     */
+    void notifyUploaded(const QString& serverName);
+
+    /**
+     * @brief 同机模式下直接从输出目录读取结果
+     * @param filename 图片文件名
+     * @param subfolder 子文件夹路径
+     * @param type 图片类型（output/temp）
+     * @param promptId 提示词ID
+     * @return bool 是否读取成功
+     */
+    bool loadLocalOutput(const QString& filename, const QString& subfolder, const QString& type, const QString& promptId);
+
+    /**
+     * @brief 请求 /view 接口
+     * @param filename 图片文件名
+     * @param subfolder 子文件夹路径
+     * @param type 图片类型
+     * @param promptId 提示词ID
+     * @param preview 是否请求压缩预览
+     * @return QNetworkReply* 网络应答对象
+     */
+    QNetworkReply* requestView(const QString& filename, const QString& subfolder, const QString& type,
+                               const QString& promptId, bool preview);
+
 private:
     QNetworkAccessManager* m_networkManager; ///< HTTP网络管理器
     QWebSocket* m_webSocket; ///< WebSocket连接
     QString m_apiBaseUrl; ///< API基础URL
     QString m_currentPromptId; ///< 当前任务ID，用于匹配
     QString m_clientId; ///< 客户端ID
+    QString m_localComfyDir; ///< 同机直连的 ComfyUI 根目录，为空表示走 HTTP
 };
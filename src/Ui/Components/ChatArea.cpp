@@ -10,9 +10,35 @@
  */
 
 #include "ChatArea.h"
-#include "ChatBubble.h"
+#include "ChatItemDelegate.h"
+#include "ImageViewer.h"
+#include "LoadingAnimation.h"
+#include "../../Core/ImageLoader.h"
+#include <QVBoxLayout>
+#include <QListView>
 #include <QScrollBar>
+#include <QMouseEvent>
+#include <QMenu>
 #include <QTimer>
+#include <QClipboard>
+#include <QApplication>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QFileInfo>
+
+/// 实时结果在条目中保留的最大边长（与气泡最大显示尺寸一致）
+static const QSize kDisplayBound(512, 512);
+
+/**
+ * @brief 把图片缩到显示尺寸以内
+ * @param img 原图
+ * @return QPixmap 不超过气泡显示尺寸的图片
+ */
+static QPixmap displayCopy(const QPixmap& img)
+{
+    if (img.width() <= kDisplayBound.width() && img.height() <= kDisplayBound.height()) return img;
+    return img.scaled(kDisplayBound, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
 
 /**
  * @brief 构造函数
@@ -29,91 +55,189 @@ void ChatArea::setupUi()
     mainLayout->setContentsMargins(0, 0, 0, 0);
     mainLayout->setSpacing(0);
 
-    m_scrollArea = new QScrollArea(this);
-    m_scrollArea->setWidgetResizable(true);
-    m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_scrollArea->setFrameShape(QFrame::NoFrame);
+    m_model = new MessageModel(this);
+
+    m_view = new QListView(this);
+    m_view->setModel(m_model);
+    m_view->setFrameShape(QFrame::NoFrame);
+    m_view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_view->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_view->verticalScrollBar()->setSingleStep(20);
+    m_view->setSelectionMode(QAbstractItemView::NoSelection);
+    m_view->setFocusPolicy(Qt::NoFocus);
+    m_view->setResizeMode(QListView::Adjust);
+    m_view->setUniformItemSizes(false);
+    m_view->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_view->setMouseTracking(true);
+    m_view->viewport()->installEventFilter(this);
 
-    m_scrollArea->setStyleSheet(
-        "QScrollArea { background: #343541; border: none; }"
+    m_view->setStyleSheet(
+        "QListView { background: #343541; border: none; }"
         "QScrollBar:vertical { border: none; background: #343541; width: 10px; margin: 0px; }"
         "QScrollBar::handle:vertical { background: #565869; min-height: 20px; border-radius: 5px; }"
         "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical { height: 0px; }"
         "QScrollBar::add-page:vertical, QScrollBar::sub-page:vertical { background: none; }"
         );
 
-    m_scrollContent = new QWidget();
-    m_scrollContent->setStyleSheet("background-color: transparent;");
+    m_delegate = new ChatItemDelegate(m_view);
+    m_view->setItemDelegate(m_delegate);
+
+    // 所有加载占位共用全局动画，换帧时只重绘这些行
+    connect(&LoadingAnimation::instance(), &LoadingAnimation::frameChanged, this, [this](){
+        for (int key : std::as_const(m_loadingKeys)) {
+            int row = m_model->rowForKey(key);
+            if (row >= 0) m_view->update(m_model->index(row));
+        }
+    });
+
+    mainLayout->addWidget(m_view);
+
+    m_streamFlushTimer = new QTimer(this);
+    m_streamFlushTimer->setSingleShot(true);
+    m_streamFlushTimer->setInterval(16);
+    connect(m_streamFlushTimer, &QTimer::timeout, this, &ChatArea::flushStreamText);
 
-    m_contentLayout = new QVBoxLayout(m_scrollContent);
-    m_contentLayout->setContentsMargins(20, 20, 20, 20);
-    m_contentLayout->setSpacing(20);
-    m_contentLayout->addStretch();
+    QScrollBar* bar = m_view->verticalScrollBar();
+    connect(bar, &QScrollBar::valueChanged, this, &ChatArea::onScrollValueChanged);
+
+    // 顶部插入历史后内容高度变化，按插入前到底部的距离恢复位置
+    connect(bar, &QScrollBar::rangeChanged, this, [this, bar](int, int max){
+        if (m_anchorFromBottom < 0) return;
+        bar->setValue(max - m_anchorFromBottom);
+        m_anchorFromBottom = -1;
+    });
 
-    m_scrollArea->setWidget(m_scrollContent);
-    mainLayout->addWidget(m_scrollArea);
+    connect(m_view, &QListView::customContextMenuRequested, this, &ChatArea::showContextMenu);
 }
 
 void ChatArea::addUserMessage(const QString& text)
 {
-    ChatBubble* bubble = new ChatBubble(ChatRole::User, text, m_scrollContent);
-
-    m_contentLayout->insertWidget(m_contentLayout->count() - 1, bubble);
+    ChatItem item;
+    item.role = MessageRole::User;
+    item.text = text;
+    m_model->append(item);
 
     scrollToBottom();
 }
 
-ChatBubble* ChatArea::addLoadingBubble()
+int ChatArea::addLoadingItem()
 {
-    ChatBubble* bubble = new ChatBubble(ChatRole::AI, "", m_scrollContent);
+    ChatItem item;
+    item.role = MessageRole::AI;
+    item.kind = ChatItem::Kind::Loading;
 
-    connect(bubble, &ChatBubble::upscaleRequested, this, &ChatArea::upscaleRequested);
+    int key = m_model->append(item);
+    m_loadingKeys.insert(key);
+    updateLoadingAnimation();
 
-    m_contentLayout->insertWidget(m_contentLayout->count() - 1, bubble);
     scrollToBottom();
-
-    return bubble;
+    return key;
 }
 
-void ChatArea::addAiImage(const QPixmap& img)
+void ChatArea::addAiImage(const QPixmap& img, const QString& localPath)
 {
-    ChatBubble* bubble = new ChatBubble(ChatRole::AI, img, m_scrollContent);
-    connect(bubble, &ChatBubble::upscaleRequested, this, &ChatArea::upscaleRequested);
-    m_contentLayout->insertWidget(m_contentLayout->count() - 1, bubble);
+    ChatItem item;
+    item.role = MessageRole::AI;
+    item.kind = ChatItem::Kind::Image;
+    item.imagePath = localPath;
+    item.image = displayCopy(img);
+    m_model->append(item);
+
     scrollToBottom();
 }
 
+void ChatArea::updatePreview(int key, const QPixmap& img, const QString& serverFileName)
+{
+    updateItem(key, [&](ChatItem& item) {
+        item.kind = ChatItem::Kind::Image;
+        item.image = displayCopy(img);
+        item.serverFileName = serverFileName;
+        item.isPreview = true;
+    });
+}
+
+void ChatArea::updateImage(int key, const QPixmap& img, const QString& serverFileName, const QString& localPath)
+{
+    updateItem(key, [&](ChatItem& item) {
+        item.kind = ChatItem::Kind::Image;
+        item.image = displayCopy(img);
+        item.imagePath = localPath;
+        item.serverFileName = serverFileName;
+        item.isPreview = false;
+    });
+}
+
+void ChatArea::removeLoadingItem(int key)
+{
+    if (!m_loadingKeys.remove(key)) return;
+
+    m_model->remove(key);
+    updateLoadingAnimation();
+}
+
+void ChatArea::updateItem(int key, const std::function<void(ChatItem&)>& change)
+{
+    if (!m_model->update(key, change)) return;
+
+    if (m_loadingKeys.remove(key)) updateLoadingAnimation();
+
+    m_delegate->refresh(m_model->index(m_model->rowForKey(key)));
+}
+
+void ChatArea::updateLoadingAnimation()
+{
+    if (m_loadingKeys.isEmpty()) {
+        LoadingAnimation::instance().unsubscribe(this);
+    } else {
+        LoadingAnimation::instance().subscribe(this);
+    }
+}
+
 /**
  * @brief 滚动到底部
  */
 void ChatArea::scrollToBottom()
 {
+    // 等视图完成延迟布局后再滚动
     QTimer::singleShot(10, this, [=](){
-        QScrollBar* bar = m_scrollArea->verticalScrollBar();
-        bar->setValue(bar->maximum());
+        m_view->scrollToBottom();
     });
 }
 
-void ChatArea::clear()
+void ChatArea::scrollToMessage(int messageId)
 {
-    while (m_contentLayout->count() > 1) {
-        QLayoutItem *item = m_contentLayout->takeAt(0);
+    // 排在 appendHistory 的滚动到底部之后执行
+    QTimer::singleShot(10, this, [this, messageId](){
+        int row = m_model->rowForMessage(messageId);
+        if (row < 0) return;
 
-        if (item->widget()) {
-            delete item->widget();
-        }
-        delete item;
-    }
+        QModelIndex index = m_model->index(row);
+        m_view->selectionModel()->select(index, QItemSelectionModel::ClearAndSelect);
+        m_view->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    });
+}
 
-    m_currentSessionId = -1;
-    m_currentStreamBubble = nullptr;
+void ChatArea::clear()
+{
+    m_model->clear();
+    m_delegate->reset();
+    m_selectionKey = -1;
+    m_selecting = false;
+    m_loadingKeys.clear();
+    updateLoadingAnimation();
 
-    this->update();
+    m_currentSessionId = -1;
+    m_streamKey = -1;
+    m_pendingStreamText.clear();
+    m_streamFlushTimer->stop();
+    m_hasMoreHistory = false;
+    m_historyRequestPending = false;
+    m_anchorFromBottom = -1;
 }
 
 void ChatArea::handleStreamToken(const QString& token, bool finished)
 {
-    if (finished && token.isEmpty() && !m_currentStreamBubble) {
+    if (finished && token.isEmpty() && m_streamKey == -1 && m_pendingStreamText.isEmpty()) {
         return;
     }
 
@@ -121,27 +245,54 @@ void ChatArea::handleStreamToken(const QString& token, bool finished)
         return;
     }
 
-    if (!m_currentStreamBubble) {
-        m_currentStreamBubble = new ChatBubble(ChatRole::AI, token, m_scrollContent);
-        m_contentLayout->insertWidget(m_contentLayout->count() - 1, m_currentStreamBubble);
+    m_pendingStreamText += token;
+
+    if (finished) {
+        flushStreamText();
+        m_streamKey = -1;
+        return;
     }
-    else {
-        if (!token.isEmpty()) {
-            m_currentStreamBubble->appendText(token);
-        }
+
+    if (!m_streamFlushTimer->isActive()) {
+        m_streamFlushTimer->start();
     }
+}
 
-    QTimer::singleShot(10, this, [this](){ scrollToBottom(); });
+void ChatArea::flushStreamText()
+{
+    m_streamFlushTimer->stop();
 
-    if (finished) {
-        m_currentStreamBubble = nullptr;
+    if (m_pendingStreamText.isEmpty()) {
+        return;
+    }
+
+    if (m_streamKey == -1) {
+        ChatItem item;
+        item.role = MessageRole::AI;
+        item.text = m_pendingStreamText;
+        m_streamKey = m_model->append(item);
     }
+    else {
+        // 绘制代理缓存的文档只追加新增部分，不会重排整段文本
+        const QString delta = m_pendingStreamText;
+        updateItem(m_streamKey, [&delta](ChatItem& item) { item.text += delta; });
+    }
+
+    m_pendingStreamText.clear();
+
+    scrollToBottom();
 }
 
-void ChatArea::addUserImage(const QPixmap& img)
+void ChatArea::addUserImage(const QPixmap& img, const QString& localPath)
 {
-    ChatBubble* bubble = new ChatBubble(ChatRole::User, img, m_scrollContent);
-    m_contentLayout->insertWidget(m_contentLayout->count() - 1, bubble);
+    ChatItem item;
+    item.role = MessageRole::User;
+    item.kind = ChatItem::Kind::Image;
+    item.imagePath = localPath;
+    item.image = displayCopy(img);
+    if (localPath.isEmpty()) item.original = img;
+    m_model->append(item);
+
     scrollToBottom();
 }
 
@@ -151,7 +302,223 @@ void ChatArea::addUserImage(const QPixmap& img)
  */
 void ChatArea::addAiMessage(const QString& text)
 {
-    ChatBubble* bubble = new ChatBubble(ChatRole::AI, text, m_scrollContent);
-    m_contentLayout->insertWidget(m_contentLayout->count() - 1, bubble);
+    ChatItem item;
+    item.role = MessageRole::AI;
+    item.text = text;
+    m_model->append(item);
+
+    scrollToBottom();
+}
+
+void ChatArea::appendHistory(const QVector<MessageData>& messages)
+{
+    QVector<ChatItem> items;
+    items.reserve(messages.size());
+    for (const auto& msg : messages) items.append(ChatItem::fromMessage(msg));
+
+    m_model->append(items);
     scrollToBottom();
 }
+
+void ChatArea::prependHistory(const QVector<MessageData>& messages)
+{
+    if (messages.isEmpty()) return;
+
+    QScrollBar* bar = m_view->verticalScrollBar();
+    m_anchorFromBottom = bar->maximum() - bar->value();
+
+    QVector<ChatItem> items;
+    items.reserve(messages.size());
+    for (const auto& msg : messages) items.append(ChatItem::fromMessage(msg));
+
+    m_model->prepend(items);
+}
+
+void ChatArea::setHasMoreHistory(bool hasMore)
+{
+    m_hasMoreHistory = hasMore;
+    m_historyRequestPending = false;
+
+    // 内容不足一屏时不会出现滚动，布局完成后主动检查一次
+    QTimer::singleShot(50, this, [this](){
+        QScrollBar* bar = m_view->verticalScrollBar();
+        if (bar->maximum() == 0) onScrollValueChanged(0);
+    });
+}
+
+QModelIndex ChatArea::bubbleAt(const QPoint& pos) const
+{
+    QModelIndex index = m_view->indexAt(pos);
+    if (!index.isValid()) return QModelIndex();
+
+    QRect bubble = m_delegate->bubbleRect(m_view->visualRect(index), index);
+    return bubble.contains(pos) ? index : QModelIndex();
+}
+
+bool ChatArea::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched != m_view->viewport()) return QWidget::eventFilter(watched, event);
+
+    if (event->type() == QEvent::MouseMove) {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        const QPoint pos = mouseEvent->position().toPoint();
+
+        // 拖动选择文本，移出气泡时选区停在最近的位置
+        int row = m_selecting ? m_model->rowForKey(m_selectionKey) : -1;
+        if (row >= 0 && (mouseEvent->buttons() & Qt::LeftButton)) {
+            QModelIndex index = m_model->index(row);
+            int position = m_delegate->textPositionAt(m_view->visualRect(index), index, pos);
+            if (position >= 0) setTextSelection(m_selectionKey, m_selectionAnchor, position);
+            return true;
+        }
+
+        const ChatItem* item = m_model->itemAt(bubbleAt(pos));
+        Qt::CursorShape shape = Qt::ArrowCursor;
+        if (item && item->kind == ChatItem::Kind::Image) shape = Qt::PointingHandCursor;
+        else if (item && item->kind == ChatItem::Kind::Text) shape = Qt::IBeamCursor;
+        m_view->viewport()->setCursor(shape);
+    }
+    else if (event->type() == QEvent::MouseButtonRelease) {
+        m_selecting = false;
+    }
+    else if (event->type() == QEvent::MouseButtonPress) {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() == Qt::LeftButton) {
+            const QPoint pos = mouseEvent->position().toPoint();
+            QModelIndex hit = bubbleAt(pos);
+            const ChatItem* item = m_model->itemAt(hit);
+
+            if (item && item->kind == ChatItem::Kind::Text) {
+                int position = m_delegate->textPositionAt(m_view->visualRect(hit), hit, pos);
+                setTextSelection(item->key, position, position);
+                m_selecting = true;
+                return true;
+            }
+            setTextSelection(-1, 0, 0);
+
+            if (item && item->kind == ChatItem::Kind::Image) {
+                // 不等原图解码，查看器先显示预览，原图在后台切成瓦片
+                const QString path = QFileInfo::exists(item->imagePath) ? item->imagePath : QString();
+                const QPixmap preview = item->original.isNull() ? item->image : item->original;
+                if (path.isEmpty() && preview.isNull()) return true;
+
+                ImageViewer* viewer = new ImageViewer(path, preview, this);
+                viewer->exec();
+                delete viewer;
+                return true;
+            }
+        }
+    }
+
+    return QWidget::eventFilter(watched, event);
+}
+
+void ChatArea::setTextSelection(int key, int anchor, int position)
+{
+    const int previousKey = m_selectionKey;
+
+    m_selectionKey = key;
+    m_selectionAnchor = anchor;
+    m_selectionPosition = position;
+    m_delegate->setTextSelection(key, anchor, position);
+
+    for (int changedKey : { previousKey, key }) {
+        int row = changedKey == -1 ? -1 : m_model->rowForKey(changedKey);
+        if (row >= 0) m_view->update(m_model->index(row));
+    }
+}
+
+void ChatArea::showContextMenu(const QPoint& pos)
+{
+    const ChatItem* hit = m_model->itemAt(bubbleAt(pos));
+    if (!hit || hit->kind == ChatItem::Kind::Loading) return;
+
+    // 菜单显示期间模型可能变化，复制一份条目数据
+    const ChatItem item = *hit;
+
+    QMenu menu;
+    menu.setStyleSheet(
+        "QMenu { background: #2D2D2D; color: white; border: 1px solid #555; padding: 5px; }"
+        "QMenu::item { padding: 5px 20px; }"
+        "QMenu::item:selected { background-color: #40414F; }"
+        );
+
+    if (item.kind == ChatItem::Kind::Text) {
+        QAction* actCopyAll = menu.addAction("📋 复制全部内容");
+        connect(actCopyAll, &QAction::triggered, this, [item](){
+            QApplication::clipboard()->setText(item.text);
+        });
+
+        // 纯文本文档的字符位置与原文下标一一对应
+        if (item.key == m_selectionKey && m_selectionAnchor != m_selectionPosition) {
+            const int start = qMin(m_selectionAnchor, m_selectionPosition);
+            const QString selected = item.text.mid(start, qAbs(m_selectionPosition - m_selectionAnchor));
+
+            QAction* actCopySelected = menu.addAction("✂️ 复制选中内容");
+            connect(actCopySelected, &QAction::triggered, this, [selected](){
+                QApplication::clipboard()->setText(selected);
+            });
+        }
+    }
+    else if (item.isPreview) {
+        QAction* actPending = menu.addAction("⏳ 原图下载中...");
+        actPending->setEnabled(false);
+    }
+    else {
+        QAction* actCopy = menu.addAction("❐ 复制图片");
+        connect(actCopy, &QAction::triggered, this, [this, item](){
+            withOriginalImage(item, [](const QPixmap& img) { QApplication::clipboard()->setPixmap(img); });
+        });
+
+        QAction* actSave = menu.addAction("💾 另存为...");
+        connect(actSave, &QAction::triggered, this, [this, item](){ saveImage(item); });
+
+        if (item.role == MessageRole::AI) {
+            menu.addSeparator();
+
+            QAction* actUpscale = menu.addAction("✨ 高清修复 (1.5x)");
+            connect(actUpscale, &QAction::triggered, this, [this, item](){
+                withOriginalImage(item, [this, item](const QPixmap& img) {
+                    emit upscaleRequested(item.serverFileName, img);
+                });
+            });
+        }
+    }
+
+    menu.exec(m_view->viewport()->mapToGlobal(pos));
+}
+
+void ChatArea::withOriginalImage(const ChatItem& item, const std::function<void(const QPixmap&)>& action)
+{
+    if (item.imagePath.isEmpty()) {
+        action(item.original.isNull() ? item.image : item.original);
+        return;
+    }
+
+    const QPixmap fallback = item.image;
+    ImageLoader::instance().load(item.imagePath, QSize(), this, ImagePriority::High)
+        .then(this, [action, fallback](const QPixmap& original) {
+            action(original.isNull() ? fallback : original);
+        });
+}
+
+void ChatArea::saveImage(const ChatItem& item)
+{
+    QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::PicturesLocation);
+    QString fileName = QFileDialog::getSaveFileName(this, "保存图片",
+                                                    desktopPath + "/cloudart_gen.png",
+                                                    "Images (*.png *.jpg)");
+    if (fileName.isEmpty()) return;
+
+    withOriginalImage(item, [fileName](const QPixmap& img) { img.save(fileName); });
+}
+
+void ChatArea::onScrollValueChanged(int value)
+{
+    if (!m_hasMoreHistory || m_historyRequestPending) return;
+
+    if (value < 200) {
+        m_historyRequestPending = true;
+        emit olderHistoryRequested();
+    }
+}
@@ -12,17 +12,23 @@
 
 #pragma once
 #include <QWidget>
-#include <QScrollArea>
-#include <QVBoxLayout>
+#include <QSet>
+#include <functional>
+#include "../../Model/DataModels.h"
+#include "../../Model/MessageModel.h"
 
-
-class ChatBubble;
+class QListView;
+class QTimer;
+class ChatItemDelegate;
 
 /**
  * @brief 聊天区域类
  * 
  * 继承自QWidget，管理聊天消息的显示和会话切换。
- * 支持用户文字消息和AI图片消息的添加和显示。
+ * 消息保存在 MessageModel 中，由 QListView 和 ChatItemDelegate 虚拟化显示：
+ * 只有可见行会被绘制，图片在滚动到可见时才异步加载缩略图，
+ * 打开长会话的耗时和内存不随消息数量增长。
+ * 正在更新的条目（加载占位、流式文本）以 key 标识。
  */
 class ChatArea : public QWidget
 {
@@ -60,32 +66,73 @@ public:
     /**
      * @brief 添加AI图片消息
      * @param img AI生成的图片
+     * @param localPath 已保存的本地原图路径，为空时在内存中保留图片
+     */
+    void addAiImage(const QPixmap& img, const QString& localPath = QString());
+
+    /**
+     * @brief 添加加载占位
+     * @return int 占位条目的 key，结果到达后用于 updatePreview/updateImage
+     */
+    int addLoadingItem();
+
+    /**
+     * @brief 用预览图填充加载占位（原图仍在下载）
+     * @param key 占位条目的 key
+     * @param img 压缩后的预览图
+     * @param serverFileName 服务器文件名
+     *
+     * 条目已随会话切换被清除时忽略
      */
-    void addAiImage(const QPixmap& img);
+    void updatePreview(int key, const QPixmap& img, const QString& serverFileName);
 
     /**
-     * @brief 添加加载态气泡
-     * @return ChatBubble* 新创建的加载气泡指针
+     * @brief 用最终结果填充加载占位
+     * @param key 占位条目的 key
+     * @param img 生成的图片
+     * @param serverFileName 服务器文件名
+     * @param localPath 已保存的本地原图路径，为空时在内存中保留图片
      */
-    ChatBubble* addLoadingBubble();
+    void updateImage(int key, const QPixmap& img, const QString& serverFileName, const QString& localPath);
+
+    /**
+     * @brief 移除不会再有结果的加载占位
+     * @param key 占位条目的 key
+     *
+     * 用于上传或执行失败的任务；条目已被填充或已随会话切换被清除时忽略
+     */
+    void removeLoadingItem(int key);
 
     /**
      * @brief 自动滚动到底部
      */
     void scrollToBottom();
 
+    /**
+     * @brief 滚动到指定消息并选中
+     * @param messageId 数据库消息ID
+     *
+     * 用于打开搜索结果，消息需已在当前页中；选中的气泡以强调色描边
+     */
+    void scrollToMessage(int messageId);
+
     /**
      * @brief 处理流式文字
      * @param token 流式文本片段
      * @param finished 是否完成
+     *
+     * 文本片段先进入缓冲区，由定时器每帧至多刷新一次到条目；完成时立即刷新。
      */
     void handleStreamToken(const QString& token, bool finished);
 
     /**
      * @brief 添加用户图片消息
-     * @param img 用户上传的图片
+     * @param img 用户上传的图片（原图）
+     * @param localPath 图片的本地文件路径，为空时（如剪贴板粘贴）在内存中保留原图
+     *
+     * 气泡只显示缩小后的图片，复制、保存和查看使用原图
      */
-    void addUserImage(const QPixmap& img);
+    void addUserImage(const QPixmap& img, const QString& localPath = QString());
 
     /**
      * @brief 直接添加AI文本消息（用于加载历史，无动画）
@@ -93,6 +140,28 @@ public:
      */
     void addAiMessage(const QString& text);
 
+    /**
+     * @brief 在末尾追加一页历史消息（用于会话的最新一页）
+     * @param messages 按时间正序排列的消息
+     */
+    void appendHistory(const QVector<MessageData>& messages);
+
+    /**
+     * @brief 在顶部插入一页更早的历史消息
+     * @param messages 按时间正序排列的消息
+     *
+     * 插入后保持当前可视内容不跳动
+     */
+    void prependHistory(const QVector<MessageData>& messages);
+
+    /**
+     * @brief 设置是否还有更早的历史消息
+     * @param hasMore 是否还有更早的消息
+     *
+     * 调用后解除加载中状态，滚动到顶部附近时可再次发出 olderHistoryRequested
+     */
+    void setHasMoreHistory(bool hasMore);
+
 signals:
     /**
      * @brief 高清修复请求信号
@@ -101,20 +170,101 @@ signals:
      */
     void upscaleRequested(const QString& filename, const QPixmap& img);
 
+    /**
+     * @brief 请求加载更早的历史消息
+     *
+     * 滚动到顶部附近且还有更早的消息时发出，加载完成前不会重复发出
+     */
+    void olderHistoryRequested();
+
+protected:
+    /**
+     * @brief 事件过滤器，处理视口上的点击、文本选择和鼠标形状
+     * @param watched 被监视的对象
+     * @param event 事件
+     * @return bool 是否处理事件
+     */
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private:
     /**
      * @brief 初始化UI布局
      */
     void setupUi();
-    
 
+    /**
+     * @brief 把缓冲的流式文本一次性刷新到条目并滚动到底部
+     */
+    void flushStreamText();
+
+    /**
+     * @brief 修改条目并让视图重新计算行高
+     * @param key 条目 key
+     * @param change 修改函数
+     */
+    void updateItem(int key, const std::function<void(ChatItem&)>& change);
+
+    /**
+     * @brief 查找视口坐标处的气泡
+     * @param pos 视口坐标
+     * @return QModelIndex 气泡所在条目，未命中气泡时为无效索引
+     */
+    QModelIndex bubbleAt(const QPoint& pos) const;
+
+    /**
+     * @brief 更新文本选区并重绘涉及的行
+     * @param key 选区所在条目的 key，-1 表示清除选区
+     * @param anchor 选区起点（字符位置）
+     * @param position 选区终点（字符位置）
+     */
+    void setTextSelection(int key, int anchor, int position);
+
+    /**
+     * @brief 显示条目的右键菜单
+     * @param pos 视口坐标
+     */
+    void showContextMenu(const QPoint& pos);
+
+    /**
+     * @brief 取得条目原图后执行操作
+     * @param item 聊天条目
+     * @param action 接收原图的操作
+     *
+     * 条目有本地路径时在后台读取原图，否则使用内存中保留的原图
+     */
+    void withOriginalImage(const ChatItem& item, const std::function<void(const QPixmap&)>& action);
+
+    /**
+     * @brief 保存条目图片
+     * @param item 聊天条目
+     */
+    void saveImage(const ChatItem& item);
+
+    /**
+     * @brief 加载占位增减后启停加载动画
+     */
+    void updateLoadingAnimation();
+
+    /**
+     * @brief 滚动位置变化处理，接近顶部时请求更早的历史
+     * @param value 滚动条当前值
+     */
+    void onScrollValueChanged(int value);
 
 private:
-    QScrollArea* m_scrollArea = nullptr; ///< 滚动区域组件
-    QWidget* m_scrollContent = nullptr; ///< 滚动内容组件
-    QVBoxLayout* m_contentLayout = nullptr; ///< 内容布局
+    QListView* m_view = nullptr; ///< 虚拟化列表视图
+    MessageModel* m_model = nullptr; ///< 聊天条目模型
+    ChatItemDelegate* m_delegate = nullptr; ///< 条目绘制代理
+    QSet<int> m_loadingKeys; ///< 仍在加载中的条目
     int m_currentSessionId = -1; ///< 当前会话ID，-1表示无选中会话
-    // 【新增】记录当前正在"打字"的气泡指针
-    ChatBubble* m_currentStreamBubble = nullptr;
-
+    int m_streamKey = -1; ///< 正在流式输出的文本条目，-1 表示无
+    QString m_pendingStreamText; ///< 尚未刷新到条目的流式文本
+    QTimer* m_streamFlushTimer = nullptr; ///< 流式文本刷新定时器（约一帧）
+    bool m_hasMoreHistory = false; ///< 是否还有更早的历史消息
+    bool m_historyRequestPending = false; ///< 是否正在等待更早的历史
+    int m_anchorFromBottom = -1; ///< 顶部插入后需恢复的底部距离，-1 表示无需恢复
+    int m_selectionKey = -1; ///< 文本选区所在条目，-1 表示无选区
+    int m_selectionAnchor = 0; ///< 选区起点（字符位置）
+    int m_selectionPosition = 0; ///< 选区终点（字符位置）
+    bool m_selecting = false; ///< 是否正在拖动选择文本
 };
@@ -0,0 +1,352 @@
+/**
+ * @file ChatItemDelegate.cpp
+ * @brief 聊天条目绘制代理实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "ChatItemDelegate.h"
+#include "LoadingAnimation.h"
+#include "ShadowCache.h"
+#include "Theme.h"
+#include "../../Core/ImageLoader.h"
+#include <QListView>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTextCursor>
+#include <QAbstractTextDocumentLayout>
+#include <QtMath>
+
+namespace {
+const int kRowPadding = 10;       ///< 行上下留白（相邻气泡间距为两倍）
+const int kSideMargin = 30;       ///< 气泡到视口左右边缘的距离
+const int kTextPadding = 10;      ///< 文本气泡内边距
+const int kMaxTextWidth = 600;    ///< 文本最大排版宽度
+const int kMaxImageSide = 512;    ///< 图片最大显示边长
+const int kPlaceholderSide = 200; ///< 图片未加载时的占位边长
+}
+
+/**
+ * @brief 构造函数
+ * @param view 所属列表视图
+ */
+ChatItemDelegate::ChatItemDelegate(QListView* view)
+    : QStyledItemDelegate(view)
+    , m_view(view)
+{
+    m_documents.setMaxCost(256);
+}
+
+/**
+ * @brief 清空缓存的文档和图片尺寸
+ */
+void ChatItemDelegate::reset()
+{
+    m_selectionKey = -1;
+    m_documents.clear();
+    m_imageSizes.clear();
+    m_missingImages.clear();
+    m_requests.clear();
+}
+
+/**
+ * @brief 查找视口坐标处的文本位置
+ * @param rowRect 行区域
+ * @param index 条目索引
+ * @param pos 视口坐标
+ * @return int 文本中的字符位置，非文本条目时为 -1
+ *
+ * 纯文本文档中换行各占一个位置，返回值可直接用作 ChatItem::text 的下标
+ */
+int ChatItemDelegate::textPositionAt(const QRect& rowRect, const QModelIndex& index, const QPoint& pos) const
+{
+    const auto* model = static_cast<const MessageModel*>(index.model());
+    const ChatItem* item = model->itemAt(index);
+    if (!item || item->kind != ChatItem::Kind::Text) return -1;
+
+    QTextDocument* doc = document(*item);
+    const QPoint origin = bubbleRect(rowRect, index).topLeft() + QPoint(kTextPadding, kTextPadding);
+    const int position = doc->documentLayout()->hitTest(pos - origin, Qt::FuzzyHit);
+    return qBound(0, position, int(item->text.size()));
+}
+
+/**
+ * @brief 设置文本选区
+ * @param key 选区所在条目的 key，-1 表示无选区
+ * @param anchor 选区起点
+ * @param position 选区终点
+ */
+void ChatItemDelegate::setTextSelection(int key, int anchor, int position)
+{
+    m_selectionKey = key;
+    m_selectionAnchor = anchor;
+    m_selectionPosition = position;
+}
+
+/**
+ * @brief 条目内容变化后重新计算行高
+ * @param index 条目索引
+ */
+void ChatItemDelegate::refresh(const QModelIndex& index)
+{
+    emit sizeHintChanged(index);
+}
+
+/**
+ * @brief 计算条目尺寸
+ * @param option 样式选项
+ * @param index 条目索引
+ * @return QSize 行尺寸
+ */
+QSize ChatItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(option)
+
+    const auto* model = static_cast<const MessageModel*>(index.model());
+    const ChatItem* item = model->itemAt(index);
+    if (!item) return QSize();
+
+    return QSize(m_view->viewport()->width(), bubbleSize(*item).height() + kRowPadding * 2);
+}
+
+/**
+ * @brief 计算气泡在视口中的区域
+ * @param rowRect 行区域
+ * @param index 条目索引
+ * @return QRect 气泡区域
+ */
+QRect ChatItemDelegate::bubbleRect(const QRect& rowRect, const QModelIndex& index) const
+{
+    const auto* model = static_cast<const MessageModel*>(index.model());
+    const ChatItem* item = model->itemAt(index);
+    if (!item) return QRect();
+
+    QSize size = bubbleSize(*item);
+    int x = (item->role == MessageRole::User)
+                ? rowRect.right() - kSideMargin - size.width() + 1
+                : rowRect.left() + kSideMargin;
+    return QRect(QPoint(x, rowRect.top() + kRowPadding), size);
+}
+
+/**
+ * @brief 获取条目当前显示的图片
+ * @param item 聊天条目
+ * @return QPixmap 内存中的图片或已缓存的缩略图
+ */
+QPixmap ChatItemDelegate::displayPixmap(const ChatItem& item) const
+{
+    if (!item.image.isNull()) return item.image;
+    if (item.imagePath.isEmpty()) return QPixmap();
+    return ImageLoader::instance().cachedThumbnail(item.imagePath, ThumbnailTier::Medium);
+}
+
+/**
+ * @brief 气泡内容尺寸
+ * @param item 聊天条目
+ * @return QSize 气泡尺寸
+ */
+QSize ChatItemDelegate::bubbleSize(const ChatItem& item) const
+{
+    switch (item.kind) {
+    case ChatItem::Kind::Text: {
+        QTextDocument* doc = document(item);
+        int width = qCeil(qMin<qreal>(doc->idealWidth(), textWidth())) + 1;
+        int height = qCeil(doc->size().height());
+        return QSize(width + kTextPadding * 2, height + kTextPadding * 2);
+    }
+    case ChatItem::Kind::Image: {
+        if (m_missingImages.contains(item.imagePath) && item.image.isNull()) {
+            return QSize(kPlaceholderSide, 60);
+        }
+
+        QPixmap pix = displayPixmap(item);
+        QSize size = !pix.isNull() ? pix.size() : m_imageSizes.value(item.imagePath);
+        if (size.isEmpty()) return QSize(kPlaceholderSide, kPlaceholderSide);
+        if (size.width() > kMaxImageSide || size.height() > kMaxImageSide) {
+            size.scale(kMaxImageSide, kMaxImageSide, Qt::KeepAspectRatio);
+        }
+        return size;
+    }
+    case ChatItem::Kind::Loading:
+        return QSize(kPlaceholderSide, kPlaceholderSide);
+    }
+    return QSize();
+}
+
+/**
+ * @brief 文本可用宽度
+ * @return int 文本排版宽度
+ */
+int ChatItemDelegate::textWidth() const
+{
+    int available = m_view->viewport()->width() - kSideMargin * 2 - kTextPadding * 2;
+    return qBound(100, available, kMaxTextWidth);
+}
+
+/**
+ * @brief 获取文本条目的排版文档
+ * @param item 聊天条目
+ * @return QTextDocument* 已按当前宽度排版的文档
+ *
+ * 流式输出时文本只会在末尾增长，缓存的文档直接追加新增部分，不重排已有段落
+ */
+QTextDocument* ChatItemDelegate::document(const ChatItem& item) const
+{
+    QTextDocument* doc = m_documents.object(item.key);
+    const int cachedLength = doc ? doc->characterCount() - 1 : -1;
+
+    if (!doc || cachedLength > item.text.size()) {
+        doc = new QTextDocument();
+        doc->setDocumentMargin(0);
+        doc->setDefaultFont(m_view->font());
+        doc->setPlainText(item.text);
+        m_documents.insert(item.key, doc);
+    } else if (cachedLength < item.text.size()) {
+        QTextCursor cursor(doc);
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(item.text.mid(cachedLength));
+    }
+
+    const int width = textWidth();
+    if (!qFuzzyCompare(doc->textWidth(), width)) doc->setTextWidth(width);
+    return doc;
+}
+
+/**
+ * @brief 请求加载缩略图
+ * @param path 原图路径
+ * @param index 等待该图片的条目
+ */
+void ChatItemDelegate::requestThumbnail(const QString& path, const QModelIndex& index)
+{
+    auto it = m_requests.find(path);
+    if (it != m_requests.end()) {
+        it->append(QPersistentModelIndex(index));
+        return;
+    }
+    m_requests.insert(path, { QPersistentModelIndex(index) });
+
+    ImageLoader::instance().loadThumbnail(path, ThumbnailTier::Medium, this)
+        .then(this, [this, path](const QPixmap& pix) {
+            const QList<QPersistentModelIndex> waiting = m_requests.take(path);
+
+            QSize previous = m_imageSizes.value(path);
+            if (pix.isNull()) {
+                m_missingImages.insert(path);
+            } else {
+                m_imageSizes.insert(path, pix.size());
+            }
+
+            // 尺寸与占位一致时只需重绘，否则通知视图重新布局
+            for (const QPersistentModelIndex& idx : waiting) {
+                if (!idx.isValid()) continue;
+                if (!pix.isNull() && previous == pix.size()) {
+                    m_view->update(idx);
+                } else {
+                    emit sizeHintChanged(idx);
+                }
+            }
+        });
+}
+
+/**
+ * @brief 绘制条目
+ * @param painter 绘制器
+ * @param option 样式选项
+ * @param index 条目索引
+ */
+void ChatItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    const auto* model = static_cast<const MessageModel*>(index.model());
+    const ChatItem* item = model->itemAt(index);
+    if (!item) return;
+
+    const QRect rect = bubbleRect(option.rect, index);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
+    QPainterPath shape;
+    shape.addRoundedRect(QRectF(rect).adjusted(0.5, 0.5, -0.5, -0.5), Theme::kBubbleRadius, Theme::kBubbleRadius);
+
+    switch (item->kind) {
+    case ChatItem::Kind::Text: {
+        painter->fillPath(shape, item->role == MessageRole::User ? Theme::kSurfaceUser : Theme::kSurface);
+        if (item->role == MessageRole::AI) {
+            painter->setPen(QPen(Theme::kBorder, 1));
+            painter->drawPath(shape);
+        }
+
+        QTextDocument* doc = document(*item);
+        painter->translate(rect.topLeft() + QPoint(kTextPadding, kTextPadding));
+
+        QAbstractTextDocumentLayout::PaintContext context;
+        context.palette.setColor(QPalette::Text, Theme::kText);
+
+        if (item->key == m_selectionKey && m_selectionAnchor != m_selectionPosition) {
+            const int end = doc->characterCount() - 1;
+
+            QAbstractTextDocumentLayout::Selection selection;
+            selection.cursor = QTextCursor(doc);
+            selection.cursor.setPosition(qMin(m_selectionAnchor, end));
+            selection.cursor.setPosition(qMin(m_selectionPosition, end), QTextCursor::KeepAnchor);
+            selection.format.setBackground(Theme::kAccent);
+            selection.format.setForeground(Theme::kText);
+            context.selections.append(selection);
+        }
+
+        doc->documentLayout()->draw(painter, context);
+        break;
+    }
+    case ChatItem::Kind::Image: {
+        ShadowCache::paint(painter, rect, Theme::kBubbleRadius, Theme::kShadowBlur,
+                           QPoint(0, Theme::kShadowOffsetY), Theme::kShadow);
+
+        QPixmap pix = displayPixmap(*item);
+        if (!pix.isNull()) {
+            painter->save();
+            painter->setClipPath(shape);
+            painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+            painter->drawPixmap(rect, pix);
+            painter->restore();
+        } else {
+            painter->fillPath(shape, Theme::kSurface);
+            if (m_missingImages.contains(item->imagePath)) {
+                painter->setPen(Theme::kTextMissing);
+                painter->drawText(rect, Qt::AlignCenter, "[图片文件已丢失]");
+            } else if (!item->imagePath.isEmpty()) {
+                // 只为真正绘制到的行请求缩略图，滚动到哪里加载到哪里
+                const_cast<ChatItemDelegate*>(this)->requestThumbnail(item->imagePath, index);
+            }
+        }
+
+        painter->setPen(QPen(Theme::kBorder, 2));
+        painter->drawPath(shape);
+        break;
+    }
+    case ChatItem::Kind::Loading: {
+        ShadowCache::paint(painter, rect, Theme::kBubbleRadius, Theme::kShadowBlur,
+                           QPoint(0, Theme::kShadowOffsetY), Theme::kShadow);
+        painter->fillPath(shape, Theme::kSurface);
+        painter->setPen(QPen(Theme::kBorder, 2));
+        painter->drawPath(shape);
+
+        QPixmap frame = LoadingAnimation::instance().currentFrame();
+        if (!frame.isNull()) {
+            QRect frameRect(QPoint(0, 0), LoadingAnimation::frameSize());
+            frameRect.moveCenter(rect.center());
+            painter->drawPixmap(frameRect, frame);
+        }
+        break;
+    }
+    }
+
+    // 搜索结果定位到的条目
+    if (option.state & QStyle::State_Selected) {
+        painter->setPen(QPen(Theme::kAccent, 2));
+        painter->drawPath(shape);
+    }
+
+    painter->restore();
+}
@@ -0,0 +1,140 @@
+/**
+ * @file ChatItemDelegate.h
+ * @brief 聊天条目绘制代理头文件
+ * 
+ * 该文件定义了ChatItemDelegate类，负责在聊天区域的 QListView 中绘制文本气泡、
+ * 图片气泡和加载占位，并计算每行的尺寸。
+ * 
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QStyledItemDelegate>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QPersistentModelIndex>
+#include <QTextDocument>
+#include "../../Model/MessageModel.h"
+
+class QListView;
+
+/**
+ * @brief 聊天条目绘制代理类
+ * 
+ * 只有可见行会被绘制，图片缩略图也只在绘制时才向 ImageLoader 请求，
+ * 加载完成后通过 sizeHintChanged 让视图重新布局。文本行的 QTextDocument 按条目缓存，
+ * 流式输出时只在文档末尾追加新增部分。
+ */
+class ChatItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param view 所属列表视图
+     */
+    explicit ChatItemDelegate(QListView* view);
+
+    /**
+     * @brief 绘制条目
+     * @param painter 绘制器
+     * @param option 样式选项
+     * @param index 条目索引
+     */
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 计算条目尺寸
+     * @param option 样式选项
+     * @param index 条目索引
+     * @return QSize 行尺寸（宽度为视口宽度）
+     */
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 计算气泡在视口中的区域
+     * @param rowRect 行区域
+     * @param index 条目索引
+     * @return QRect 气泡区域，用于点击和右键菜单的命中判断
+     */
+    QRect bubbleRect(const QRect& rowRect, const QModelIndex& index) const;
+
+    /**
+     * @brief 获取条目当前显示的图片
+     * @param item 聊天条目
+     * @return QPixmap 内存中的图片或已缓存的缩略图，尚未加载时为空
+     */
+    QPixmap displayPixmap(const ChatItem& item) const;
+
+    /**
+     * @brief 查找视口坐标处的文本位置
+     * @param rowRect 行区域
+     * @param index 条目索引
+     * @param pos 视口坐标，落在气泡外时取最近的位置
+     * @return int 文本中的字符位置，非文本条目时为 -1
+     */
+    int textPositionAt(const QRect& rowRect, const QModelIndex& index, const QPoint& pos) const;
+
+    /**
+     * @brief 设置文本选区
+     * @param key 选区所在条目的 key，-1 表示无选区
+     * @param anchor 选区起点（字符位置）
+     * @param position 选区终点（字符位置）
+     */
+    void setTextSelection(int key, int anchor, int position);
+
+    /**
+     * @brief 条目内容变化后重新计算行高
+     * @param index 条目索引
+     */
+    void refresh(const QModelIndex& index);
+
+    /**
+     * @brief 清空缓存的文档和图片尺寸
+     */
+    void reset();
+
+private:
+    /**
+     * @brief 气泡内容尺寸
+     * @param item 聊天条目
+     * @return QSize 气泡尺寸（含内边距）
+     */
+    QSize bubbleSize(const ChatItem& item) const;
+
+    /**
+     * @brief 获取文本条目的排版文档
+     * @param item 聊天条目
+     * @return QTextDocument* 已按当前宽度排版的文档
+     */
+    QTextDocument* document(const ChatItem& item) const;
+
+    /**
+     * @brief 文本可用宽度
+     * @return int 文本排版宽度
+     */
+    int textWidth() const;
+
+    /**
+     * @brief 请求加载缩略图
+     * @param path 原图路径
+     * @param index 等待该图片的条目
+     */
+    void requestThumbnail(const QString& path, const QModelIndex& index);
+
+private:
+    QListView* m_view = nullptr;                                  ///< 所属列表视图
+    mutable QCache<int, QTextDocument> m_documents;               ///< 条目 key 到排版文档的缓存
+    QHash<QString, QSize> m_imageSizes;                           ///< 已知的图片显示尺寸，缩略图被逐出缓存后行高不变
+    QSet<QString> m_missingImages;                                ///< 无法加载的图片路径
+    QHash<QString, QList<QPersistentModelIndex>> m_requests;      ///< 正在加载的缩略图及等待它的条目
+    int m_selectionKey = -1;                                      ///< 文本选区所在条目，-1 表示无选区
+    int m_selectionAnchor = 0;                                    ///< 选区起点
+    int m_selectionPosition = 0;                                  ///< 选区终点
+};
@@ -0,0 +1,166 @@
+/**
+ * @file GalleryItemDelegate.cpp
+ * @brief 画廊图片绘制代理实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "GalleryItemDelegate.h"
+#include "Theme.h"
+#include "../../Core/ImageLoader.h"
+#include <QAbstractItemView>
+#include <QPainter>
+#include <QPainterPath>
+
+namespace {
+const int kMissingHeight = 60;     ///< 图片丢失时的卡片高度
+const qreal kMinAspect = 1.0 / 3;  ///< 卡片最小高宽比，避免极窄长图占满一列
+const qreal kMaxAspect = 3.0;      ///< 卡片最大高宽比
+}
+
+/**
+ * @brief 构造函数
+ * @param view 所属视图
+ */
+GalleryItemDelegate::GalleryItemDelegate(QAbstractItemView* view)
+    : QStyledItemDelegate(view)
+    , m_view(view)
+{
+}
+
+/**
+ * @brief 清空已知的图片尺寸和丢失记录
+ */
+void GalleryItemDelegate::reset()
+{
+    m_imageSizes.clear();
+    m_missingImages.clear();
+    m_requests.clear();
+}
+
+/**
+ * @brief 图片的宽高
+ * @param image 画廊图片
+ * @return QSize 图片尺寸，未知时为空
+ */
+QSize GalleryItemDelegate::imageSize(const GalleryImage& image) const
+{
+    if (!image.size.isEmpty()) return image.size;
+    return m_imageSizes.value(image.path);
+}
+
+/**
+ * @brief 计算卡片尺寸
+ * @param option 样式选项
+ * @param index 条目索引
+ * @return QSize 卡片尺寸
+ */
+QSize GalleryItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    const auto* model = static_cast<const GalleryModel*>(index.model());
+    const GalleryImage* image = model->imageAt(index);
+    const int width = option.rect.width();
+    if (!image || width <= 0) return QSize();
+
+    if (m_missingImages.contains(image->path)) return QSize(width, kMissingHeight);
+
+    const QSize size = imageSize(*image);
+    if (size.isEmpty()) return QSize(width, width);
+
+    const qreal aspect = qBound(kMinAspect, qreal(size.height()) / size.width(), kMaxAspect);
+    return QSize(width, qRound(width * aspect));
+}
+
+/**
+ * @brief 请求加载缩略图
+ * @param path 原图路径
+ * @param index 等待该图片的条目
+ */
+void GalleryItemDelegate::requestThumbnail(const QString& path, const QModelIndex& index)
+{
+    auto it = m_requests.find(path);
+    if (it != m_requests.end()) {
+        it->append(QPersistentModelIndex(index));
+        return;
+    }
+    m_requests.insert(path, { QPersistentModelIndex(index) });
+
+    ImageLoader::instance().loadThumbnail(path, ThumbnailTier::Small, this)
+        .then(this, [this, path](const QPixmap& pix) {
+            const QList<QPersistentModelIndex> waiting = m_requests.take(path);
+            const bool sizeChanged = pix.isNull() || pix.size() != m_imageSizes.value(path);
+
+            bool relayout = false;
+            for (const QPersistentModelIndex& idx : waiting) {
+                if (!idx.isValid()) continue;
+
+                // 数据库已记录尺寸的卡片比例不会变化，只需重绘
+                const auto* model = static_cast<const GalleryModel*>(idx.model());
+                const GalleryImage* image = model->imageAt(idx);
+                if (sizeChanged && (pix.isNull() || (image && image->size.isEmpty()))) relayout = true;
+                m_view->update(idx);
+            }
+
+            if (pix.isNull()) {
+                m_missingImages.insert(path);
+            } else {
+                m_imageSizes.insert(path, pix.size());
+            }
+
+            if (relayout && !waiting.isEmpty()) emit sizeHintChanged(waiting.first());
+        });
+}
+
+/**
+ * @brief 绘制图片卡片
+ * @param painter 绘制器
+ * @param option 样式选项
+ * @param index 条目索引
+ */
+void GalleryItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    const auto* model = static_cast<const GalleryModel*>(index.model());
+    const GalleryImage* image = model->imageAt(index);
+    if (!image) return;
+
+    const QRect rect = option.rect;
+    const bool hovered = option.state & QStyle::State_MouseOver;
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+
+    QPainterPath shape;
+    shape.addRoundedRect(QRectF(rect).adjusted(0.5, 0.5, -0.5, -0.5), Theme::kCardRadius, Theme::kCardRadius);
+
+    if (m_missingImages.contains(image->path)) {
+        painter->setPen(QPen(Theme::kBorder, 1, Qt::DashLine));
+        painter->drawPath(shape);
+        painter->setPen(Theme::kTextMissing);
+        painter->drawText(rect, Qt::AlignCenter, "❌ 图片丢失");
+        painter->restore();
+        return;
+    }
+
+    painter->fillPath(shape, Qt::black);
+
+    QPixmap pix = ImageLoader::instance().cachedThumbnail(image->path, ThumbnailTier::Small);
+    if (!pix.isNull()) {
+        // 按卡片比例裁剪缩略图中间部分，比例被限制的长图不会变形
+        QSizeF source = QSizeF(rect.size()).scaled(pix.size(), Qt::KeepAspectRatio);
+        QRectF sourceRect(QPointF(0, 0), source);
+        sourceRect.moveCenter(QRectF(pix.rect()).center());
+
+        painter->setClipPath(shape);
+        painter->drawPixmap(QRectF(rect), pix, sourceRect);
+        painter->setClipping(false);
+    } else if (!m_requests.contains(image->path)) {
+        const_cast<GalleryItemDelegate*>(this)->requestThumbnail(image->path, index);
+    }
+
+    painter->setPen(QPen(hovered ? Theme::kAccent : Theme::kBorderSubtle, 1));
+    painter->drawPath(shape);
+
+    painter->restore();
+}
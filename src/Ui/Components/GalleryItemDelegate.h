@@ -0,0 +1,81 @@
+/**
+ * @file GalleryItemDelegate.h
+ * @brief 画廊图片绘制代理头文件
+ *
+ * 该文件定义了GalleryItemDelegate类，负责在历史画廊中绘制图片卡片并按图片比例计算卡片高度。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QStyledItemDelegate>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QPersistentModelIndex>
+#include "../../Model/GalleryModel.h"
+
+class QAbstractItemView;
+
+/**
+ * @brief 画廊图片绘制代理类
+ *
+ * 只绘制小档缩略图，缩略图只在卡片可见（被绘制）时才向 ImageLoader 请求。
+ * 数据库没有记录尺寸的旧图片先按正方形排版，缩略图加载后比例不同才触发重新布局。
+ */
+class GalleryItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param view 所属视图
+     */
+    explicit GalleryItemDelegate(QAbstractItemView* view);
+
+    /**
+     * @brief 绘制图片卡片
+     * @param painter 绘制器
+     * @param option 样式选项（rect 为卡片区域）
+     * @param index 条目索引
+     */
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 计算卡片尺寸
+     * @param option 样式选项（rect 宽度为列宽）
+     * @param index 条目索引
+     * @return QSize 卡片尺寸
+     */
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 清空已知的图片尺寸和丢失记录
+     */
+    void reset();
+
+private:
+    /**
+     * @brief 图片的宽高
+     * @param image 画廊图片
+     * @return QSize 数据库记录或缩略图得到的尺寸，未知时为空
+     */
+    QSize imageSize(const GalleryImage& image) const;
+
+    /**
+     * @brief 请求加载缩略图
+     * @param path 原图路径
+     * @param index 等待该图片的条目
+     */
+    void requestThumbnail(const QString& path, const QModelIndex& index);
+
+private:
+    QAbstractItemView* m_view = nullptr;                      ///< 所属视图
+    QHash<QString, QSize> m_imageSizes;                       ///< 缩略图得到的图片尺寸
+    QSet<QString> m_missingImages;                            ///< 无法加载的图片路径
+    QHash<QString, QList<QPersistentModelIndex>> m_requests;  ///< 正在加载的缩略图及等待它的条目
+};
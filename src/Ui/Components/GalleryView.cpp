@@ -0,0 +1,440 @@
+/**
+ * @file GalleryView.cpp
+ * @brief 瀑布流图片视图实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "GalleryView.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QScrollBar>
+#include <algorithm>
+
+namespace {
+const int kMarginLeft = 15;   ///< 内容左边距
+const int kMarginRight = 5;   ///< 内容右边距
+const int kMarginTop = 10;    ///< 内容上边距
+const int kMarginBottom = 10; ///< 内容下边距
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父窗口指针
+ */
+GalleryView::GalleryView(QWidget* parent)
+    : QAbstractItemView(parent)
+{
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    setFrameShape(QFrame::NoFrame);
+    setMouseTracking(true);
+    verticalScrollBar()->setSingleStep(20);
+}
+
+/**
+ * @brief 设置最小列宽
+ * @param width 最小列宽
+ */
+void GalleryView::setMinimumColumnWidth(int width)
+{
+    m_minColumnWidth = qMax(1, width);
+    scheduleDelayedItemsLayout();
+}
+
+/**
+ * @brief 设置条目间距
+ * @param spacing 行列间距
+ */
+void GalleryView::setSpacing(int spacing)
+{
+    m_spacing = qMax(0, spacing);
+    scheduleDelayedItemsLayout();
+}
+
+/**
+ * @brief 根据视口宽度计算列数和列宽
+ * @return bool 列布局是否发生变化
+ */
+bool GalleryView::updateColumns()
+{
+    const int available = qMax(1, viewport()->width() - kMarginLeft - kMarginRight);
+    const int count = qMax(1, (available + m_spacing) / (m_minColumnWidth + m_spacing));
+    const int width = qMax(1, (available - (count - 1) * m_spacing) / count);
+
+    const bool changed = (count != m_columnCount || width != m_columnWidth);
+    m_columnCount = count;
+    m_columnWidth = width;
+    return changed;
+}
+
+/**
+ * @brief 重新计算全部条目的位置
+ *
+ * 只做整数运算，数万条目也在毫秒级完成
+ */
+void GalleryView::doItemsLayout()
+{
+    updateColumns();
+
+    m_columnBottoms.fill(kMarginTop, m_columnCount);
+    m_maxItemHeight = 0;
+    m_rects.clear();
+    layoutRows(0);
+
+    QAbstractItemView::doItemsLayout();
+}
+
+/**
+ * @brief 模型重置后清空布局
+ */
+void GalleryView::reset()
+{
+    m_hover = QPersistentModelIndex();
+    m_rects.clear();
+    m_columnBottoms.fill(kMarginTop, m_columnCount);
+    m_maxItemHeight = 0;
+    QAbstractItemView::reset();
+}
+
+/**
+ * @brief 从指定行开始依次排布条目
+ * @param from 起始行
+ */
+void GalleryView::layoutRows(int from)
+{
+    if (!model()) return;
+
+    const int count = model()->rowCount(rootIndex());
+    if (m_columnBottoms.size() != m_columnCount) m_columnBottoms.fill(kMarginTop, m_columnCount);
+    m_rects.resize(count);
+
+    QStyleOptionViewItem option;
+    initViewItemOption(&option);
+    option.rect = QRect(0, 0, m_columnWidth, 0);
+
+    for (int row = from; row < count; ++row) {
+        const QModelIndex index = model()->index(row, 0, rootIndex());
+        const int height = qMax(1, itemDelegateForIndex(index)->sizeHint(option, index).height());
+
+        auto shortest = std::min_element(m_columnBottoms.begin(), m_columnBottoms.end());
+        const int column = int(shortest - m_columnBottoms.begin());
+
+        m_rects[row] = QRect(kMarginLeft + column * (m_columnWidth + m_spacing), *shortest, m_columnWidth, height);
+        *shortest += height + m_spacing;
+        m_maxItemHeight = qMax(m_maxItemHeight, height);
+    }
+
+    updateGeometries();
+    viewport()->update();
+}
+
+/**
+ * @brief 查找可能与给定纵向范围相交的第一行
+ * @param top 内容坐标下的范围上沿
+ * @return int 行号
+ */
+int GalleryView::firstRowNear(int top) const
+{
+    // 顶边单调不减：顶边早于 top - 最大高度 的条目不可能延伸到 top 以下
+    const int limit = top - m_maxItemHeight;
+    auto it = std::lower_bound(m_rects.cbegin(), m_rects.cend(), limit,
+                               [](const QRect& rect, int value) { return rect.top() < value; });
+    return int(it - m_rects.cbegin());
+}
+
+/**
+ * @brief 更新滚动条范围
+ */
+void GalleryView::updateGeometries()
+{
+    int contentHeight = 0;
+    if (!m_rects.isEmpty()) {
+        contentHeight = *std::max_element(m_columnBottoms.cbegin(), m_columnBottoms.cend())
+                        - m_spacing + kMarginBottom;
+    }
+
+    QScrollBar* bar = verticalScrollBar();
+    bar->setPageStep(viewport()->height());
+    bar->setRange(0, qMax(0, contentHeight - viewport()->height()));
+
+    QAbstractItemView::updateGeometries();
+    fetchMoreIfNeeded();
+}
+
+/**
+ * @brief 接近底部时请求下一页
+ */
+void GalleryView::fetchMoreIfNeeded()
+{
+    if (!model() || !model()->canFetchMore(rootIndex())) return;
+
+    QScrollBar* bar = verticalScrollBar();
+    if (bar->maximum() - bar->value() < viewport()->height()) {
+        model()->fetchMore(rootIndex());
+    }
+}
+
+/**
+ * @brief 新行插入
+ * @param parent 父索引
+ * @param start 起始行
+ * @param end 结束行
+ *
+ * 追加到末尾时（翻页）只排布新行；插入到中间或顶部、或列宽已变化时整体重排
+ */
+void GalleryView::rowsInserted(const QModelIndex& parent, int start, int end)
+{
+    QAbstractItemView::rowsInserted(parent, start, end);
+    if (parent != rootIndex()) return;
+
+    if (start == m_rects.size() && !updateColumns()) {
+        layoutRows(start);
+    } else {
+        doItemsLayout();
+    }
+}
+
+/**
+ * @brief 行即将被删除
+ * @param parent 父索引
+ * @param start 起始行
+ * @param end 结束行
+ */
+void GalleryView::rowsAboutToBeRemoved(const QModelIndex& parent, int start, int end)
+{
+    QAbstractItemView::rowsAboutToBeRemoved(parent, start, end);
+    if (parent == rootIndex()) scheduleDelayedItemsLayout();
+}
+
+/**
+ * @brief 数据变化后重新排布
+ */
+void GalleryView::dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles)
+{
+    QAbstractItemView::dataChanged(topLeft, bottomRight, roles);
+    scheduleDelayedItemsLayout();
+}
+
+/**
+ * @brief 绘制视口内的条目
+ * @param event 绘制事件
+ */
+void GalleryView::paintEvent(QPaintEvent* event)
+{
+    if (!model()) return;
+
+    QPainter painter(viewport());
+    const int offset = verticalOffset();
+    const QRect visible = event->rect().translated(0, offset);
+    const int count = qMin<int>(m_rects.size(), model()->rowCount(rootIndex()));
+
+    QStyleOptionViewItem option;
+    initViewItemOption(&option);
+
+    for (int row = firstRowNear(visible.top()); row < count; ++row) {
+        const QRect& rect = m_rects[row];
+        if (rect.top() > visible.bottom()) break;
+        if (!rect.intersects(visible)) continue;
+
+        const QModelIndex index = model()->index(row, 0, rootIndex());
+        option.rect = rect.translated(0, -offset);
+        option.state = QStyle::State_Enabled;
+        if (index == m_hover) option.state |= QStyle::State_MouseOver;
+
+        itemDelegateForIndex(index)->paint(&painter, option, index);
+    }
+}
+
+/**
+ * @brief 尺寸变化时按新列宽重排
+ * @param event 尺寸事件
+ */
+void GalleryView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractItemView::resizeEvent(event);
+
+    if (updateColumns()) {
+        doItemsLayout();
+    } else {
+        updateGeometries();
+    }
+}
+
+/**
+ * @brief 滚动内容
+ * @param dx 水平偏移
+ * @param dy 垂直偏移
+ */
+void GalleryView::scrollContentsBy(int dx, int dy)
+{
+    viewport()->scroll(dx, dy);
+    fetchMoreIfNeeded();
+}
+
+/**
+ * @brief 获取条目在视口中的区域
+ * @param index 条目索引
+ * @return QRect 视口坐标下的区域
+ */
+QRect GalleryView::visualRect(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() >= m_rects.size()) return QRect();
+    return m_rects[index.row()].translated(0, -verticalOffset());
+}
+
+/**
+ * @brief 滚动使条目可见
+ * @param index 条目索引
+ * @param hint 滚动方式
+ */
+void GalleryView::scrollTo(const QModelIndex& index, ScrollHint hint)
+{
+    if (!index.isValid() || index.row() >= m_rects.size()) return;
+
+    const QRect rect = m_rects[index.row()];
+    QScrollBar* bar = verticalScrollBar();
+    const int height = viewport()->height();
+
+    switch (hint) {
+    case PositionAtTop:
+        bar->setValue(rect.top() - m_spacing);
+        break;
+    case PositionAtBottom:
+        bar->setValue(rect.bottom() + m_spacing - height);
+        break;
+    case PositionAtCenter:
+        bar->setValue(rect.center().y() - height / 2);
+        break;
+    case EnsureVisible:
+        if (rect.top() < bar->value()) {
+            bar->setValue(rect.top() - m_spacing);
+        } else if (rect.bottom() > bar->value() + height) {
+            bar->setValue(rect.bottom() + m_spacing - height);
+        }
+        break;
+    }
+}
+
+/**
+ * @brief 获取视口坐标处的条目
+ * @param point 视口坐标
+ * @return QModelIndex 条目索引
+ */
+QModelIndex GalleryView::indexAt(const QPoint& point) const
+{
+    if (!model()) return QModelIndex();
+
+    const QPoint pos = point + QPoint(0, verticalOffset());
+    const int count = qMin<int>(m_rects.size(), model()->rowCount(rootIndex()));
+
+    for (int row = firstRowNear(pos.y()); row < count; ++row) {
+        const QRect& rect = m_rects[row];
+        if (rect.top() > pos.y()) break;
+        if (rect.contains(pos)) return model()->index(row, 0, rootIndex());
+    }
+    return QModelIndex();
+}
+
+/**
+ * @brief 键盘移动当前条目（按时间顺序前后移动）
+ */
+QModelIndex GalleryView::moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers)
+{
+    Q_UNUSED(modifiers)
+    if (!model()) return QModelIndex();
+
+    const int count = model()->rowCount(rootIndex());
+    if (count == 0) return QModelIndex();
+
+    int row = currentIndex().isValid() ? currentIndex().row() : 0;
+    switch (cursorAction) {
+    case MoveUp:
+    case MoveLeft:
+    case MovePrevious:
+        row = qMax(0, row - 1);
+        break;
+    case MoveDown:
+    case MoveRight:
+    case MoveNext:
+        row = qMin(count - 1, row + 1);
+        break;
+    case MoveHome:
+        row = 0;
+        break;
+    case MoveEnd:
+        row = count - 1;
+        break;
+    default:
+        break;
+    }
+    return model()->index(row, 0, rootIndex());
+}
+
+int GalleryView::horizontalOffset() const
+{
+    return 0;
+}
+
+int GalleryView::verticalOffset() const
+{
+    return verticalScrollBar()->value();
+}
+
+bool GalleryView::isIndexHidden(const QModelIndex& index) const
+{
+    Q_UNUSED(index)
+    return false;
+}
+
+void GalleryView::setSelection(const QRect& rect, QItemSelectionModel::SelectionFlags command)
+{
+    Q_UNUSED(rect)
+    Q_UNUSED(command)
+}
+
+QRegion GalleryView::visualRegionForSelection(const QItemSelection& selection) const
+{
+    Q_UNUSED(selection)
+    return QRegion();
+}
+
+/**
+ * @brief 鼠标移动时更新悬停条目
+ * @param event 鼠标事件
+ */
+void GalleryView::mouseMoveEvent(QMouseEvent* event)
+{
+    QAbstractItemView::mouseMoveEvent(event);
+    setHoverIndex(indexAt(event->position().toPoint()));
+}
+
+/**
+ * @brief 视口事件，鼠标离开时清除悬停
+ * @param event 事件
+ * @return bool 是否已处理
+ */
+bool GalleryView::viewportEvent(QEvent* event)
+{
+    if (event->type() == QEvent::Leave) setHoverIndex(QModelIndex());
+    return QAbstractItemView::viewportEvent(event);
+}
+
+/**
+ * @brief 更新鼠标悬停的条目
+ * @param index 新的悬停条目
+ */
+void GalleryView::setHoverIndex(const QModelIndex& index)
+{
+    if (index == m_hover) return;
+
+    if (m_hover.isValid()) viewport()->update(visualRect(m_hover));
+    m_hover = index;
+    if (m_hover.isValid()) viewport()->update(visualRect(m_hover));
+
+    viewport()->setCursor(index.isValid() ? Qt::PointingHandCursor : Qt::ArrowCursor);
+}
@@ -0,0 +1,140 @@
+/**
+ * @file GalleryView.h
+ * @brief 瀑布流图片视图头文件
+ *
+ * 该文件定义了GalleryView类，以多列瀑布流的形式展示列表模型中的图片。
+ * 只绘制视口内的条目，滚动到底部附近时自动向模型请求下一页。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QAbstractItemView>
+#include <QPersistentModelIndex>
+#include <QVector>
+
+/**
+ * @brief 瀑布流图片视图类
+ *
+ * 继承自QAbstractItemView。列数由视口宽度和最小列宽决定，每个条目放到当前最短的一列，
+ * 条目高度取自绘制代理的 sizeHint（宽度为列宽）。
+ * 由于总是放到最短列，条目顶边随行号单调不减，命中测试和绘制都可以二分查找起点。
+ */
+class GalleryView : public QAbstractItemView
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父窗口指针
+     */
+    explicit GalleryView(QWidget* parent = nullptr);
+
+    /**
+     * @brief 设置最小列宽
+     * @param width 最小列宽（像素）
+     */
+    void setMinimumColumnWidth(int width);
+
+    /**
+     * @brief 设置条目间距
+     * @param spacing 行列间距（像素）
+     */
+    void setSpacing(int spacing);
+
+    /**
+     * @brief 获取条目在视口中的区域
+     * @param index 条目索引
+     * @return QRect 视口坐标下的区域
+     */
+    QRect visualRect(const QModelIndex& index) const override;
+
+    /**
+     * @brief 滚动使条目可见
+     * @param index 条目索引
+     * @param hint 滚动方式
+     */
+    void scrollTo(const QModelIndex& index, ScrollHint hint = EnsureVisible) override;
+
+    /**
+     * @brief 获取视口坐标处的条目
+     * @param point 视口坐标
+     * @return QModelIndex 条目索引，空白处为无效索引
+     */
+    QModelIndex indexAt(const QPoint& point) const override;
+
+    /**
+     * @brief 重新计算全部条目的位置
+     */
+    void doItemsLayout() override;
+
+    /**
+     * @brief 模型重置后清空布局
+     */
+    void reset() override;
+
+protected:
+    QModelIndex moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) override;
+    int horizontalOffset() const override;
+    int verticalOffset() const override;
+    bool isIndexHidden(const QModelIndex& index) const override;
+    void setSelection(const QRect& rect, QItemSelectionModel::SelectionFlags command) override;
+    QRegion visualRegionForSelection(const QItemSelection& selection) const override;
+    void updateGeometries() override;
+
+    void rowsInserted(const QModelIndex& parent, int start, int end) override;
+    void rowsAboutToBeRemoved(const QModelIndex& parent, int start, int end) override;
+    void dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                     const QList<int>& roles = QList<int>()) override;
+
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    bool viewportEvent(QEvent* event) override;
+
+private:
+    /**
+     * @brief 根据视口宽度计算列数和列宽
+     * @return bool 列布局是否发生变化
+     */
+    bool updateColumns();
+
+    /**
+     * @brief 从指定行开始依次排布条目
+     * @param from 起始行，之前的行保持不变
+     */
+    void layoutRows(int from);
+
+    /**
+     * @brief 查找可能与给定纵向范围相交的第一行
+     * @param top 内容坐标下的范围上沿
+     * @return int 行号
+     */
+    int firstRowNear(int top) const;
+
+    /**
+     * @brief 接近底部时请求下一页
+     */
+    void fetchMoreIfNeeded();
+
+    /**
+     * @brief 更新鼠标悬停的条目
+     * @param index 新的悬停条目
+     */
+    void setHoverIndex(const QModelIndex& index);
+
+private:
+    QVector<QRect> m_rects;          ///< 各行在内容坐标下的区域
+    QVector<int> m_columnBottoms;    ///< 各列当前底部（含间距）
+    int m_columnCount = 1;           ///< 列数
+    int m_columnWidth = 0;           ///< 列宽
+    int m_minColumnWidth = 100;      ///< 最小列宽
+    int m_spacing = 10;              ///< 行列间距
+    int m_maxItemHeight = 0;         ///< 最高条目的高度，用于确定查找起点
+    QPersistentModelIndex m_hover;   ///< 鼠标悬停的条目
+};
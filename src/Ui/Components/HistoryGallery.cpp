@@ -7,92 +7,16 @@
  */
 
 #include "HistoryGallery.h"
-#include "../../Database/DatabaseManager.h"
-#include <QScrollArea>
-#include <QMouseEvent>
-#include <QFileInfo>
-#include <QScrollBar>
-#include <QPainter>
+#include "GalleryView.h"
+#include "GalleryItemDelegate.h"
+#include "../../Core/ImageLoader.h"
+#include <QVBoxLayout>
+#include <QDateTime>
 #include <QDebug>
 #include <QMenu>
 #include <QClipboard>
 #include <QApplication>
 
-class GalleryItem : public QLabel
-{
-public:
-    QString imagePath;
-    std::function<void(QString)> onClick;
-
-    GalleryItem(const QString& path, int targetWidth, QWidget* parent = nullptr)
-        : QLabel(parent), imagePath(path)
-    {
-        this->setStyleSheet(
-            "QLabel { "
-            "  background-color: black; "
-            "  border: 1px solid #333; "
-            "  border-radius: 6px; "
-            "}"
-            "QLabel:hover { "
-            "  border: 1px solid #19C37D; "
-            "  cursor: pointer; "
-            "}"
-            );
-        this->setAlignment(Qt::AlignCenter);
-
-        QPixmap pix(path);
-        if (!pix.isNull()) {
-            QPixmap scaled = pix.scaledToWidth(targetWidth, Qt::SmoothTransformation);
-            this->setPixmap(scaled);
-            this->setFixedSize(scaled.size());
-        } else {
-            this->setText("❌ 图片丢失");
-            this->setFixedSize(targetWidth, 60);
-            this->setStyleSheet("color: #666; border: 1px dashed #444; border-radius: 6px;");
-        }
-    }
-
-protected:
-    void mousePressEvent(QMouseEvent* event) override {
-        if (event->button() == Qt::LeftButton) {
-            if (onClick) onClick(imagePath);
-        }
-        else if (event->button() == Qt::RightButton) {
-            showContextMenu(event->globalPosition().toPoint());
-        }
-
-        QLabel::mousePressEvent(event);
-    }
-
-private:
-    void showContextMenu(const QPoint& pos) {
-        QMenu menu;
-        menu.setStyleSheet(
-            "QMenu { background-color: #2D2D2D; color: white; border: 1px solid #555; padding: 5px; }"
-            "QMenu::item { padding: 5px 20px; }"
-            "QMenu::item:selected { background-color: #40414F; }"
-            );
-
-        QAction* actCopy = menu.addAction("❐ 复制图片");
-        QObject::connect(actCopy, &QAction::triggered, [this](){
-            QPixmap originalPix(imagePath);
-            if (!originalPix.isNull()) {
-                QClipboard *clipboard = QApplication::clipboard();
-                clipboard->setPixmap(originalPix);
-                qDebug() << "图片已复制到剪贴板:" << imagePath;
-            }
-        });
-
-        QAction* actPath = menu.addAction("📂 复制路径");
-        QObject::connect(actPath, &QAction::triggered, [this](){
-            QClipboard *clipboard = QApplication::clipboard();
-            clipboard->setText(imagePath);
-        });
-
-        menu.exec(pos);
-    }
-};
-
 HistoryGallery::HistoryGallery(QWidget *parent) : QWidget(parent)
 {
     setupUi();
@@ -111,16 +35,25 @@ void HistoryGallery::setupUi()
     title->setStyleSheet("color: #ECECF1; font-weight: bold; font-size: 14px; padding-left: 15px; border: none;");
     mainLayout->addWidget(title);
 
-    m_scrollArea = new QScrollArea(this);
-    m_scrollArea->setWidgetResizable(true);
-    m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
-    m_scrollArea->setFrameShape(QFrame::NoFrame);
+    m_emptyLabel = new QLabel("暂无记录", this);
+    m_emptyLabel->setStyleSheet("color: #666; font-size: 12px; margin-top: 20px; border:none;");
+    m_emptyLabel->setAlignment(Qt::AlignHCenter);
+    m_emptyLabel->hide();
+    mainLayout->addWidget(m_emptyLabel);
+
+    m_model = new GalleryModel(this);
+
+    m_view = new GalleryView(this);
+    m_view->setMinimumColumnWidth(100);
+    m_view->setSpacing(10);
+    m_view->setContextMenuPolicy(Qt::CustomContextMenu);
 
-    m_scrollArea->verticalScrollBar()->setSingleStep(20);
+    m_delegate = new GalleryItemDelegate(m_view);
+    m_view->setItemDelegate(m_delegate);
+    m_view->setModel(m_model);
 
-    m_scrollArea->setStyleSheet(
-        "QScrollArea { "
+    m_view->setStyleSheet(
+        "QAbstractItemView { "
         "   background: transparent; "
         "   border: none; "
         "}"
@@ -151,54 +84,89 @@ void HistoryGallery::setupUi()
         "}"
         );
 
-    m_scrollContent = new QWidget();
-    m_scrollContent->setStyleSheet("background: transparent;");
+    mainLayout->addWidget(m_view);
 
-    m_scrollLayout = new QVBoxLayout(m_scrollContent);
-    m_scrollLayout->setContentsMargins(15, 10, 5, 10);
-    m_scrollLayout->setSpacing(15);
-    m_scrollLayout->setAlignment(Qt::AlignTop);
+    connect(m_view, &QAbstractItemView::clicked, this, [this](const QModelIndex& index){
+        if (const GalleryImage* image = m_model->imageAt(index)) emit imageClicked(image->path);
+    });
+    connect(m_view, &QWidget::customContextMenuRequested, this, &HistoryGallery::showContextMenu);
 
-    m_scrollArea->setWidget(m_scrollContent);
-    mainLayout->addWidget(m_scrollArea);
+    connect(m_model, &GalleryModel::pageLoaded, this, &HistoryGallery::updateEmptyHint);
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &HistoryGallery::updateEmptyHint);
+    connect(m_model, &QAbstractItemModel::rowsRemoved, this, &HistoryGallery::updateEmptyHint);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &HistoryGallery::updateEmptyHint);
 }
 
-void HistoryGallery::clearLayout()
+void HistoryGallery::showEvent(QShowEvent* event)
 {
-    QLayoutItem* item;
-    while ((item = m_scrollLayout->takeAt(0)) != nullptr) {
-        if (item->widget()) {
-            delete item->widget();
-        }
-        delete item;
-    }
+    QWidget::showEvent(event);
+
+    // 只在第一次显示时查询，之后新图片通过 addImage() 增量插入
+    if (!m_started) loadImages();
 }
 
 void HistoryGallery::loadImages()
 {
-    clearLayout();
-
-    QVector<QString> paths = DatabaseManager::instance().getAllAiImages();
+    // 画廊不可见时推迟到下次显示再查询
+    m_started = isVisible();
+    if (!m_started) return;
 
-    if (paths.isEmpty()) {
-        QLabel* empty = new QLabel("暂无记录", m_scrollContent);
-        empty->setStyleSheet("color: #666; font-size: 12px; margin-top: 20px; border:none;");
-        empty->setAlignment(Qt::AlignHCenter);
-        m_scrollLayout->addWidget(empty);
-        return;
-    }
+    m_delegate->reset();
+    m_model->reload();
+}
 
-    int cardWidth = 220;
+void HistoryGallery::addImage(const QString& path, const QSize& size, int sessionId)
+{
+    if (!m_started || path.isEmpty()) return;
+
+    GalleryImage image;
+    image.sessionId = sessionId;
+    image.path = path;
+    image.size = size;
+    image.timestamp = QDateTime::currentMSecsSinceEpoch();
+    m_model->prepend(image);
+}
 
-    for (const QString& path : paths) {
-        if (!QFileInfo::exists(path)) continue;
+void HistoryGallery::removeSession(int sessionId)
+{
+    m_model->removeSession(sessionId);
+}
 
-        GalleryItem* item = new GalleryItem(path, cardWidth, m_scrollContent);
+void HistoryGallery::updateEmptyHint()
+{
+    m_emptyLabel->setVisible(m_model->isLoaded() && m_model->rowCount() == 0);
+}
 
-        item->onClick = [this](QString p){
-            emit imageClicked(p);
-        };
+void HistoryGallery::showContextMenu(const QPoint& pos)
+{
+    const GalleryImage* image = m_model->imageAt(m_view->indexAt(pos));
+    if (!image) return;
+    const QString imagePath = image->path;
+
+    QMenu menu;
+    menu.setStyleSheet(
+        "QMenu { background-color: #2D2D2D; color: white; border: 1px solid #555; padding: 5px; }"
+        "QMenu::item { padding: 5px 20px; }"
+        "QMenu::item:selected { background-color: #40414F; }"
+        );
 
-        m_scrollLayout->addWidget(item);
-    }
+    QAction* actCopy = menu.addAction("❐ 复制图片");
+    connect(actCopy, &QAction::triggered, this, [this, imagePath](){
+        ImageLoader::instance().load(imagePath, QSize(), this, ImagePriority::High)
+            .then(this, [imagePath](const QPixmap& originalPix) {
+                if (!originalPix.isNull()) {
+                    QClipboard *clipboard = QApplication::clipboard();
+                    clipboard->setPixmap(originalPix);
+                    qDebug() << "图片已复制到剪贴板:" << imagePath;
+                }
+            });
+    });
+
+    QAction* actPath = menu.addAction("📂 复制路径");
+    connect(actPath, &QAction::triggered, this, [imagePath](){
+        QClipboard *clipboard = QApplication::clipboard();
+        clipboard->setText(imagePath);
+    });
+
+    menu.exec(m_view->viewport()->mapToGlobal(pos));
 }
@@ -13,16 +13,17 @@
 #pragma once
 
 #include <QWidget>
-#include <QScrollArea>
-#include <QVBoxLayout>
 #include <QLabel>
-#include <QVector>
+#include "../../Model/GalleryModel.h"
+
+class GalleryView;
+class GalleryItemDelegate;
 
 /**
  * @brief 历史记录画廊类
  * 
- * 继承自QWidget，提供历史图片的展示功能。
- * 使用滚动区域支持大量图片的浏览，点击图片可触发查看事件。
+ * 继承自QWidget，以多列瀑布流展示历史图片。图片按页从数据库加载，视图只绘制可见卡片，
+ * 滚动到底部附近时自动加载更早的一页；新生成的图片通过 addImage() 增量插入到顶部。
  */
 class HistoryGallery : public QWidget
 {
@@ -36,12 +37,26 @@ public:
     explicit HistoryGallery(QWidget *parent = nullptr);
 
     /**
-     * @brief 刷新显示图片
+     * @brief 重新加载图片
      * 
-     * 从数据库加载所有生成的图片并显示在画廊中
+     * 丢弃已加载的图片并从数据库加载最新一页；画廊不可见时推迟到下次显示
      */
     void loadImages();
 
+    /**
+     * @brief 插入一张新生成的图片
+     * @param path 本地图片路径
+     * @param size 图片尺寸
+     * @param sessionId 所属会话ID
+     */
+    void addImage(const QString& path, const QSize& size, int sessionId);
+
+    /**
+     * @brief 移除已删除会话的图片
+     * @param sessionId 会话ID
+     */
+    void removeSession(int sessionId);
+
 signals:
     /**
      * @brief 图片点击信号
@@ -49,6 +64,13 @@ signals:
      */
     void imageClicked(const QString& imagePath);
 
+protected:
+    /**
+     * @brief 首次显示时加载第一页
+     * @param event 显示事件
+     */
+    void showEvent(QShowEvent* event) override;
+
 private:
     /**
      * @brief 初始化UI布局
@@ -56,14 +78,20 @@ private:
     void setupUi();
 
     /**
-     * @brief 清除当前的列表项
-     * 
-     * 清空滚动区域中的所有图片项
+     * @brief 显示右键菜单
+     * @param pos 视口坐标
+     */
+    void showContextMenu(const QPoint& pos);
+
+    /**
+     * @brief 根据模型状态显示或隐藏空记录提示
      */
-    void clearLayout();
+    void updateEmptyHint();
 
 private:
-    QScrollArea* m_scrollArea = nullptr; ///< 滚动区域组件
-    QWidget* m_scrollContent = nullptr; ///< 滚动区域里的实体容器
-    QVBoxLayout* m_scrollLayout = nullptr; ///< 垂直布局（单列）
+    GalleryModel* m_model = nullptr;              ///< 画廊数据模型
+    GalleryView* m_view = nullptr;                ///< 瀑布流视图
+    GalleryItemDelegate* m_delegate = nullptr;    ///< 卡片绘制代理
+    QLabel* m_emptyLabel = nullptr;               ///< 空记录提示
+    bool m_started = false;                       ///< 是否已开始加载
 };
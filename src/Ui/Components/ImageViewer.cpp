@@ -10,13 +10,28 @@
  */
 
 #include "ImageViewer.h"
+#include "TiledImageItem.h"
+#include "../../Core/ImageLoader.h"
+#include "../../Core/TilePyramid.h"
 #include <QVBoxLayout>
 #include <QResizeEvent>
 #include <QScreen>
 #include <QApplication>
 #include <QTimer>
+#include <QImageReader>
+#include <QThreadPool>
+#include <QPointer>
+#include <QWheelEvent>
 
-ImageViewer::ImageViewer(const QPixmap& pixmap, QWidget* parent) : QDialog(parent) {
+/**
+ * @brief 构造函数
+ * @param path 原图路径
+ * @param preview 预览图
+ * @param parent 父窗口指针
+ */
+ImageViewer::ImageViewer(const QString& path, const QPixmap& preview, QWidget* parent)
+    : QDialog(parent)
+    , m_cancelled(std::make_shared<std::atomic_bool>(false)) {
     this->setWindowTitle("查看图片 (滚轮缩放/左键拖拽/双击还原)");
     this->setWindowFlags(Qt::Window | Qt::WindowMinMaxButtonsHint | Qt::WindowCloseButtonHint);
 
@@ -30,7 +45,9 @@ ImageViewer::ImageViewer(const QPixmap& pixmap, QWidget* parent) : QDialog(paren
     m_scene = new QGraphicsScene(this);
     m_view = new QGraphicsView(m_scene, this);
 
-    m_view->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+    // 瓦片自己关闭抗锯齿，绘制完也不需要恢复状态
+    m_view->setRenderHint(QPainter::SmoothPixmapTransform);
+    m_view->setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
     m_view->setDragMode(QGraphicsView::ScrollHandDrag);
     m_view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     m_view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -40,16 +57,89 @@ ImageViewer::ImageViewer(const QPixmap& pixmap, QWidget* parent) : QDialog(paren
 
     m_view->viewport()->installEventFilter(this);
 
-    m_item = new QGraphicsPixmapItem(pixmap);
+    // 预览图优先用调用方给的，其次是内存中已有的缩略图
+    QPixmap initial = preview;
+    if (initial.isNull() && !path.isEmpty()) {
+        initial = ImageLoader::instance().cachedThumbnail(path, ThumbnailTier::Medium);
+        if (initial.isNull()) initial = ImageLoader::instance().cachedThumbnail(path, ThumbnailTier::Small);
+    }
+
+    // 只读文件头取得原图尺寸，场景从一开始就按原图坐标布置
+    QSize imageSize;
+    if (!path.isEmpty()) {
+        QImageReader reader(path);
+        imageSize = reader.size();
+        if (reader.transformation() & QImageIOHandler::TransformationRotate90) imageSize.transpose();
+    }
+    if (imageSize.isEmpty()) imageSize = initial.size();
+    if (imageSize.isEmpty()) imageSize = QSize(1, 1);
+
+    m_item = new TiledImageItem(imageSize, initial);
     m_scene->addItem(m_item);
+    m_scene->setSceneRect(m_item->boundingRect());
 
     layout->addWidget(m_view);
 
+    if (initial.isNull() && !path.isEmpty()) {
+        ImageLoader::instance().loadThumbnail(path, ThumbnailTier::Medium, this, ImagePriority::High)
+            .then(this, [this](const QPixmap& pix) {
+                if (!pix.isNull()) m_item->setPreview(pix);
+            });
+    }
+
+    buildPyramid(path, initial);
+
     QTimer::singleShot(0, this, [=](){
         fitImageToWindow();
     });
 }
 
+/**
+ * @brief 析构函数
+ */
+ImageViewer::~ImageViewer() {
+    *m_cancelled = true;
+}
+
+/**
+ * @brief 在后台构建瓦片金字塔
+ * @param path 原图路径，为空时使用预览图
+ * @param preview 预览图
+ */
+void ImageViewer::buildPyramid(const QString& path, const QPixmap& preview) {
+    if (path.isEmpty() && preview.isNull()) return;
+
+    QPointer<ImageViewer> self(this);
+    std::shared_ptr<std::atomic_bool> cancelled = m_cancelled;
+    const QImage source = path.isEmpty() ? preview.toImage() : QImage();
+
+    QThreadPool::globalInstance()->start([self, cancelled, path, source]() {
+        std::shared_ptr<const TilePyramid> pyramid = path.isEmpty()
+            ? TilePyramid::fromImage(source, cancelled.get())
+            : TilePyramid::fromFile(path, cancelled.get());
+
+        if (!pyramid) return;
+
+        // 查看器可能随时在 GUI 线程被删除，投递到应用对象，回到 GUI 线程后再检查
+        QMetaObject::invokeMethod(qApp, [self, pyramid]() {
+            if (!self) return;
+            self->onPyramidReady(pyramid);
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief 瓦片金字塔构建完成
+ * @param pyramid 金字塔
+ */
+void ImageViewer::onPyramidReady(std::shared_ptr<const TilePyramid> pyramid) {
+    m_item->setPyramid(std::move(pyramid));
+    m_scene->setSceneRect(m_item->boundingRect());
+
+    // 文件头读不出尺寸时场景按预览图估计，原图就绪后按实际尺寸重新适配
+    if (m_isFitWindow) fitImageToWindow();
+}
+
 void ImageViewer::fitImageToWindow() {
     if (!m_item || !m_view) return;
 
@@ -95,6 +185,10 @@ bool ImageViewer::eventFilter(QObject *watched, QEvent *event) {
             factor = 1.0 / 1.15;
         }
 
+        // 只改变视图变换，图元按新比例选层绘制可见瓦片
+        const qreal zoom = m_view->transform().m11() * factor;
+        if (zoom > kMaxZoom || zoom < kMinZoom) return true;
+
         m_view->scale(factor, factor);
 
         return true;
@@ -3,6 +3,7 @@
  * @brief 图片查看器组件头文件
  * 
  * 该文件定义了ImageViewer类，提供图片查看功能，支持自适应显示、缩放和双击还原。
+ * 窗口先显示缓存中的缩略图，原图在后台解码并切成瓦片金字塔后再替换，任意尺寸的图片都能流畅平移缩放。
  * 
  * @author CloudArt Team
  * @version 1.0
@@ -13,22 +14,36 @@
 #include <QDialog>
 #include <QGraphicsView>
 #include <QGraphicsScene>
-#include <QGraphicsPixmapItem>
+#include <QPixmap>
+#include <atomic>
+#include <memory>
+
+class TiledImageItem;
+class TilePyramid;
 
 /**
  * @brief 图片查看器类
  * 
  * 继承自QDialog，提供图片查看功能，支持自适应显示、鼠标滚轮缩放和双击还原操作。
+ * 构造时不解码原图：缩放只改变视图变换，每帧只绘制可见区域内对应层级的瓦片。
  */
 class ImageViewer : public QDialog {
     Q_OBJECT
 public:
     /**
      * @brief 构造函数
-     * @param pixmap 要显示的图片
+     * @param path 原图路径，为空时直接以预览图作为原图
+     * @param preview 原图就绪前显示的预览图，为空时从缩略图缓存中取
      * @param parent 父窗口指针
      */
-    explicit ImageViewer(const QPixmap& pixmap, QWidget* parent = nullptr);
+    explicit ImageViewer(const QString& path, const QPixmap& preview = QPixmap(), QWidget* parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     *
+     * 通知尚未完成的瓦片构建放弃
+     */
+    ~ImageViewer();
 
 protected:
     /**
@@ -65,10 +80,27 @@ private:
      */
     void fitImageToWindow();
 
+    /**
+     * @brief 在后台构建瓦片金字塔
+     * @param path 原图路径，为空时使用预览图
+     * @param preview 预览图
+     */
+    void buildPyramid(const QString& path, const QPixmap& preview);
+
+    /**
+     * @brief 瓦片金字塔构建完成
+     * @param pyramid 金字塔
+     */
+    void onPyramidReady(std::shared_ptr<const TilePyramid> pyramid);
+
 private:
     QGraphicsView* m_view = nullptr;          ///< 图形视图窗口
     QGraphicsScene* m_scene = nullptr;        ///< 图形场景容器
-    QGraphicsPixmapItem* m_item = nullptr;    ///< 图片图元对象
+    TiledImageItem* m_item = nullptr;         ///< 图片图元对象
+    std::shared_ptr<std::atomic_bool> m_cancelled; ///< 窗口关闭后置位，后台构建随之放弃
+
+    static constexpr qreal kMaxZoom = 32.0;   ///< 最大放大倍数（原图像素）
+    static constexpr qreal kMinZoom = 0.01;   ///< 最小缩小倍数
 
     /**
      * @brief 自适应窗口模式标记
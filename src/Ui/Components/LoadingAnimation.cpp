@@ -0,0 +1,115 @@
+/**
+ * @file LoadingAnimation.cpp
+ * @brief 共享加载动画实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "LoadingAnimation.h"
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QDebug>
+
+namespace {
+const char* kAnimationPath = ":/images/loading.gif";
+const int kMinDelayMs = 20;      ///< 帧间隔下限，避免异常的 0 延迟占满 CPU
+const int kDefaultDelayMs = 100; ///< 动画未声明帧间隔时使用
+}
+
+/**
+ * @brief 获取单例实例
+ * @return LoadingAnimation& 动画单例引用
+ */
+LoadingAnimation& LoadingAnimation::instance()
+{
+    static LoadingAnimation animation;
+    return animation;
+}
+
+/**
+ * @brief 私有构造函数
+ */
+LoadingAnimation::LoadingAnimation()
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &LoadingAnimation::advance);
+}
+
+/**
+ * @brief 当前帧
+ * @return QPixmap 当前帧
+ */
+QPixmap LoadingAnimation::currentFrame() const
+{
+    if (m_frames.isEmpty()) return QPixmap();
+    return m_frames[m_current];
+}
+
+/**
+ * @brief 订阅动画
+ * @param owner 订阅者
+ */
+void LoadingAnimation::subscribe(QObject* owner)
+{
+    if (!owner || m_subscribers.contains(owner)) return;
+
+    if (!m_loaded) loadFrames();
+
+    m_subscribers.insert(owner);
+    connect(owner, &QObject::destroyed, this, [this, owner]() { unsubscribe(owner); });
+
+    if (!m_timer.isActive() && m_frames.size() > 1) {
+        m_timer.start(m_delays[m_current]);
+    }
+}
+
+/**
+ * @brief 退订动画
+ * @param owner 订阅者
+ */
+void LoadingAnimation::unsubscribe(QObject* owner)
+{
+    if (!m_subscribers.remove(owner)) return;
+
+    disconnect(owner, &QObject::destroyed, this, nullptr);
+    if (m_subscribers.isEmpty()) m_timer.stop();
+}
+
+/**
+ * @brief 解码全部帧
+ */
+void LoadingAnimation::loadFrames()
+{
+    m_loaded = true;
+
+    const qreal dpr = qGuiApp ? qGuiApp->devicePixelRatio() : 1.0;
+    const QSize pixels = frameSize() * dpr;
+
+    QImageReader reader(kAnimationPath);
+    QImage frame;
+    while (reader.read(&frame)) {
+        QPixmap pix = QPixmap::fromImage(frame.scaled(pixels, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        pix.setDevicePixelRatio(dpr);
+        m_frames.append(pix);
+
+        const int delay = reader.nextImageDelay();
+        m_delays.append(delay > 0 ? qMax(delay, kMinDelayMs) : kDefaultDelayMs);
+    }
+
+    if (m_frames.isEmpty()) {
+        qDebug() << "加载动画解码失败:" << reader.errorString();
+    }
+}
+
+/**
+ * @brief 切换到下一帧并安排下一次换帧
+ */
+void LoadingAnimation::advance()
+{
+    if (m_frames.size() < 2 || m_subscribers.isEmpty()) return;
+
+    m_current = (m_current + 1) % m_frames.size();
+    emit frameChanged();
+    m_timer.start(m_delays[m_current]);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file LoadingAnimation.h
+ * @brief 共享加载动画头文件
+ *
+ * 该文件定义了LoadingAnimation类，全局只解码一次加载动画的帧，并由一个定时器驱动换帧，
+ * 所有加载占位在绘制时取同一帧。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * @brief 共享加载动画类
+ *
+ * 单例，只在 GUI 线程使用。有订阅者时定时器才运行，最后一个订阅者退订或销毁后立即停止。
+ * 帧在首次订阅时预先缩放到显示尺寸，换帧只发出 frameChanged，由订阅者决定重绘哪些区域。
+ */
+class LoadingAnimation : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 获取单例实例
+     * @return LoadingAnimation& 动画单例引用
+     */
+    static LoadingAnimation& instance();
+
+    /**
+     * @brief 显示尺寸
+     * @return QSize 每帧的逻辑尺寸
+     */
+    static QSize frameSize() { return QSize(40, 40); }
+
+    /**
+     * @brief 当前帧
+     * @return QPixmap 当前帧，动画资源无法加载时为空
+     */
+    QPixmap currentFrame() const;
+
+    /**
+     * @brief 订阅动画
+     * @param owner 订阅者，销毁时自动退订
+     */
+    void subscribe(QObject* owner);
+
+    /**
+     * @brief 退订动画
+     * @param owner 订阅者
+     */
+    void unsubscribe(QObject* owner);
+
+signals:
+    /**
+     * @brief 换帧信号
+     */
+    void frameChanged();
+
+private:
+    /**
+     * @brief 私有构造函数
+     */
+    LoadingAnimation();
+
+    /**
+     * @brief 解码全部帧
+     */
+    void loadFrames();
+
+    /**
+     * @brief 切换到下一帧并安排下一次换帧
+     */
+    void advance();
+
+private:
+    QVector<QPixmap> m_frames;      ///< 预缩放的帧
+    QVector<int> m_delays;          ///< 每帧停留时间（毫秒）
+    int m_current = 0;              ///< 当前帧序号
+    bool m_loaded = false;          ///< 是否已尝试解码
+    QTimer m_timer;                 ///< 唯一的换帧定时器
+    QSet<QObject*> m_subscribers;   ///< 当前订阅者
+};
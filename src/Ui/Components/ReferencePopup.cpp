@@ -10,6 +10,7 @@
  */
 
 #include "ReferencePopup.h"
+#include "../../Core/ImageLoader.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -22,6 +23,9 @@
 #include <QPainterPath>
 #include <QStandardPaths>
 #include <QFileInfo>
+#include <QKeyEvent>
+#include <QClipboard>
+#include <QApplication>
 
 /**
  * @brief 构造函数
@@ -68,7 +72,7 @@ void ReferencePopup::setupUi() {
     QVBoxLayout* emptyLayout = new QVBoxLayout(m_pageEmpty);
     emptyLayout->setContentsMargins(0, 10, 0, 0);
 
-    QLabel* lblDropZone = new QLabel("拖拽图片到此处\n\n或", m_pageEmpty);
+    QLabel* lblDropZone = new QLabel("拖拽图片到此处 / Ctrl+V 粘贴\n\n或", m_pageEmpty);
     lblDropZone->setAlignment(Qt::AlignCenter);
     lblDropZone->setStyleSheet(
         "QLabel { "
@@ -116,8 +120,10 @@ void ReferencePopup::setupUi() {
         "QPushButton:hover { background-color: #991b1b; }"
         );
     connect(btnRemove, &QPushButton::clicked, this, [=](){
+        ++m_loadSerial;
         m_currentImage = QPixmap();
         m_currentPath.clear();
+        m_pastedImage = QImage();
         updateUiState();
     });
 
@@ -188,17 +194,64 @@ void ReferencePopup::dropEvent(QDropEvent *event) {
  * @param path 图片路径
  */
 void ReferencePopup::loadImage(const QString& path) {
-    QPixmap img(path);
-    if (img.isNull()) return;
+    const int serial = ++m_loadSerial;
+
+    // 上传按路径读取原文件，这里只需解到聊天气泡的显示尺寸
+    ImageLoader::instance().load(path, QSize(512, 512), this, ImagePriority::High)
+        .then(this, [this, path, serial](const QPixmap& img) {
+            // 加载期间又换了图或移除了参考图
+            if (serial != m_loadSerial || img.isNull()) return;
+
+            m_currentPath = path;
+            m_currentImage = img;
+            m_pastedImage = QImage();
+
+            QSize targetSize = m_lblPreview->size();
+            if (targetSize.isEmpty()) targetSize = QSize(280, 150);
+
+            QPixmap scaled = img.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            m_lblPreview->setPixmap(scaled);
+
+            updateUiState();
+        });
+}
+
+/**
+ * @brief 按键事件
+ * @param event 按键事件对象
+ */
+void ReferencePopup::keyPressEvent(QKeyEvent *event) {
+    if (event->matches(QKeySequence::Paste)) {
+        pasteFromClipboard();
+        event->accept();
+        return;
+    }
+    QWidget::keyPressEvent(event);
+}
+
+/**
+ * @brief 从剪贴板粘贴图片
+ *
+ * 剪贴板里是文件时按文件加载；是位图时只保存在内存中，上传时直接编码发送。
+ */
+void ReferencePopup::pasteFromClipboard() {
+    const QMimeData* mime = QApplication::clipboard()->mimeData();
+    if (!mime) return;
 
-    m_currentPath = path;
-    m_currentImage = img;
+    if (mime->hasUrls() && !mime->urls().isEmpty() && mime->urls().first().isLocalFile()) {
+        loadImage(mime->urls().first().toLocalFile());
+        return;
+    }
 
-    QSize targetSize = m_lblPreview->size();
-    if (targetSize.isEmpty()) targetSize = QSize(280, 150);
+    if (!mime->hasImage()) return;
 
-    QPixmap scaled = img.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    m_lblPreview->setPixmap(scaled);
+    QImage img = qvariant_cast<QImage>(mime->imageData());
+    if (img.isNull()) return;
+
+    ++m_loadSerial;
+    m_currentPath.clear();
+    m_pastedImage = img;
+    m_currentImage = QPixmap::fromImage(img);
 
     updateUiState();
 }
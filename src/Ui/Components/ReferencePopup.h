@@ -13,6 +13,7 @@
 #pragma once
 #include <QWidget>
 #include <QPixmap>
+#include <QImage>
 
 class QLabel;
 class QStackedLayout;
@@ -52,9 +53,15 @@ public:
     
     /**
      * @brief 获取图片路径
-     * @return QString 图片文件路径
+     * @return QString 图片文件路径（剪贴板粘贴的图片为空）
      */
     QString currentPath() const { return m_currentPath; }
+
+    /**
+     * @brief 获取剪贴板粘贴的原始图片
+     * @return QImage 粘贴的图片，来自本地文件时为空
+     */
+    QImage pastedImage() const { return m_pastedImage; }
     
     /**
      * @brief 检查是否有图片
@@ -75,6 +82,14 @@ protected:
      */
     void dropEvent(QDropEvent *event) override;
 
+    /**
+     * @brief 按键事件处理
+     * @param event 按键事件
+     *
+     * 支持 Ctrl+V 直接粘贴剪贴板中的图片。
+     */
+    void keyPressEvent(QKeyEvent *event) override;
+
 private:
     /**
      * @brief 初始化UI布局
@@ -86,6 +101,11 @@ private:
      * @param path 图片文件路径
      */
     void loadImage(const QString& path);
+
+    /**
+     * @brief 从剪贴板粘贴图片
+     */
+    void pasteFromClipboard();
     
     /**
      * @brief 切换UI状态
@@ -96,6 +116,8 @@ private:
     // 数据
     QPixmap m_currentImage; ///< 当前图片数据
     QString m_currentPath = ""; ///< 当前图片路径
+    QImage m_pastedImage; ///< 剪贴板粘贴的图片（不落盘，直接上传）
+    int m_loadSerial = 0; ///< 加载序号，换图或移除后丢弃旧的异步加载结果
 
     // UI 组件
     QStackedLayout* m_stackLayout = nullptr; ///< 堆叠布局，用于界面切换
@@ -0,0 +1,147 @@
+/**
+ * @file SessionItemDelegate.cpp
+ * @brief 会话行绘制代理实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "SessionItemDelegate.h"
+#include "Theme.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QLineEdit>
+
+namespace {
+const int kRowHeight = 50;    ///< 行高
+const int kTitleLeft = 10;    ///< 标题左边距
+const int kButtonSide = 30;   ///< 选项按钮边长
+const int kButtonRight = 5;   ///< 选项按钮右边距
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+SessionItemDelegate::SessionItemDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+/**
+ * @brief 行尺寸
+ * @param option 样式选项
+ * @param index 条目索引
+ * @return QSize 固定行高
+ */
+QSize SessionItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(index)
+    return QSize(option.rect.width(), kRowHeight);
+}
+
+/**
+ * @brief 选项按钮区域
+ * @param rowRect 行区域
+ * @return QRect 按钮区域
+ */
+QRect SessionItemDelegate::optionButtonRect(const QRect& rowRect)
+{
+    QRect rect(0, 0, kButtonSide, kButtonSide);
+    rect.moveCenter(QPoint(rowRect.right() - kButtonRight - kButtonSide / 2, rowRect.center().y()));
+    return rect;
+}
+
+/**
+ * @brief 绘制会话行
+ * @param painter 绘制器
+ * @param option 样式选项
+ * @param index 条目索引
+ */
+void SessionItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    const QRect rect = option.rect;
+    const bool selected = option.state & QStyle::State_Selected;
+    const bool hovered = option.state & QStyle::State_MouseOver;
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    QPainterPath shape;
+    shape.addRoundedRect(QRectF(rect).adjusted(0.5, 0.5, -0.5, -0.5), Theme::kCardRadius, Theme::kCardRadius);
+
+    if (selected) {
+        painter->fillPath(shape, Theme::kSurfaceSelected);
+        painter->setPen(QPen(Theme::kBorderSelected, 1));
+        painter->drawPath(shape);
+    } else if (hovered) {
+        painter->fillPath(shape, Theme::kSurface);
+    }
+
+    const QRect button = optionButtonRect(rect);
+    QRect titleRect = rect.adjusted(kTitleLeft, 0, 0, 0);
+    titleRect.setRight(button.left() - kButtonRight);
+
+    QFont font = option.font;
+    font.setPixelSize(13);
+    painter->setFont(font);
+    painter->setPen(Theme::kText);
+
+    const QString title = index.data(Qt::DisplayRole).toString();
+    painter->drawText(titleRect, Qt::AlignVCenter | Qt::AlignLeft,
+                      painter->fontMetrics().elidedText(title, Qt::ElideRight, titleRect.width()));
+
+    if (hovered) {
+        QPainterPath buttonShape;
+        buttonShape.addRoundedRect(QRectF(button), 4, 4);
+        painter->fillPath(buttonShape, Theme::kControl);
+
+        font.setBold(true);
+        painter->setFont(font);
+        painter->drawText(button, Qt::AlignCenter, "···");
+    }
+
+    painter->restore();
+}
+
+/**
+ * @brief 创建行内重命名编辑框
+ * @param parent 父窗口
+ * @param option 样式选项
+ * @param index 条目索引
+ * @return QWidget* 编辑框
+ */
+QWidget* SessionItemDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(option)
+    Q_UNUSED(index)
+
+    QLineEdit* editor = new QLineEdit(parent);
+    editor->setStyleSheet(
+        "QLineEdit { "
+        "   background-color: #2A2B32; "
+        "   border: 1px solid #19C37D; "
+        "   border-radius: 5px; "
+        "   color: white; "
+        "   font-size: 13px; "
+        "   padding-left: 6px;"
+        "}"
+        );
+    return editor;
+}
+
+/**
+ * @brief 设置编辑框位置
+ * @param editor 编辑框
+ * @param option 样式选项
+ * @param index 条目索引
+ */
+void SessionItemDelegate::updateEditorGeometry(QWidget* editor, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(index)
+
+    QRect rect = option.rect.adjusted(kTitleLeft / 2, 0, -kButtonRight, 0);
+    rect.setHeight(32);
+    rect.moveCenter(QPoint(rect.center().x(), option.rect.center().y()));
+    editor->setGeometry(rect);
+}
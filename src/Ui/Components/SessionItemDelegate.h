@@ -0,0 +1,72 @@
+/**
+ * @file SessionItemDelegate.h
+ * @brief 会话行绘制代理头文件
+ *
+ * 该文件定义了SessionItemDelegate类，负责在会话列表中绘制会话行和行内重命名编辑框。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QStyledItemDelegate>
+
+/**
+ * @brief 会话行绘制代理类
+ *
+ * 所有行等高，每行只绘制背景、省略后的标题和悬停时的“···”选项按钮，
+ * 绘制开销与会话总数无关。
+ */
+class SessionItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit SessionItemDelegate(QObject* parent = nullptr);
+
+    /**
+     * @brief 绘制会话行
+     * @param painter 绘制器
+     * @param option 样式选项
+     * @param index 条目索引
+     */
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 行尺寸
+     * @param option 样式选项
+     * @param index 条目索引
+     * @return QSize 固定行高
+     */
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 创建行内重命名编辑框
+     * @param parent 父窗口
+     * @param option 样式选项
+     * @param index 条目索引
+     * @return QWidget* 编辑框
+     */
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 设置编辑框位置
+     * @param editor 编辑框
+     * @param option 样式选项
+     * @param index 条目索引
+     */
+    void updateEditorGeometry(QWidget* editor, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief 选项按钮区域
+     * @param rowRect 行区域
+     * @return QRect 按钮区域，用于点击命中判断
+     */
+    static QRect optionButtonRect(const QRect& rowRect);
+};
@@ -10,15 +10,66 @@
  */
 
 #include "SessionList.h"
-#include "SessionItem.h"
+#include "SessionItemDelegate.h"
+#include "../../Model/SessionFilterModel.h"
 #include <QPushButton>
 #include <QLabel>
+#include <QListView>
 #include <QScrollArea>
 #include <QScrollBar>
+#include <QLineEdit>
+#include <QTimer>
+#include <QMouseEvent>
+#include <QDateTime>
+#include <QMenu>
+#include <QMessageBox>
+#include <QApplication>
+#include <QClipboard>
+#include "../../Database/DatabaseManager.h"
+
+static const int kSearchPageSize = 30;
 
+/**
+ * @brief 搜索结果条目
+ *
+ * 显示会话标题与高亮后的命中片段，点击后跳转到对应会话
+ */
+class SearchResultItem : public QLabel
+{
+public:
+    std::function<void()> onClick;
+
+    SearchResultItem(const SearchHit& hit, QWidget* parent = nullptr)
+        : QLabel(parent)
+    {
+        QString who = (hit.role == MessageRole::User) ? "提示词" : "反推";
+        QString when = QDateTime::fromMSecsSinceEpoch(hit.timestamp).toString("yyyy-MM-dd");
+
+        this->setText(QString("<div style='color:#8E8EA0; font-size:11px;'>%1 · %2 · %3</div>"
+                              "<div style='color:#ECECF1; font-size:12px;'>%4</div>")
+                          .arg(hit.sessionTitle.toHtmlEscaped(), who, when, hit.snippet));
+        this->setTextFormat(Qt::RichText);
+        this->setWordWrap(true);
+        this->setCursor(Qt::PointingHandCursor);
+        this->setStyleSheet(
+            "QLabel { background: transparent; border: none; border-radius: 6px; padding: 6px; }"
+            "QLabel:hover { background-color: #2A2B32; }"
+            );
+    }
+
+protected:
+    void mousePressEvent(QMouseEvent* event) override {
+        if (event->button() == Qt::LeftButton && onClick) onClick();
+        QLabel::mousePressEvent(event);
+    }
+};
+
+/**
+ * @brief 构造函数
+ * @param parent 父窗口指针
+ */
 SessionList::SessionList(QWidget *parent)
     : QWidget(parent)
-    , m_currentSessionItem(nullptr)
 {
     setupUi();
 }
@@ -56,15 +107,42 @@ void SessionList::setupUi()
     connect(m_btnNew, &QPushButton::clicked, this, &SessionList::createNewSessionRequest);
 
     topLayout->addWidget(m_btnNew);
+
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText("🔍 搜索提示词 / 反推文本");
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchEdit->setFixedHeight(32);
+    m_searchEdit->setStyleSheet(
+        "QLineEdit { "
+        "   background-color: #2A2B32; "
+        "   border: 1px solid #565869; "
+        "   border-radius: 5px; "
+        "   color: white; "
+        "   padding-left: 8px;"
+        "}"
+        "QLineEdit:focus { border: 1px solid #19C37D; }"
+        );
+    topLayout->addWidget(m_searchEdit);
+
+    m_searchTimer = new QTimer(this);
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(250);
+    connect(m_searchTimer, &QTimer::timeout, this, &SessionList::runSearch);
+    // 标题过滤只比较内存中的折叠标题，随输入即时生效；全文搜索仍经过防抖
+    connect(m_searchEdit, &QLineEdit::textChanged, this, [this](const QString& text){
+        m_filterModel->setFilterText(text);
+        updateSessionVisibility();
+        m_searchTimer->start();
+    });
+
     rootLayout->addWidget(topContainer);
 
-    QScrollArea* scrollArea = new QScrollArea(this);
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    scrollArea->setFrameShape(QFrame::NoFrame);
+    m_sessionTitle = new QLabel("最近历史", this);
+    m_sessionTitle->setStyleSheet("color: #8E8EA0; font-size: 12px; margin-left: 10px; border: none;");
+    rootLayout->addWidget(m_sessionTitle);
 
-    scrollArea->setStyleSheet(
-        "QScrollArea { "
+    const QString scrollStyle = QString(
+        "QScrollArea, QListView { "
         "   background: transparent; "
         "   border: none; "
         "}"
@@ -95,91 +173,295 @@ void SessionList::setupUi()
         "}"
         );
 
-    QWidget* scrollContent = new QWidget();
-    scrollContent->setStyleSheet("background: transparent;");
+    m_filterModel = new SessionFilterModel(this);
+
+    m_sessionView = new QListView(this);
+    m_sessionView->setModel(m_filterModel);
+    m_sessionView->setItemDelegate(new SessionItemDelegate(m_sessionView));
+    m_sessionView->setUniformItemSizes(true);
+    m_sessionView->setSpacing(3);
+    m_sessionView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_sessionView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_sessionView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_sessionView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_sessionView->setFrameShape(QFrame::NoFrame);
+    m_sessionView->setMouseTracking(true);
+    m_sessionView->viewport()->setAttribute(Qt::WA_Hover);
+    m_sessionView->viewport()->installEventFilter(this);
+    m_sessionView->setStyleSheet(scrollStyle);
+    rootLayout->addWidget(m_sessionView, 1);
+
+    m_hoverTimer = new QTimer(this);
+    m_hoverTimer->setSingleShot(true);
+    m_hoverTimer->setInterval(120);
+    // 鼠标在会话上停留片刻后再预取历史，快速划过时不触发查询
+    connect(m_hoverTimer, &QTimer::timeout, this, [this](){
+        if (m_hoverId != -1) emit sessionHovered(m_hoverId);
+    });
+    connect(m_sessionView, &QAbstractItemView::entered, this, [this](const QModelIndex& index){
+        m_hoverId = index.data(SessionModel::IdRole).toInt();
+        m_hoverTimer->start();
+    });
+
+    m_searchScroll = new QScrollArea(this);
+    m_searchScroll->setWidgetResizable(true);
+    m_searchScroll->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_searchScroll->setFrameShape(QFrame::NoFrame);
+    m_searchScroll->setStyleSheet(scrollStyle);
 
-    m_scrollLayout = new QVBoxLayout(scrollContent);
-    m_scrollLayout->setContentsMargins(10, 10, 10, 10);
-    m_scrollLayout->setSpacing(5);
+    QWidget* searchContent = new QWidget();
+    searchContent->setStyleSheet("background: transparent;");
 
-    QLabel* labelTitle = new QLabel("最近历史", scrollContent);
-    labelTitle->setStyleSheet("color: #8E8EA0; font-size: 12px; margin-bottom: 5px; border: none;");
-    m_scrollLayout->addWidget(labelTitle);
+    m_searchLayout = new QVBoxLayout(searchContent);
+    m_searchLayout->setContentsMargins(10, 10, 10, 10);
+    m_searchLayout->setSpacing(5);
+    m_searchLayout->addStretch();
 
-    scrollArea->setWidget(scrollContent);
-    rootLayout->addWidget(scrollArea);
+    m_searchScroll->setWidget(searchContent);
+    m_searchScroll->hide();
+    rootLayout->addWidget(m_searchScroll, 2);
 
-    m_scrollLayout->addStretch();
+    // 滚动到底部附近时加载下一页结果
+    connect(m_searchScroll->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value){
+        if (m_searchScroll->verticalScrollBar()->maximum() - value < 200) loadMoreSearchResults();
+    });
 }
 
-void SessionList::addSession(int id, const QString& title)
+/**
+ * @brief 执行全文搜索（防抖定时器超时后调用）
+ *
+ * 清空旧结果并查询第一页；输入已变化时通过序号丢弃过期的返回
+ */
+void SessionList::runSearch()
 {
-    SessionItem* item = new SessionItem(id, title, this);
+    const QString text = m_searchEdit->text().trimmed();
+    const int serial = ++m_searchSerial;
 
-    connect(item, &SessionItem::itemClicked, this, [=](SessionItem* clickedItem){
-        handleItemSelection(clickedItem);
-        emit sessionSwitchRequest(clickedItem->id());
-    });
+    clearSearchResults();
 
-    connect(item, &SessionItem::itemRenamed, this, [=](int itemId, const QString& newName){
-        emit sessionRenameRequest(itemId, newName);
-    });
+    if (text.isEmpty()) {
+        m_searchText.clear();
+        m_searchScroll->hide();
+        return;
+    }
+
+    m_searchText = text;
+    m_searchWindow = SearchWindow();
+    m_searchOffset = 0;
+    m_searchHasMore = false;
+    m_searchLoading = true;
+
+    m_searchScroll->show();
 
-    connect(item, &SessionItem::itemDeleted, this, [=](int deletedId){
-        if (m_currentSessionItem == item) {
-            m_currentSessionItem = nullptr;
+    DatabaseManager::instance().search(text, 0, kSearchPageSize).then(this, [this, serial](const SearchPage& page) {
+        if (serial != m_searchSerial) return;
+
+        if (page.hits.isEmpty()) {
+            m_searchLoading = false;
+            QLabel* empty = new QLabel("没有找到相关内容", m_searchScroll->widget());
+            empty->setStyleSheet("color: #666; font-size: 12px; margin-top: 20px; border: none;");
+            empty->setAlignment(Qt::AlignHCenter);
+            m_searchLayout->insertWidget(m_searchLayout->count() - 1, empty);
+            return;
         }
-        emit sessionDeleteRequest(deletedId);
 
-        m_scrollLayout->removeWidget(item);
-        item->deleteLater();
+        appendSearchResults(page);
     });
+}
 
-    m_items.append(item);
+/**
+ * @brief 加载下一页搜索结果
+ *
+ * 沿用第一页确定的搜索窗口，正在加载或没有更多结果时忽略
+ */
+void SessionList::loadMoreSearchResults()
+{
+    if (m_searchLoading || !m_searchHasMore || m_searchText.isEmpty()) return;
 
-    m_scrollLayout->insertWidget(m_scrollLayout->count() - 1, item);
+    const int serial = m_searchSerial;
+    m_searchLoading = true;
 
-    if (m_currentSessionItem == nullptr) {
-        handleItemSelection(item);
-    }
+    DatabaseManager::instance().search(m_searchText, m_searchOffset, kSearchPageSize, m_searchWindow)
+        .then(this, [this, serial](const SearchPage& page) {
+            if (serial != m_searchSerial) return;
+            appendSearchResults(page);
+        });
 }
 
-void SessionList::handleItemSelection(SessionItem* clickedItem)
+/**
+ * @brief 把一页搜索结果追加到结果列表
+ * @param page 搜索结果页，其窗口和条数决定下一页的偏移与是否还有更多
+ */
+void SessionList::appendSearchResults(const SearchPage& page)
 {
-    if (m_currentSessionItem == clickedItem) return;
-    if (m_currentSessionItem) m_currentSessionItem->setSelected(false);
-    if (clickedItem) clickedItem->setSelected(true);
-    m_currentSessionItem = clickedItem;
+    m_searchWindow = page.window;
+    m_searchOffset += page.hits.size();
+    m_searchHasMore = (page.hits.size() == kSearchPageSize);
+    m_searchLoading = false;
+
+    for (const SearchHit& hit : page.hits) {
+        SearchResultItem* item = new SearchResultItem(hit, m_searchScroll->widget());
+
+        int sessionId = hit.sessionId;
+        int messageId = hit.messageId;
+        item->onClick = [this, sessionId, messageId](){
+            selectSession(sessionId);
+            emit searchResultActivated(sessionId, messageId);
+        };
+
+        m_searchLayout->insertWidget(m_searchLayout->count() - 1, item);
+    }
 }
 
-void SessionList::clear()
+/**
+ * @brief 清空搜索结果列表（保留末尾的伸缩项）
+ */
+void SessionList::clearSearchResults()
 {
-    m_currentSessionItem = nullptr;
-
-    for (auto* item : m_items) {
-        m_scrollLayout->removeWidget(item);
+    while (m_searchLayout->count() > 1) {
+        QLayoutItem* item = m_searchLayout->takeAt(0);
+        if (item->widget()) {
+            delete item->widget();
+        }
         delete item;
     }
-    m_items.clear();
 }
 
-void SessionList::loadSessions(const QVector<SessionData>& sessions)
+/**
+ * @brief 设置会话模型
+ * @param model 会话列表模型，经标题过滤模型后显示
+ */
+void SessionList::setModel(SessionModel* model)
+{
+    m_model = model;
+    m_filterModel->setSourceModel(model);
+    updateSessionVisibility();
+}
+
+/**
+ * @brief 根据标题过滤结果显示或隐藏会话列表
+ */
+void SessionList::updateSessionVisibility()
+{
+    // 搜索时没有标题命中就把空间让给消息搜索结果
+    const bool visible = m_searchEdit->text().trimmed().isEmpty() || m_filterModel->rowCount() > 0;
+    m_sessionTitle->setVisible(visible);
+    m_sessionView->setVisible(visible);
+}
+
+/**
+ * @brief 处理会话列表视口的点击和鼠标离开
+ * @param watched 事件目标
+ * @param event 事件
+ * @return bool 事件是否已处理
+ *
+ * 左键切换会话，右键或选项按钮弹出菜单；鼠标离开时取消悬停预取
+ */
+bool SessionList::eventFilter(QObject* watched, QEvent* event)
 {
-    clear();
+    if (watched == m_sessionView->viewport() && event->type() == QEvent::Leave) {
+        m_hoverId = -1;
+        m_hoverTimer->stop();
+    }
+
+    if (watched == m_sessionView->viewport() && event->type() == QEvent::MouseButtonPress) {
+        auto* mouseEvent = static_cast<QMouseEvent*>(event);
+        const QPoint pos = mouseEvent->position().toPoint();
+        const QModelIndex index = m_sessionView->indexAt(pos);
+        if (!index.isValid()) return true;
+
+        const QRect button = SessionItemDelegate::optionButtonRect(m_sessionView->visualRect(index));
+        if (mouseEvent->button() == Qt::RightButton || button.contains(pos)) {
+            showMenu(index, mouseEvent->globalPosition().toPoint());
+            return true;
+        }
 
-    for (const auto& s : sessions) {
-        addSession(s.id, s.name);
+        if (mouseEvent->button() == Qt::LeftButton) {
+            m_sessionView->setCurrentIndex(index);
+            emit sessionSwitchRequest(index.data(SessionModel::IdRole).toInt());
+            return true;
+        }
     }
+    return QWidget::eventFilter(watched, event);
 }
 
-void SessionList::selectSession(int id)
+/**
+ * @brief 显示会话的右键菜单
+ * @param index 会话条目索引
+ * @param globalPos 菜单弹出的屏幕坐标
+ */
+void SessionList::showMenu(const QModelIndex& index, const QPoint& globalPos)
 {
-    for (SessionItem* item : m_items) {
-        if (item->id() == id) {
-            handleItemSelection(item);
-            return;
+    const QPersistentModelIndex target(index);
+    const int id = index.data(SessionModel::IdRole).toInt();
+    const QString title = index.data(Qt::DisplayRole).toString();
+
+    QMenu menu(this);
+    menu.setStyleSheet("QMenu { background-color: #2D2D2D; color: white; border: 1px solid #555; border-radius: 8px }"
+                       "QMenu::item:selected { background-color: #40414F; }");
+
+    QAction* actRename = menu.addAction("✎ 重命名");
+    connect(actRename, &QAction::triggered, this, [this, target](){
+        if (target.isValid()) m_sessionView->edit(target);
+    });
+
+    QAction* actCopy = menu.addAction("❐ 复制标题");
+    connect(actCopy, &QAction::triggered, this, [title](){
+        QClipboard *clipboard = QApplication::clipboard();
+        clipboard->setText(title);
+    });
+
+    menu.addSeparator();
+
+    QAction* actDelete = menu.addAction("🗑 删除会话");
+    connect(actDelete, &QAction::triggered, this, [this, id](){
+        QMessageBox::StandardButton reply;
+        reply = QMessageBox::question(this, "确认删除", "确定要删除这个会话吗？\n此操作无法撤销。",
+                                      QMessageBox::Yes|QMessageBox::No);
+        if (reply == QMessageBox::Yes) {
+            emit sessionDeleteRequest(id);
         }
+    });
+
+    menu.exec(globalPos);
+}
+
+/**
+ * @brief 选中并滚动到指定会话
+ * @param id 会话ID，被过滤掉或不存在时清除选中
+ */
+void SessionList::selectSession(int id)
+{
+    const int row = m_model ? m_model->rowForId(id) : -1;
+    const QModelIndex index = (row == -1) ? QModelIndex() : m_filterModel->mapFromSource(m_model->index(row));
+
+    if (index.isValid()) {
+        m_sessionView->setCurrentIndex(index);
+        m_sessionView->scrollTo(index);
+    } else {
+        m_sessionView->clearSelection();
+    }
+}
+
+/**
+ * @brief 获取列表中与指定会话相邻的会话
+ * @param id 会话ID
+ * @return QVector<int> 上下相邻且当前可见的会话ID，用于预取
+ */
+QVector<int> SessionList::adjacentSessionIds(int id) const
+{
+    QVector<int> ids;
+    const int row = m_model ? m_model->rowForId(id) : -1;
+    if (row == -1) return ids;
+
+    const QModelIndex index = m_filterModel->mapFromSource(m_model->index(row));
+    if (!index.isValid()) return ids;
+
+    for (int offset : { -1, 1 }) {
+        const QModelIndex neighbour = index.siblingAtRow(index.row() + offset);
+        if (neighbour.isValid()) ids.append(neighbour.data(SessionModel::IdRole).toInt());
     }
+    return ids;
 }
 
 /**
@@ -188,6 +470,6 @@ void SessionList::selectSession(int id)
  */
 int SessionList::getFirstSessionId() const
 {
-    if (m_items.isEmpty()) return -1;
-    return m_items.first()->id();
+    const SessionData* first = m_model ? m_model->sessionAt(0) : nullptr;
+    return first ? first->id : -1;
 }
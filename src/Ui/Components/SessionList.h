@@ -14,18 +14,22 @@
 
 #include <QWidget>
 #include <QVBoxLayout>
-#include <QList>
 #include <QScrollArea>
 #include "../../Model/DataModels.h"
+#include "../../Model/SessionModel.h"
 
-class SessionItem;
+class SessionFilterModel;
+class QListView;
+class QLabel;
 class QPushButton;
+class QLineEdit;
+class QTimer;
 
 /**
  * @brief 会话列表类
  * 
- * 继承自QWidget，管理多个会话项，提供会话的增删改查功能。
- * 支持会话切换、删除、重命名和新建操作。
+ * 继承自QWidget，会话以 QListView + 绘制代理的虚拟化列表展示，只绘制可见行。
+ * 支持会话切换、删除、行内重命名、新建，以及输入即过滤会话标题和全文搜索消息。
  */
 class SessionList : public QWidget
 {
@@ -39,22 +43,12 @@ public:
     explicit SessionList(QWidget *parent = nullptr);
 
     /**
-     * @brief 添加新会话
-     * @param id 会话ID
-     * @param title 会话标题
-     */
-    void addSession(int id, const QString& title);
-
-    /**
-     * @brief 清空列表
-     */
-    void clear();
-
-    /**
-     * @brief 加载会话列表数据
-     * @param sessions 会话数据列表
+     * @brief 设置数据模型
+     * @param model 会话列表模型
+     * 
+     * 列表视图直接跟随模型的插入/更新/删除通知，标题过滤在模型之上的代理中完成
      */
-    void loadSessions(const QVector<SessionData>& sessions);
+    void setModel(SessionModel* model);
 
     /**
      * @brief 通过ID选中指定会话
@@ -64,6 +58,13 @@ public:
      */
     void selectSession(int id);
 
+    /**
+     * @brief 获取列表中与指定会话相邻的会话
+     * @param id 会话ID
+     * @return QVector<int> 上一行和下一行的会话ID（按当前过滤后的顺序）
+     */
+    QVector<int> adjacentSessionIds(int id) const;
+
     /**
      * @brief 获取列表里的第一个会话ID
      * @return int 第一个会话ID，如果没有则返回-1
@@ -84,17 +85,25 @@ signals:
     void sessionDeleteRequest(int id);
 
     /**
-     * @brief 会话重命名请求信号
-     * @param id 目标会话ID
-     * @param newName 新会话名称
+     * @brief 鼠标在会话上停留的信号
+     * @param id 会话ID
+     *
+     * 鼠标在同一行停留超过短暂延时才发出，划过列表不会触发
      */
-    void sessionRenameRequest(int id, const QString& newName);
+    void sessionHovered(int id);
 
     /**
      * @brief 新建会话请求信号
      */
     void createNewSessionRequest();
 
+    /**
+     * @brief 搜索结果点击信号
+     * @param sessionId 命中消息所属的会话ID
+     * @param messageId 命中的消息ID
+     */
+    void searchResultActivated(int sessionId, int messageId);
+
 private:
     /**
      * @brief 初始化UI布局
@@ -102,15 +111,68 @@ private:
     void setupUi();
 
     /**
-     * @brief 处理会话项选择事件
-     * @param clickedItem 被点击的会话项指针
+     * @brief 处理会话列表视口的鼠标事件
+     * @param watched 被监视的对象
+     * @param event 事件
+     * @return bool 是否已处理
+     *
+     * 点击“···”按钮或右键弹出菜单，点击其余位置切换会话
+     */
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+    /**
+     * @brief 显示会话菜单
+     * @param index 会话在视图中的索引
+     * @param globalPos 菜单位置
+     */
+    void showMenu(const QModelIndex& index, const QPoint& globalPos);
+
+    /**
+     * @brief 按过滤结果显示或隐藏会话列表
+     */
+    void updateSessionVisibility();
+
+    /**
+     * @brief 按搜索框内容重新搜索
+     *
+     * 搜索框为空时恢复显示会话列表
+     */
+    void runSearch();
+
+    /**
+     * @brief 加载下一页搜索结果
+     */
+    void loadMoreSearchResults();
+
+    /**
+     * @brief 将一页搜索结果追加到结果列表
+     * @param page 搜索结果及结果范围
+     */
+    void appendSearchResults(const SearchPage& page);
+
+    /**
+     * @brief 清空搜索结果列表
      */
-    void handleItemSelection(SessionItem* clickedItem);
+    void clearSearchResults();
 
 private:
     QVBoxLayout* m_mainLayout = nullptr; ///< 主布局
-    QVBoxLayout* m_scrollLayout = nullptr; ///< 滚动区域布局
     QPushButton* m_btnNew = nullptr; ///< 新建会话按钮
-    SessionItem* m_currentSessionItem = nullptr; ///< 当前选中的会话项指针
-    QList<SessionItem*> m_items; ///< 管理所有Item指针
+    SessionModel* m_model = nullptr; ///< 会话列表模型
+    SessionFilterModel* m_filterModel = nullptr; ///< 标题过滤代理
+    QListView* m_sessionView = nullptr; ///< 会话列表视图
+    QLabel* m_sessionTitle = nullptr; ///< 会话列表标题
+    QTimer* m_hoverTimer = nullptr; ///< 悬停意图延时
+    int m_hoverId = -1; ///< 鼠标所在行的会话ID
+
+    QLineEdit* m_searchEdit = nullptr; ///< 搜索框
+    QTimer* m_searchTimer = nullptr; ///< 输入防抖定时器
+    QScrollArea* m_searchScroll = nullptr; ///< 搜索结果滚动区域
+    QVBoxLayout* m_searchLayout = nullptr; ///< 搜索结果布局
+    QString m_searchText; ///< 当前搜索文本
+    SearchWindow m_searchWindow; ///< 首页确定的结果范围，翻页时传回
+    int m_searchOffset = 0; ///< 已加载的结果数
+    bool m_searchHasMore = false; ///< 是否可能还有更多结果
+    bool m_searchLoading = false; ///< 是否正在加载下一页
+    int m_searchSerial = 0; ///< 搜索序号，用于丢弃过期结果
 };
@@ -11,10 +11,14 @@
 #include <QDialogButtonBox>
 #include <QLabel>
 #include <QSettings>
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QFileDialog>
 
 SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent) {
     setWindowTitle("服务器设置");
-    setFixedSize(400, 200);
+    setFixedSize(400, 300);
 
     QSettings settings("CloudArt", "AppConfig");
     QString savedUrl = settings.value("Server/Url", "http://127.0.0.1:8000").toString();
@@ -33,12 +37,35 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent) {
     tip->setWordWrap(true);
     mainLayout->addWidget(tip);
 
+    m_chkLocalMode = new QCheckBox("ComfyUI 运行在本机（直接读写其目录）", this);
+    m_chkLocalMode->setChecked(settings.value("Server/LocalMode", false).toBool());
+    mainLayout->addWidget(m_chkLocalMode);
+
+    QHBoxLayout* dirLayout = new QHBoxLayout();
+    m_editComfyDir = new QLineEdit(settings.value("Server/ComfyDir").toString(), this);
+    m_editComfyDir->setPlaceholderText("ComfyUI 根目录，例如: D:/ComfyUI");
+    QPushButton* btnBrowse = new QPushButton("浏览...", this);
+    connect(btnBrowse, &QPushButton::clicked, this, [=](){
+        QString dir = QFileDialog::getExistingDirectory(this, "选择 ComfyUI 根目录", m_editComfyDir->text());
+        if (!dir.isEmpty()) m_editComfyDir->setText(dir);
+    });
+    dirLayout->addWidget(m_editComfyDir);
+    dirLayout->addWidget(btnBrowse);
+    mainLayout->addLayout(dirLayout);
+
+    m_editComfyDir->setEnabled(m_chkLocalMode->isChecked());
+    btnBrowse->setEnabled(m_chkLocalMode->isChecked());
+    connect(m_chkLocalMode, &QCheckBox::toggled, m_editComfyDir, &QLineEdit::setEnabled);
+    connect(m_chkLocalMode, &QCheckBox::toggled, btnBrowse, &QPushButton::setEnabled);
+
     mainLayout->addStretch();
 
     QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
     connect(buttons, &QDialogButtonBox::accepted, this, [=](){
         QSettings settings("CloudArt", "AppConfig");
         settings.setValue("Server/Url", m_editUrl->text().trimmed());
+        settings.setValue("Server/LocalMode", m_chkLocalMode->isChecked());
+        settings.setValue("Server/ComfyDir", m_editComfyDir->text().trimmed());
         accept();
     });
     connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
@@ -15,11 +15,13 @@
 #include <QDialog>
 #include <QLineEdit>
 
+class QCheckBox;
+
 /**
  * @brief 设置对话框类
  * 
  * 继承自QDialog，提供应用程序设置界面。
- * 用于配置ComfyUI服务器的连接地址。
+ * 用于配置ComfyUI服务器的连接地址，以及与本机 ComfyUI 同机运行时的直连目录。
  */
 class SettingsDialog : public QDialog
 {
@@ -40,4 +42,6 @@ public:
 
 private:
     QLineEdit* m_editUrl = nullptr; ///< URL输入框
+    QCheckBox* m_chkLocalMode = nullptr; ///< 同机直连开关
+    QLineEdit* m_editComfyDir = nullptr; ///< ComfyUI 根目录输入框
 };
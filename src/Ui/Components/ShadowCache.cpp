@@ -0,0 +1,131 @@
+/**
+ * @file ShadowCache.cpp
+ * @brief 九宫格阴影缓存实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "ShadowCache.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmapCache>
+#include <QImage>
+#include <QVector>
+#include <QtMath>
+#include <qdrawutil.h>
+
+/**
+ * @brief 在圆角矩形下方绘制阴影
+ * @param painter 绘制器
+ * @param rect 投下阴影的圆角矩形
+ * @param radius 圆角半径
+ * @param blur 模糊半径
+ * @param offset 阴影偏移
+ * @param color 阴影颜色
+ */
+void ShadowCache::paint(QPainter* painter, const QRect& rect, int radius, int blur,
+                        const QPoint& offset, const QColor& color)
+{
+    if (rect.isEmpty()) return;
+
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const QPixmap patch = ninePatch(radius, blur, color, dpr);
+
+    // 贴图四角包含圆角和模糊扩散；目标过小时缩小边距，避免九宫格重叠
+    const QRect target = rect.adjusted(-blur, -blur, blur, blur).translated(offset);
+    const int margin = radius + 2 * blur;
+    const int fit = qMin(margin, qMin(target.width(), target.height()) / 2);
+
+    // 源区域和边距按逻辑像素给出，qDrawBorderPixmap 会按贴图的设备像素比换算
+    qDrawBorderPixmap(painter, target, QMargins(fit, fit, fit, fit), patch,
+                      QRect(0, 0, 2 * margin + 1, 2 * margin + 1),
+                      QMargins(margin, margin, margin, margin));
+}
+
+/**
+ * @brief 获取九宫格贴图
+ * @param radius 圆角半径
+ * @param blur 模糊半径
+ * @param color 阴影颜色
+ * @param dpr 设备像素比
+ * @return QPixmap 阴影贴图
+ */
+QPixmap ShadowCache::ninePatch(int radius, int blur, const QColor& color, qreal dpr)
+{
+    const QString key = QString("shadow:%1:%2:%3:%4").arg(radius).arg(blur).arg(color.rgba()).arg(dpr);
+
+    QPixmap cached;
+    if (QPixmapCache::find(key, &cached)) return cached;
+
+    const int side = 2 * (radius + 2 * blur) + 1;
+    const int pixels = qCeil(side * dpr);
+
+    // 先画出不透明的圆角矩形蒙版，再模糊并着色
+    QImage mask(pixels, pixels, QImage::Format_Alpha8);
+    mask.fill(0);
+    {
+        QPainter p(&mask);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.scale(dpr, dpr);
+        QPainterPath shape;
+        shape.addRoundedRect(QRectF(blur, blur, side - 2 * blur, side - 2 * blur), radius, radius);
+        p.fillPath(shape, Qt::black);
+    }
+    blurAlpha(mask, qRound(blur * dpr));
+
+    QImage shadow(pixels, pixels, QImage::Format_ARGB32_Premultiplied);
+    shadow.fill(color);
+    {
+        QPainter p(&shadow);
+        p.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+        p.drawImage(0, 0, mask);
+    }
+
+    cached = QPixmap::fromImage(shadow);
+    cached.setDevicePixelRatio(dpr);
+    QPixmapCache::insert(key, cached);
+    return cached;
+}
+
+/**
+ * @brief 对 Alpha8 图像做三次盒式模糊
+ * @param image 待模糊的图像
+ * @param radius 模糊半径
+ */
+void ShadowCache::blurAlpha(QImage& image, int radius)
+{
+    if (radius <= 0) return;
+
+    const int width = image.width();
+    const int height = image.height();
+    const int window = 2 * radius + 1;
+    QVector<int> line(qMax(width, height));
+
+    auto pass = [&](bool horizontal) {
+        const int outer = horizontal ? height : width;
+        const int inner = horizontal ? width : height;
+
+        for (int o = 0; o < outer; ++o) {
+            auto at = [&](int i) -> uchar& {
+                return horizontal ? image.scanLine(o)[i] : image.scanLine(i)[o];
+            };
+
+            for (int i = 0; i < inner; ++i) line[i] = at(i);
+
+            // 滑动窗口求和，边界外按 0 处理
+            int sum = 0;
+            for (int i = 0; i < qMin(radius, inner); ++i) sum += line[i];
+            for (int i = 0; i < inner; ++i) {
+                if (i + radius < inner) sum += line[i + radius];
+                if (i - radius - 1 >= 0) sum -= line[i - radius - 1];
+                at(i) = uchar(sum / window);
+            }
+        }
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        pass(true);
+        pass(false);
+    }
+}
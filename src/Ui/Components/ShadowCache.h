@@ -0,0 +1,59 @@
+/**
+ * @file ShadowCache.h
+ * @brief 九宫格阴影缓存头文件
+ *
+ * 该文件定义了ShadowCache类，用预先模糊好的九宫格贴图绘制圆角矩形阴影，
+ * 替代每次重绘都要离屏渲染的 QGraphicsDropShadowEffect。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QColor>
+#include <QPixmap>
+#include <QRect>
+
+class QPainter;
+
+/**
+ * @brief 九宫格阴影缓存类
+ *
+ * 静态工具类，只在 GUI 线程使用。同一圆角、模糊半径、颜色和设备像素比的阴影只模糊一次，
+ * 贴图存放在 QPixmapCache 中；绘制时按九宫格拉伸到目标尺寸，开销与几次 drawPixmap 相当。
+ */
+class ShadowCache
+{
+public:
+    /**
+     * @brief 在圆角矩形下方绘制阴影
+     * @param painter 绘制器
+     * @param rect 投下阴影的圆角矩形
+     * @param radius 圆角半径
+     * @param blur 模糊半径
+     * @param offset 阴影偏移
+     * @param color 阴影颜色（含透明度）
+     */
+    static void paint(QPainter* painter, const QRect& rect, int radius, int blur,
+                      const QPoint& offset, const QColor& color);
+
+private:
+    /**
+     * @brief 获取九宫格贴图
+     * @param radius 圆角半径
+     * @param blur 模糊半径
+     * @param color 阴影颜色
+     * @param dpr 设备像素比
+     * @return QPixmap 边长为 2 * (radius + 2 * blur) + 1 的阴影贴图
+     */
+    static QPixmap ninePatch(int radius, int blur, const QColor& color, qreal dpr);
+
+    /**
+     * @brief 对 Alpha8 图像做三次盒式模糊（近似高斯）
+     * @param image 待模糊的图像
+     * @param radius 模糊半径（像素）
+     */
+    static void blurAlpha(QImage& image, int radius);
+};
@@ -28,15 +28,16 @@ SidebarControl::SidebarControl(QWidget* parent)
     m_layout->setSpacing(20);
     m_layout->setContentsMargins(0, 10, 0, 10);
     
-    m_toggleBtn = createBtn(":/images/HideConversation.png", "对话记录");
-    m_historyBtn = createBtn(":/images/historypic.png", "生成记录");
+    // 图标为构建时生成的 24px 版本，高分屏自动选用同名 @2x 版本
+    m_toggleBtn = createBtn(":/icons/HideConversation.png", "对话记录");
+    m_historyBtn = createBtn(":/icons/historypic.png", "生成记录");
     
     m_layout->addWidget(m_toggleBtn);
     m_layout->addWidget(m_historyBtn);
     
     m_layout->addStretch();
 
-    m_settingsBtn = createBtn(":/images/setting.png", "服务器设置");
+    m_settingsBtn = createBtn(":/icons/setting.png", "服务器设置");
 
     m_layout->addWidget(m_settingsBtn);
 
@@ -0,0 +1,39 @@
+/**
+ * @file Theme.h
+ * @brief 界面配色与绘制常量头文件
+ *
+ * 该文件集中定义了各绘制代理共用的颜色和尺寸，列表行在绘制时直接引用这些常量，
+ * 不再为每个条目拼接和解析样式表。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QColor>
+
+/**
+ * @brief 界面主题常量
+ */
+namespace Theme {
+
+inline const QColor kText("#ECECF1");            ///< 主要文字
+inline const QColor kTextMissing("#888888");     ///< 图片丢失等提示文字
+inline const QColor kAccent("#19C37D");          ///< 强调色（悬停、焦点）
+inline const QColor kSurface("#2A2B32");         ///< AI 气泡、占位和悬停背景
+inline const QColor kSurfaceUser("#444654");     ///< 用户气泡背景
+inline const QColor kSurfaceSelected("#343541"); ///< 选中行背景
+inline const QColor kControl("#40414F");         ///< 行内按钮背景
+inline const QColor kBorder("#444444");          ///< 气泡边框
+inline const QColor kBorderSubtle("#333333");    ///< 卡片边框
+inline const QColor kBorderSelected("#565869");  ///< 选中行边框
+inline const QColor kShadow(0, 0, 0, 90);        ///< 气泡阴影
+
+constexpr int kBubbleRadius = 8;                 ///< 聊天气泡圆角
+constexpr int kCardRadius = 6;                   ///< 卡片与列表行圆角
+constexpr int kShadowBlur = 6;                   ///< 阴影模糊半径
+constexpr int kShadowOffsetY = 3;                ///< 阴影向下偏移
+
+} // namespace Theme
@@ -0,0 +1,94 @@
+/**
+ * @file TiledImageItem.cpp
+ * @brief 瓦片图片图元实现文件
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include "TiledImageItem.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+/**
+ * @brief 构造函数
+ * @param imageSize 原图尺寸
+ * @param preview 预览图
+ */
+TiledImageItem::TiledImageItem(const QSize& imageSize, const QPixmap& preview)
+    : m_imageSize(imageSize)
+    , m_preview(preview)
+{
+    // 需要 exposedRect 来裁剪瓦片范围
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+/**
+ * @brief 设置预览图
+ * @param preview 预览图
+ */
+void TiledImageItem::setPreview(const QPixmap& preview)
+{
+    m_preview = preview;
+    if (!m_pyramid) update();
+}
+
+/**
+ * @brief 设置瓦片金字塔
+ * @param pyramid 构建完成的金字塔
+ */
+void TiledImageItem::setPyramid(std::shared_ptr<const TilePyramid> pyramid)
+{
+    if (!pyramid) return;
+
+    if (pyramid->size() != m_imageSize) {
+        prepareGeometryChange();
+        m_imageSize = pyramid->size();
+    }
+    m_pyramid = std::move(pyramid);
+    m_preview = QPixmap();
+    update();
+}
+
+/**
+ * @brief 图元区域
+ * @return QRectF 原图区域
+ */
+QRectF TiledImageItem::boundingRect() const
+{
+    return QRectF(QPointF(0, 0), QSizeF(m_imageSize));
+}
+
+/**
+ * @brief 绘制图元
+ * @param painter 绘制器
+ * @param option 样式选项
+ * @param widget 目标控件
+ */
+void TiledImageItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(widget);
+
+    // 瓦片边缘抗锯齿会在相邻瓦片之间留下半透明细缝
+    painter->setRenderHint(QPainter::Antialiasing, false);
+
+    const QRectF bounds = boundingRect();
+    if (!m_pyramid) {
+        if (!m_preview.isNull()) painter->drawPixmap(bounds, m_preview, QRectF(m_preview.rect()));
+        return;
+    }
+
+    const qreal scale = option->levelOfDetailFromTransform(painter->worldTransform())
+                        * painter->device()->devicePixelRatioF();
+    const int level = m_pyramid->levelFor(scale);
+
+    const QRect tiles = m_pyramid->tilesIn(level, option->exposedRect);
+    if (tiles.isEmpty()) return;
+
+    for (int row = tiles.top(); row <= tiles.bottom(); ++row) {
+        for (int column = tiles.left(); column <= tiles.right(); ++column) {
+            const QImage& tile = m_pyramid->tile(level, column, row);
+            painter->drawImage(m_pyramid->tileRect(level, column, row), tile, QRectF(tile.rect()));
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file TiledImageItem.h
+ * @brief 瓦片图片图元头文件
+ *
+ * 该文件定义了TiledImageItem类，按当前缩放从瓦片金字塔中选层，只绘制暴露区域内的瓦片。
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#pragma once
+
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <memory>
+#include "../../Core/TilePyramid.h"
+
+/**
+ * @brief 瓦片图片图元类
+ *
+ * 场景坐标与原图像素一一对应。金字塔就绪前把预览图拉伸到原图区域绘制，
+ * 就绪后每次绘制最多涉及覆盖视口的几块瓦片，平移和缩放的帧耗时与图片尺寸无关。
+ */
+class TiledImageItem : public QGraphicsItem
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param imageSize 原图尺寸
+     * @param preview 金字塔就绪前显示的预览图，可为空
+     */
+    TiledImageItem(const QSize& imageSize, const QPixmap& preview);
+
+    /**
+     * @brief 设置预览图
+     * @param preview 预览图
+     */
+    void setPreview(const QPixmap& preview);
+
+    /**
+     * @brief 设置瓦片金字塔
+     * @param pyramid 构建完成的金字塔
+     *
+     * 金字塔尺寸与构造时的估计不同时会更新图元区域
+     */
+    void setPyramid(std::shared_ptr<const TilePyramid> pyramid);
+
+    /**
+     * @brief 金字塔是否已就绪
+     * @return bool 是否已就绪
+     */
+    bool hasPyramid() const { return m_pyramid != nullptr; }
+
+    /**
+     * @brief 图元区域
+     * @return QRectF 原图区域
+     */
+    QRectF boundingRect() const override;
+
+    /**
+     * @brief 绘制图元
+     * @param painter 绘制器
+     * @param option 样式选项（exposedRect 为需要重绘的区域）
+     * @param widget 目标控件
+     */
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    QSize m_imageSize;                           ///< 原图尺寸
+    QPixmap m_preview;                           ///< 预览图
+    std::shared_ptr<const TilePyramid> m_pyramid; ///< 瓦片金字塔
+};
@@ -11,17 +11,24 @@
  */
 
 #include "WorkflowCard.h"
-#include <QVBoxLayout>
-#include <QHBoxLayout>
+#include "../../Core/ImageLoader.h"
 #include <QPainter>
 #include <QEnterEvent>
 #include <QMouseEvent>
 #include <QDebug>
-#include <QLinearGradient>
 #include <QPixmap>
-#include <QFile>
 #include <QPainterPath>
-#include <QMovie>
+#include <QtMath>
+
+namespace {
+const QSize kCardSize(320, 180);       ///< 卡片尺寸（16:9）
+const int kCardRadius = 12;            ///< 卡片圆角
+const QRect kTextBox(0, 0, 288, 80);   ///< 左上角文字底板
+const int kTextBoxRadius = 8;          ///< 文字底板圆角
+const int kTextPadding = 8;            ///< 文字底板内边距
+const int kTextSpacing = 6;            ///< 名称与描述的间距
+const int kDescriptionWidth = 250;     ///< 描述最大宽度（超出换行）
+}
 
 /**
  * @brief WorkflowCard构造函数
@@ -34,7 +41,6 @@ WorkflowCard::WorkflowCard(const WorkflowInfo& info, QWidget* parent)
     , m_scale(1.0)
     , m_currentScale(1.0)
     , m_isHovering(false)
-    , m_backgroundLabel(nullptr)
 {
     setupUi();
     
@@ -42,18 +48,12 @@ WorkflowCard::WorkflowCard(const WorkflowInfo& info, QWidget* parent)
     m_scaleAnimation->setDuration(200);
     m_scaleAnimation->setEasingCurve(QEasingCurve::OutCubic);
     
-    // 初始化GIF动画 - 延迟初始化
-    if (!m_info.gifPath.isEmpty()) {
-        m_movie = nullptr; // 延迟初始化，在enterEvent中创建
-        qDebug() << "GIF路径已设置，将延迟初始化:" << m_info.gifPath;
-    }
+    // 帧定时器按每帧各自的时长单次触发
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    connect(m_frameTimer, &QTimer::timeout, this, &WorkflowCard::advanceFrame);
     
-    // 添加阴影效果
-    auto *shadowEffect = new QGraphicsDropShadowEffect(this);
-    shadowEffect->setBlurRadius(15);
-    shadowEffect->setColor(QColor(0, 0, 0, 80));
-    shadowEffect->setOffset(0, 5);
-    this->setGraphicsEffect(shadowEffect);
+    // 阴影由 WorkflowSelector 绘制，卡片不挂 QGraphicsEffect，播放动画时不必逐帧离屏模糊
     
     // 设置鼠标跟踪
     this->setMouseTracking(true);
@@ -62,126 +62,41 @@ WorkflowCard::WorkflowCard(const WorkflowInfo& info, QWidget* parent)
 /**
  * @brief 设置UI界面
  * 
- * 创建卡片的主要UI组件，包括背景图片、文字容器、名称和描述标签。
- * 设置16:9比例的卡片大小，并配置样式表和布局。
+ * 设置16:9比例的卡片大小，排版名称和描述文字，并异步加载静态图片。
  */
 void WorkflowCard::setupUi()
 {
     // 设置16:9比例的卡片大小 (320x180)
-    this->setFixedSize(320, 180);
-    this->setStyleSheet(
-        "WorkflowCard {"
-        "    background-color: #252525;"
-        "    border: 1px solid #444444;"
-        "    border-radius: 12px;"
-        "}"
-        "WorkflowCard:hover {"
-        "    border: 1px solid #666666;"
-        "}"
-    );
-    
-    // 主布局
-    QVBoxLayout *mainLayout = new QVBoxLayout(this);
-    mainLayout->setContentsMargins(0, 0, 0, 0);
-    mainLayout->setSpacing(0);
-    
-    // 创建背景图片标签
-    m_backgroundLabel = new QLabel(this);
-    m_backgroundLabel->setFixedSize(320, 180);
-    m_backgroundLabel->setScaledContents(true);
-    m_backgroundLabel->lower(); // 确保背景在最底层
-    
-    // 文字容器（在最左上角）
-    QWidget *textContainer = new QWidget(m_backgroundLabel);
-    textContainer->setStyleSheet(
-        "background: rgba(0, 0, 0, 120);"
-        "border-radius: 8px;"
-    );
-    textContainer->setGeometry(0, 0, 288, 80); // 增加高度以容纳更大的文字
+    this->setFixedSize(kCardSize);
     
-    QVBoxLayout *textLayout = new QVBoxLayout(textContainer);// 设置布局边距和间距
-    textLayout->setContentsMargins(8, 8, 8, 8); // 调整边距以适应更大的容器
-    textLayout->setSpacing(6); // 增加间距以适应更大的文字
-    textLayout->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+    // 名称和描述只排版一次，绘制时直接贴出
+    m_nameFont = this->font();
+    m_nameFont.setPixelSize(18);
+    m_nameFont.setWeight(QFont::DemiBold);
+    m_nameText.setText(m_info.name);
+    m_nameText.setTextFormat(Qt::PlainText);
+    m_nameText.prepare(QTransform(), m_nameFont);
     
-    // 名称标签
-    m_nameLabel = new QLabel(m_info.name, textContainer);
-    m_nameLabel->setStyleSheet(
-        "font-size: 18px;"
-        "font-weight: 600;"
-        "color: white;"
-        "background: transparent;"
-        "padding: 0;"
-        "margin: 0;"
-        "border: none"
-    );
-    
-    // 描述标签
-    m_descriptionLabel = new QLabel(m_info.description, textContainer);
-    m_descriptionLabel->setStyleSheet(
-        "font-size: 14px;"
-        "font-weight: 400;"
-        "color: #cccccc;"
-        "background: transparent;"
-        "padding: 0;"
-        "margin: 0;"
-        "border: none;"
-        "min-height: 40px;" // 增加最小高度
-    );
-    m_descriptionLabel->setWordWrap(true);
-    m_descriptionLabel->setMaximumWidth(250);
-    m_descriptionLabel->setMinimumHeight(40); // 设置最小高度
-    
-    textLayout->addWidget(m_nameLabel);
-    textLayout->addWidget(m_descriptionLabel);
-    
-    mainLayout->addWidget(m_backgroundLabel);
+    m_descriptionFont = this->font();
+    m_descriptionFont.setPixelSize(14);
+    m_descriptionText.setText(m_info.description);
+    m_descriptionText.setTextFormat(Qt::PlainText);
+    m_descriptionText.setTextWidth(kDescriptionWidth);
+    m_descriptionText.prepare(QTransform(), m_descriptionFont);
     
     // 创建缩放动画
     m_scaleAnimation = new QPropertyAnimation(this, "scale", this);
-    
-    // 设置初始静态图片
-    updateBackgroundImage();
-}
 
-/**
- * @brief 更新背景图片
- * 
- * 根据当前状态更新背景图片，优先使用GIF动画的当前帧，
- * 如果没有GIF动画则使用静态图片，如果都没有则使用默认背景。
- */
-void WorkflowCard::updateBackgroundImage()
-{
-    // 如果有GIF动画正在播放，使用GIF当前帧
-    if (m_movie && m_movie->isValid() && m_movie->state() == QMovie::Running) {
-        QPixmap currentFrame = m_movie->currentPixmap();
-        if (!currentFrame.isNull()) {
-            m_backgroundLabel->setPixmap(currentFrame);
-            m_backgroundLabel->setVisible(true);
-            qDebug() << "更新背景图片为GIF当前帧";
-        } else {
-            qDebug() << "GIF当前帧为空";
-        }
-    } else {
-        // 使用静态图片
-        if (!m_info.imagePath.isEmpty()) {
-            QPixmap pixmap(m_info.imagePath);
-            if (!pixmap.isNull()) {
-                m_backgroundLabel->setPixmap(pixmap);
-                m_backgroundLabel->setVisible(true);
-                qDebug() << "更新背景图片为静态图片:" << m_info.imagePath;
-            } else {
-                qDebug() << "无法加载静态图片:" << m_info.imagePath;
-                // 使用默认背景
-                QPixmap defaultPixmap(320, 180);
-                defaultPixmap.fill(QColor(40, 40, 40));
-                m_backgroundLabel->setPixmap(defaultPixmap);
-            }
-        } else {
-            m_backgroundLabel->clear();
-            m_backgroundLabel->setVisible(false);
-            qDebug() << "背景图片路径为空，隐藏背景";
-        }
+    if (!m_info.imagePath.isEmpty()) {
+        ImageLoader::instance().load(m_info.imagePath, kCardSize, this)
+            .then(this, [this](const QPixmap& pixmap) {
+                if (pixmap.isNull()) {
+                    qDebug() << "无法加载静态图片:" << m_info.imagePath;
+                    return;
+                }
+                m_staticPixmap = pixmap;
+                update();
+            });
     }
 }
 
@@ -221,9 +136,6 @@ void WorkflowCard::enterEvent(QEnterEvent *event)
     // 开始GIF动画
     startGifAnimation();
     
-    // 更新背景图片
-    updateBackgroundImage();
-    
     // 更新鼠标样式
     this->setCursor(Qt::PointingHandCursor);
     
@@ -243,9 +155,6 @@ void WorkflowCard::leaveEvent(QEvent *event)
     // 停止GIF动画
     stopGifAnimation();
     
-    // 更新背景图片
-    updateBackgroundImage();
-    
     // 恢复鼠标样式
     this->setCursor(Qt::ArrowCursor);
     
@@ -281,12 +190,51 @@ void WorkflowCard::resizeEvent(QResizeEvent *event)
 /**
  * @brief 绘制事件处理
  * @param event 绘制事件
+ * 
+ * 依次绘制背景（动画帧、静态图片或默认底色）、左上角文字底板和文字、边框。
+ * 动画帧已按设备像素缩放好，按原样贴出。
  */
 void WorkflowCard::paintEvent(QPaintEvent *event)
 {
-    // 明确不处理背景绘制，完全由QLabel负责
-    // 此方法仅保留作为占位，确保不会意外绘制背景
-    QWidget::paintEvent(event);
+    Q_UNUSED(event);
+    
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    
+    QPainterPath shape;
+    shape.addRoundedRect(QRectF(rect()).adjusted(0.5, 0.5, -0.5, -0.5), kCardRadius, kCardRadius);
+    painter.setClipPath(shape);
+    
+    // 背景
+    if (m_frames && m_frameIndex >= 0) {
+        painter.drawImage(QPointF(0, 0), m_frames->frames[m_frameIndex]);
+    } else if (!m_staticPixmap.isNull()) {
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawPixmap(rect(), m_staticPixmap);
+    } else {
+        // 尚未加载完成或加载失败时使用默认背景
+        painter.fillRect(rect(), m_info.imagePath.isEmpty() ? QColor("#252525") : QColor(40, 40, 40));
+    }
+    
+    // 文字底板和文字
+    QPainterPath textBox;
+    textBox.addRoundedRect(QRectF(kTextBox), kTextBoxRadius, kTextBoxRadius);
+    painter.fillPath(textBox, QColor(0, 0, 0, 120));
+    
+    painter.setClipRect(kTextBox, Qt::IntersectClip);
+    painter.setFont(m_nameFont);
+    painter.setPen(Qt::white);
+    painter.drawStaticText(kTextPadding, kTextPadding, m_nameText);
+    
+    const int descriptionTop = kTextPadding + qCeil(m_nameText.size().height()) + kTextSpacing;
+    painter.setFont(m_descriptionFont);
+    painter.setPen(QColor("#cccccc"));
+    painter.drawStaticText(kTextPadding, descriptionTop, m_descriptionText);
+    
+    // 边框
+    painter.setClipping(false);
+    painter.setPen(QPen(m_isHovering ? QColor("#666666") : QColor("#444444"), 1));
+    painter.drawPath(shape);
 }
 
 /**
@@ -294,57 +242,55 @@ void WorkflowCard::paintEvent(QPaintEvent *event)
  */
 void WorkflowCard::startGifAnimation()
 {
-    // 延迟初始化GIF
-    if (!m_info.gifPath.isEmpty() && !m_movie) {
-        qDebug() << "延迟初始化GIF:" << m_info.gifPath;
-        m_movie = new QMovie(m_info.gifPath, QByteArray(), this);
-        m_movie->setCacheMode(QMovie::CacheAll);
-        
-        if (!m_movie->isValid()) {
-            qDebug() << "无法加载GIF:" << m_info.gifPath << "错误:" << m_movie->lastErrorString();
-            delete m_movie;
-            m_movie = nullptr;
-            return;
-        }
-        
-        qDebug() << "成功加载GIF:" << m_info.gifPath << "帧数:" << m_movie->frameCount();
-        
-        // 连接GIF帧更新信号，触发重绘
-        connect(m_movie, &QMovie::frameChanged, this, [this](int frameNumber) {
-            Q_UNUSED(frameNumber)
-            updateBackgroundImage();
-        });
+    if (m_info.gifPath.isEmpty()) {
+        update();
+        return;
     }
     
-    if (m_movie && m_movie->isValid()) {
-        qDebug() << "启动GIF动画:" << m_info.gifPath;
-        m_movie->start();
-        
-        // 确保GIF正在播放
-        if (m_movie->state() != QMovie::Running) {
-            qDebug() << "GIF未能启动，状态:" << m_movie->state();
-        }
-        
-        // 更新背景图片
-        updateBackgroundImage();
-    } else {
-        qDebug() << "无法启动GIF动画，movie无效或路径为空";
+    if (m_frames) {
+        m_frameIndex = 0;
+        m_frameTimer->start(m_frames->delays[0]);
+        update();
+        return;
+    }
+    
+    // 首次悬停时在后台解码，同一动画的其他卡片和下次打开选择器直接复用
+    if (!m_framesRequested) {
+        m_framesRequested = true;
+        AnimationFrameCache::instance().load(m_info.gifPath, size(), devicePixelRatioF())
+            .then(this, [this](const AnimationFramesPtr& frames) {
+                if (!frames) {
+                    qDebug() << "无法加载GIF:" << m_info.gifPath;
+                    return;
+                }
+                m_frames = frames;
+                if (m_isHovering) startGifAnimation();
+            });
     }
+    
+    update();
 }
 
 /**
  * @brief 停止GIF动画
+ * 
+ * 回到静态图片，下次播放从第一帧开始
  */
 void WorkflowCard::stopGifAnimation()
 {
-    if (m_movie && m_movie->isValid()) {
-        qDebug() << "停止GIF动画:" << m_info.gifPath;
-        m_movie->stop();
-        
-        // 重置GIF到第一帧，确保下次播放从头开始
-        m_movie->jumpToFrame(0);
-        
-        // 更新背景图片
-        updateBackgroundImage();
-    }
+    m_frameTimer->stop();
+    m_frameIndex = -1;
+    update();
+}
+
+/**
+ * @brief 切换到下一帧
+ */
+void WorkflowCard::advanceFrame()
+{
+    if (!m_frames || m_frameIndex < 0) return;
+    
+    m_frameIndex = (m_frameIndex + 1) % m_frames->frames.size();
+    m_frameTimer->start(m_frames->delays[m_frameIndex]);
+    update();
 }
@@ -4,6 +4,7 @@
  * 
  * 该文件定义了WorkflowCard类，用于显示工作流卡片，支持静态图片和GIF动画背景，
  * 包含鼠标悬停效果、缩放动画和文字信息展示功能。
+ * 背景、文字和动画帧全部在 paintEvent 中直接绘制，动画帧由 AnimationFrameCache 预先缩放到卡片尺寸。
  * 
  * @author 系统自动生成
  * @version 1.0
@@ -12,11 +13,11 @@
 
 #pragma once
 #include <QWidget>
-#include <QLabel>
-#include <QMovie>
 #include <QPropertyAnimation>
-#include <QGraphicsDropShadowEffect>
+#include <QStaticText>
+#include <QTimer>
 #include "../../Model/WorkflowTypes.h"
+#include "../../Core/AnimationFrameCache.h"
 
 /**
  * @class WorkflowCard
@@ -25,7 +26,7 @@
  * 该类实现了一个可交互的工作流卡片，支持以下功能：
  * - 显示工作流名称和描述
  * - 支持静态图片和GIF动画背景
- * - 鼠标悬停时播放GIF动画
+ * - 鼠标悬停时播放GIF动画（首次悬停时在后台解码，期间显示静态图片）
  * - 缩放动画效果
  * - 点击事件处理
  */
@@ -112,6 +113,8 @@ private:
     
     /**
      * @brief 开始GIF动画
+     *
+     * 帧尚未解码时先发起后台解码，解码完成且仍在悬停才开始播放
      */
     void startGifAnimation();
     
@@ -121,9 +124,9 @@ private:
     void stopGifAnimation();
     
     /**
-     * @brief 更新背景图片
+     * @brief 切换到下一帧
      */
-    void updateBackgroundImage();
+    void advanceFrame();
 
 private:
     WorkflowInfo m_info;              ///< 工作流信息
@@ -131,16 +134,18 @@ private:
     qreal m_currentScale = 1.0;       ///< 实际缩放比例
     bool m_isHovering = false;        ///< 鼠标悬停状态
     
-    // UI组件
-    QLabel* m_nameLabel = nullptr;        ///< 名称标签
-    QLabel* m_descriptionLabel = nullptr; ///< 描述标签
-    QLabel* m_backgroundLabel = nullptr;  ///< 背景图片标签
+    // 文字（排版结果缓存在 QStaticText 中，每帧只做贴图）
+    QStaticText m_nameText;        ///< 名称
+    QStaticText m_descriptionText; ///< 描述
+    QFont m_nameFont;              ///< 名称字体
+    QFont m_descriptionFont;       ///< 描述字体
     
     // 动画相关
-    QMovie* m_movie = nullptr;                ///< GIF动画对象
+    AnimationFramesPtr m_frames;                    ///< 预缩放的动画帧（与其他卡片共享）
+    int m_frameIndex = -1;                          ///< 正在显示的帧，-1 表示显示静态图片
+    bool m_framesRequested = false;                 ///< 是否已发起解码
+    QTimer* m_frameTimer = nullptr;                 ///< 帧定时器（按每帧时长单次触发）
     QPropertyAnimation* m_scaleAnimation = nullptr; ///< 缩放动画对象
     
-    // 静态图片和GIF路径
-    QString m_imagePath; ///< 静态图片路径
-    QString m_gifPath;   ///< GIF动画路径
+    QPixmap m_staticPixmap; ///< 解码到卡片尺寸的静态图片
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "WorkflowSelector.h"
 #include "WorkflowCard.h"
+#include "ShadowCache.h"
 #include <QVBoxLayout>
 #include <QScrollArea>
 #include <QPainter>
@@ -16,6 +17,11 @@
 #include <QLabel>
 #include <QMouseEvent>
 
+namespace {
+const int kContainerRadius = 12;  ///< 容器圆角
+const int kCardRadius = 12;       ///< 卡片圆角
+}
+
 /**
  * @brief 构造函数
  * @param parent 父窗口指针
@@ -28,9 +34,9 @@ WorkflowSelector::WorkflowSelector(QWidget* parent) : QWidget(parent) {
     setWindowFlags(Qt::Popup | Qt::FramelessWindowHint);
     setAttribute(Qt::WA_TranslucentBackground);
     
-    // 初始化测试工作流数据
-    m_workflows.append(WorkflowInfo(1, "文生图", ":/images/文生图演示.png", ":/images/文生图演示.gif", "基础生成模式，从文字创建图像", WorkflowType::TextToImage));
-    m_workflows.append(WorkflowInfo(2, "图生图", ":/images/图生图演示.png", ":/images/图生图演示.gif", "基于参考图生成新图像", WorkflowType::ImageToImage));
+    // 初始化测试工作流数据（卡片静态图编译在程序内，演示动画在外部资源包中按需加载）
+    m_workflows.append(WorkflowInfo(1, "文生图", ":/cards/文生图演示.jpg", ":/media/strips/文生图演示.json", "基础生成模式，从文字创建图像", WorkflowType::TextToImage));
+    m_workflows.append(WorkflowInfo(2, "图生图", ":/cards/图生图演示.jpg", ":/media/strips/图生图演示.json", "基于参考图生成新图像", WorkflowType::ImageToImage));
     
     setupUi();
 }
@@ -61,11 +67,8 @@ void WorkflowSelector::setupUi() {
         "}"
     );
     
-    QGraphicsDropShadowEffect* shadow = new QGraphicsDropShadowEffect(this);
-    shadow->setBlurRadius(25);
-    shadow->setColor(QColor(0, 0, 0, 100));
-    shadow->setOffset(0, 8);
-    m_container->setGraphicsEffect(shadow);
+    // 容器和卡片的阴影都用九宫格贴图绘制（见 paintEvent / eventFilter）。
+    // QGraphicsDropShadowEffect 会在卡片播放动画时逐帧把整个容器离屏渲染再模糊一遍
     
     m_containerLayout = new QVBoxLayout(m_container);
     m_containerLayout->setContentsMargins(20, 20, 20, 20);
@@ -88,6 +91,7 @@ void WorkflowSelector::setupUi() {
     
     m_scrollContent = new QWidget();
     m_scrollContent->setStyleSheet("background: transparent;");
+    m_scrollContent->installEventFilter(this);
     
     m_cardsLayout = new QVBoxLayout(m_scrollContent);
     m_cardsLayout->setContentsMargins(0, 0, 10, 0);
@@ -153,7 +157,7 @@ void WorkflowSelector::setWorkflows(const QVector<WorkflowInfo>& workflows) {
  * @param event 绘制事件
  * 
  * 使用透明模式绘制窗口背景，确保窗口完全透明。
- * 这是实现无边框透明窗口的关键方法。
+ * 这是实现无边框透明窗口的关键方法。清空后在容器下方绘制阴影。
  */
 void WorkflowSelector::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
@@ -162,6 +166,27 @@ void WorkflowSelector::paintEvent(QPaintEvent* event) {
     // 这样操作系统就不会绘制黑色底色了
     p.setCompositionMode(QPainter::CompositionMode_Clear);
     p.fillRect(rect(), Qt::transparent);
+    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    ShadowCache::paint(&p, m_container->geometry(), kContainerRadius, 12, QPoint(0, 8), QColor(0, 0, 0, 100));
+}
+
+/**
+ * @brief 事件过滤器
+ * @param watched 被监视的对象
+ * @param event 事件
+ * @return 是否处理了该事件
+ * 
+ * 滚动内容绘制时先画出卡片阴影，卡片本身随后绘制在阴影之上。
+ */
+bool WorkflowSelector::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == m_scrollContent && event->type() == QEvent::Paint) {
+        QPainter p(m_scrollContent);
+        for (WorkflowCard* card : m_workflowCards) {
+            ShadowCache::paint(&p, card->geometry(), kCardRadius, 7, QPoint(0, 5), QColor(0, 0, 0, 80));
+        }
+    }
+    return QWidget::eventFilter(watched, event);
 }
 
 /**
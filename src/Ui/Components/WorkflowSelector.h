@@ -15,7 +15,6 @@
 #include <QVBoxLayout>
 #include <QScrollArea>
 #include <QLabel>
-#include <QGraphicsDropShadowEffect>
 #include "../../Model/WorkflowTypes.h"
 
 class WorkflowCard;
@@ -80,6 +79,16 @@ protected:
      */
     bool event(QEvent* event) override;
 
+    /**
+     * @brief 事件过滤器
+     * @param watched 被监视的对象
+     * @param event 事件
+     * @return 是否处理了该事件
+     * 
+     * 在滚动内容绘制前画出各卡片的阴影。
+     */
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private:
     /**
      * @brief 初始化UI界面
@@ -13,10 +13,15 @@
 #include "Components/InputPanel.h"
 #include "Components/WorkflowSelector.h"
 #include "Components/ReferencePopup.h"
-#include "Components/ChatBubble.h"
 #include "../Network/ComfyApiService.h"
 #include "../Core/WorkflowManager.h"
+#include "../Core/ImageStore.h"
+#include "../Core/ThumbnailCache.h"
+#include "../Core/ImageLoader.h"
 #include "../Model/DataModels.h"
+#include "../Model/SessionModel.h"
+#include "../Core/SessionHistoryCache.h"
+#include "../Core/StartupProfiler.h"
 #include "Components/HistoryGallery.h"
 #include "Components/ImageViewer.h"
 
@@ -35,8 +40,11 @@
 #include <QFileDialog>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QDateTime>
 #include <QSettings>
+#include <QJsonDocument>
+#include <QThreadPool>
 
 /**
  * @brief 构造函数
@@ -86,21 +94,13 @@ void MainWindow::setupUi()
 
     m_leftStack = new QStackedWidget(central);
 
+    m_sessionModel = new SessionModel(this);
+    m_historyCache = new SessionHistoryCache(this);
+
     m_sessionList = new SessionList(m_leftStack);
+    m_sessionList->setModel(m_sessionModel);
     m_leftStack->addWidget(m_sessionList);
 
-    m_historyGallery = new HistoryGallery(m_leftStack);
-    m_leftStack->addWidget(m_historyGallery);
-
-    connect(m_historyGallery, &HistoryGallery::imageClicked, this, [this](const QString& path){
-        QPixmap pix(path);
-        if (!pix.isNull()) {
-            ImageViewer* viewer = new ImageViewer(pix, this);
-            viewer->exec();
-            delete viewer;
-        }
-    });
-
     m_leftStack->setCurrentIndex(0);
 
     m_leftContainerOriginalWidth = 250;
@@ -123,10 +123,6 @@ void MainWindow::setupUi()
 
     m_wfManager = new WorkflowManager(this);
 
-    m_wfSelector = new WorkflowSelector(this);
-
-    m_refPopup = new ReferencePopup(this);
-
     m_sidebarControl = new SidebarControl(this);
 
     m_leftContainerAnimation = new QPropertyAnimation(m_leftStack, "minimumWidth", this);
@@ -147,9 +143,6 @@ void MainWindow::setupUi()
     connect(m_inputPanel, &InputPanel::generateClicked,
             this, &MainWindow::onGenerateClicked);
 
-    connect(m_wfSelector, &WorkflowSelector::workflowSelected,
-            this, &MainWindow::onWorkflowSelected);
-
     connect(m_inputPanel->getInterrogateBtn(), &QToolButton::clicked,
             this, &MainWindow::onInterrogateClicked);
 
@@ -168,6 +161,11 @@ void MainWindow::setupUi()
         updateSidebarPosition();
     });
 
+    // 缩略图缓存的容量检查要遍历整个缓存目录，等启动稳定后放到后台执行
+    QTimer::singleShot(30000, this, [](){
+        QThreadPool::globalInstance()->start([](){ ThumbnailCache::trim(); });
+    });
+
     m_apiService = new ComfyApiService(this);
 
     connect(m_apiService, &ComfyApiService::serverConnected, this, [this](){
@@ -194,46 +192,85 @@ void MainWindow::setupUi()
         }
     });
 
-    loadAndConnect();
+    // 连接服务器放到首帧之后（见 onFirstFrame），网络模块的初始化不阻塞窗口显示
 
     connect(m_apiService, &ComfyApiService::promptQueued, this, [this](const QString& promptId){
-        if (m_tempBubbleForId) {
-            qDebug() << "绑定任务 ID:" << promptId << " 到当前气泡";
-            m_pendingBubbles.insert(promptId, m_tempBubbleForId);
-            m_tempBubbleForId = nullptr;
+        if (m_tempItemForId != -1) {
+            qDebug() << "绑定任务 ID:" << promptId << " 到当前占位条目";
+            m_pendingItems.insert(promptId, m_tempItemForId);
+            m_tempItemForId = -1;
+        }
+
+        // 同一时间只有一个任务在执行，此时仍未记录的都是没有产出结果的任务（如连接中断），不再等待
+        if (!m_generations.isEmpty()) {
+            qDebug() << "丢弃未完成的生成记录:" << m_generations.keys();
+            m_generations.clear();
+        }
+
+        if (m_submittedGeneration.workflowType != -1) {
+            m_submittedGeneration.promptId = promptId;
+            m_generations.insert(promptId, m_submittedGeneration);
+            m_submittedGeneration = GenerationRecord();
         }
     });
 
-    connect(m_apiService, &ComfyApiService::imageReceived, this,
+    // 执行出错或被中断的任务不会再有结果，丢弃其生成记录、移除加载占位并解锁输入
+    connect(m_apiService, &ComfyApiService::executionFailed, this, [this](const QString& promptId, const QString& msg){
+        qDebug() << "任务执行失败:" << promptId << msg;
+        m_generations.remove(promptId);
+        if (m_pendingItems.contains(promptId)) m_chatArea->removeLoadingItem(m_pendingItems.take(promptId));
+        if (promptId == m_apiService->currentPromptId()) setJobRunning(false);
+    });
+
+    connect(m_apiService, &ComfyApiService::executionStarted, this, [this](const QString& promptId){
+        auto it = m_generations.find(promptId);
+        if (it != m_generations.end()) it->startedAt = QDateTime::currentMSecsSinceEpoch();
+    });
+
+    connect(m_apiService, &ComfyApiService::promptExecuted, this, [this](const QString& promptId){
+        auto it = m_generations.find(promptId);
+        if (it != m_generations.end() && it->executedAt == 0) it->executedAt = QDateTime::currentMSecsSinceEpoch();
+    });
+
+    connect(m_apiService, &ComfyApiService::imagePreviewReceived, this,
             [this](const QString& promptId, const QString& filename, const QPixmap& img){
 
-                QString localPath = saveImageToLocal(img);
+                int key = m_pendingItems.value(promptId, -1);
+                if (key != -1) {
+                    m_chatArea->updatePreview(key, img, filename);
+                    QTimer::singleShot(100, this, [this](){ m_chatArea->scrollToBottom(); });
+                }
+            });
+
+    connect(m_apiService, &ComfyApiService::imageReceived, this,
+            [this](const QString& promptId, const QString& filename, const QPixmap& img, const QByteArray& data){
 
+                QString localPath = saveImageToLocal(data);
+
+                QFuture<int> messageId;
                 int currentSid = m_chatArea->currentSessionId();
                 if (currentSid != -1 && !localPath.isEmpty()) {
                     MessageData msg(currentSid, MessageRole::AI, "", localPath);
-                    DatabaseManager::instance().addMessage(msg);
+                    messageId = DatabaseManager::instance().addMessage(msg);
+                    // 画廊尚未创建时不必插入，首次打开会从数据库读到这张图
+                    if (m_historyGallery) m_historyGallery->addImage(localPath, img.size(), currentSid);
                 }
 
-                if (m_pendingBubbles.contains(promptId)) {
-                    qDebug() << "找到对应的气泡，更新图片...";
+                recordGeneration(promptId, messageId, img.size());
 
-                    ChatBubble* bubble = m_pendingBubbles[promptId];
-                    if (bubble) {
-                        bubble->updateImage(img, filename);
+                if (m_pendingItems.contains(promptId)) {
+                    qDebug() << "找到对应的占位条目，更新图片...";
 
+                    m_chatArea->updateImage(m_pendingItems.take(promptId), img, filename, localPath);
 
-                        QTimer::singleShot(100, this, [this](){
-                            m_chatArea->scrollToBottom();
-                        });
-                    }
+                    QTimer::singleShot(100, this, [this](){
+                        m_chatArea->scrollToBottom();
+                    });
 
                     setJobRunning(false);
-
-                    m_pendingBubbles.remove(promptId);
                 } else {
                     if (m_chatArea) {
-                        m_chatArea->addAiImage(img);
+                        m_chatArea->addAiImage(img, localPath);
                         QTimer::singleShot(100, this, [this](){ m_chatArea->scrollToBottom(); });
                     }
                 }
@@ -251,20 +288,28 @@ void MainWindow::setupUi()
 
                 qDebug() << "收到高清修复请求，准备回环上传...";
 
-                m_tempUpscaleBubble = m_chatArea->addLoadingBubble();
+                m_tempUpscaleItem = m_chatArea->addLoadingItem();
 
-                QString tempPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation)
-                                   + "/temp_upscale_source.png";
-                if (img.save(tempPath)) {
-                    m_isUploadingForUpscale = true;
+                m_isUploadingForUpscale = true;
+                m_uploadStartedAt = QDateTime::currentMSecsSinceEpoch();
 
-                    m_apiService->uploadImage(tempPath);
-                } else {
-                    qDebug() << "临时文件保存失败";
-                    setJobRunning(false);
-                }
+                m_apiService->uploadImage(img.toImage(), "upscale_source.png");
             });
 
+    // 上传失败时清除等待标记、移除加载占位并解锁输入面板，否则要等重启才能再次提交
+    connect(m_apiService, &ComfyApiService::uploadFailed, this, [this](const QString& reason){
+        qDebug() << "参考图上传失败:" << reason;
+        m_isUploadingForUpscale = false;
+        m_isUploadingForInterrogate = false;
+        m_isUploadingForI2I = false;
+
+        if (m_tempUpscaleItem != -1) m_chatArea->removeLoadingItem(m_tempUpscaleItem);
+        if (m_tempItemForId != -1) m_chatArea->removeLoadingItem(m_tempItemForId);
+        m_tempUpscaleItem = -1;
+        m_tempItemForId = -1;
+        setJobRunning(false);
+    });
+
     connect(m_apiService, &ComfyApiService::imageUploaded, this, [this](const QString& serverName){
 
         if (m_isUploadingForUpscale) {
@@ -281,12 +326,10 @@ void MainWindow::setupUi()
 
             QJsonObject wf = m_wfManager->buildWorkflow(WorkflowType::Upscale, params);
 
-            m_tempBubbleForId = m_tempUpscaleBubble;
-            m_tempUpscaleBubble = nullptr;
+            m_tempItemForId = m_tempUpscaleItem;
+            m_tempUpscaleItem = -1;
 
-            if (m_apiService) {
-                m_apiService->queuePrompt(wf);
-            }
+            submitWorkflow(WorkflowType::Upscale, params, wf);
 
             return;
         }
@@ -299,6 +342,10 @@ void MainWindow::setupUi()
             QMap<QString, QVariant> params;
             params["image_path"] = serverName;
 
+            qint64 seed = QRandomGenerator::global()->generate();
+            if (seed < 0) seed = -seed;
+            params["seed"] = seed;
+
             QJsonObject wf = m_wfManager->buildWorkflow(WorkflowType::VisionCaption, params);
 
             if (wf.isEmpty()) {
@@ -307,9 +354,7 @@ void MainWindow::setupUi()
                 return;
             }
 
-            if (m_apiService) {
-                m_apiService->queuePrompt(wf);
-            }
+            submitWorkflow(WorkflowType::VisionCaption, params, wf);
 
             return;
         }
@@ -330,9 +375,7 @@ void MainWindow::setupUi()
                 return;
             }
 
-            if (m_apiService) {
-                m_apiService->queuePrompt(wf);
-            }
+            submitWorkflow(WorkflowType::ImageToImage, params, wf);
 
             return;
         }
@@ -349,18 +392,15 @@ void MainWindow::setupUi()
                     m_chatArea->handleStreamToken(token, finished);
                 }
 
+                persistStreamText(finished);
+
                 if (finished) {
                     qDebug() << "反推结束，完整文本长度:" << m_accumulatedStreamText.length();
 
-                    int currentSid = m_chatArea->currentSessionId();
-
-                    if (currentSid != -1 && !m_accumulatedStreamText.isEmpty()) {
-                        MessageData msg(currentSid, MessageRole::AI, m_accumulatedStreamText);
-                        DatabaseManager::instance().addMessage(msg);
-                        qDebug() << "反推文本已保存到数据库";
-                    }
+                    recordGeneration(m_apiService->currentPromptId(), m_streamMessageId, QSize());
 
                     m_accumulatedStreamText.clear();
+                    m_streamMessageId = QFuture<int>();
 
                     setJobRunning(false);
                 }
@@ -369,29 +409,37 @@ void MainWindow::setupUi()
     connect(m_sessionList, &SessionList::createNewSessionRequest,
             this, &MainWindow::createNewSession);
 
-    connect(m_sessionList, &SessionList::sessionRenameRequest, this,
-            [this](int id, const QString& newName){
-
-                DatabaseManager::instance().renameSession(id, newName);
-                qDebug() << "会话" << id << "重命名为" << newName;
-            });
-
     connect(m_sessionList, &SessionList::sessionDeleteRequest, this,
             [this](int id){
 
-                DatabaseManager::instance().deleteSession(id);
+                // 数据库删除成功后再清理界面，失败时会话仍留在列表中
+                m_sessionModel->removeSession(id).then(this, [this, id](bool ok){
+                    if (!ok) return;
 
-                if (m_chatArea->currentSessionId() == id) {
-                    m_chatArea->clear();
-                    m_chatArea->setCurrentSessionId(-1);
-                }
-                qDebug() << "会话" << id << "已删除";
+                    m_historyCache->invalidate(id);
+                    if (m_historyGallery) m_historyGallery->removeSession(id);
+
+                    if (m_chatArea->currentSessionId() == id) {
+                        m_chatArea->clear();
+                        m_chatArea->setCurrentSessionId(-1);
+                    }
+                    qDebug() << "会话" << id << "已删除";
+                });
             });
 
+    connect(m_chatArea, &ChatArea::olderHistoryRequested, this, &MainWindow::loadOlderHistory);
+
+    connect(m_sessionList, &SessionList::searchResultActivated, this, [this](int sessionId, int messageId){
+        qDebug() << "打开搜索结果: 会话" << sessionId << "消息" << messageId;
+        loadSessionHistory(sessionId, messageId);
+    });
+
     connect(m_sessionList, &SessionList::sessionSwitchRequest, this, [this](int id){
         loadSessionHistory(id);
     });
 
+    connect(m_sessionList, &SessionList::sessionHovered, m_historyCache, &SessionHistoryCache::prefetch);
+
     loadSessionList();
 }
 
@@ -402,7 +450,7 @@ void MainWindow::onWorkflowBtnClicked() {
     QPushButton* btn = m_inputPanel->getWorkflowBtn();
     if (btn) {
         QPoint btnPos = btn->mapToGlobal(QPoint(btn->width() / 2, 0));
-        m_wfSelector->popup(btnPos);
+        workflowSelector()->popup(btnPos);
     }
 }
 
@@ -410,13 +458,13 @@ void MainWindow::onWorkflowBtnClicked() {
  * @brief 参考图按钮点击事件处理
  */
 void MainWindow::onRefBtnClicked() {
-    if (m_refPopup->isVisible()) {
+    if (m_refPopup && m_refPopup->isVisible()) {
         m_refPopup->hide();
     } else {
         QToolButton* btn = m_inputPanel->getRefBtn();
         if (btn) {
             QPoint btnPos = btn->mapToGlobal(QPoint(btn->width() / 2, 0));
-            m_refPopup->popup(btnPos);
+            referencePopup()->popup(btnPos);
         }
     }
 }
@@ -454,8 +502,7 @@ void MainWindow::onGenerateClicked(const QString& prompt)
         m_chatArea->addUserMessage(prompt);
     }
 
-    ChatBubble* loadingBubble = m_chatArea->addLoadingBubble();
-    m_tempBubbleForId = loadingBubble;
+    m_tempItemForId = m_chatArea->addLoadingItem();
 
     setJobRunning(true);
 
@@ -469,9 +516,7 @@ void MainWindow::onGenerateClicked(const QString& prompt)
     qDebug() << "准备生成, 类型:" << (int)m_currentWorkflowType << " 种子:" << seed;
 
     if (m_currentWorkflowType == WorkflowType::ImageToImage) {
-        QString localPath = m_refPopup->currentPath();
-
-        if (localPath.isEmpty()) {
+        if (!m_refPopup || !m_refPopup->hasImage()) {
             qDebug() << "图生图模式必须先选择参考图";
             setJobRunning(false);
             return;
@@ -481,9 +526,7 @@ void MainWindow::onGenerateClicked(const QString& prompt)
 
         m_pendingI2IParams = params;
 
-        if (m_apiService) {
-            m_apiService->uploadImage(localPath);
-        }
+        uploadReferenceImage(WorkflowType::ImageToImage);
 
         return;
     }
@@ -507,7 +550,7 @@ void MainWindow::onGenerateClicked(const QString& prompt)
     }
 
     if (m_apiService) {
-        m_apiService->queuePrompt(workflow);
+        submitWorkflow(m_currentWorkflowType, params, workflow);
     } else {
         qDebug() << "ApiService 未初始化";
         setJobRunning(false);
@@ -600,6 +643,79 @@ void MainWindow::resizeEvent(QResizeEvent* event)
     updateSidebarPosition();
 }
 
+/**
+ * @brief 事件处理
+ * @param event 事件对象
+ * @return bool 是否处理了该事件
+ */
+bool MainWindow::event(QEvent* event)
+{
+    if (event->type() == QEvent::Paint && !m_firstFrameShown) {
+        // 等这一轮绘制返回事件循环后再继续，确保首帧已经提交
+        m_firstFrameShown = true;
+        QTimer::singleShot(0, this, &MainWindow::onFirstFrame);
+    }
+    return QMainWindow::event(event);
+}
+
+/**
+ * @brief 首帧绘制完成
+ */
+void MainWindow::onFirstFrame()
+{
+    StartupProfiler::mark("首帧绘制");
+    StartupProfiler::finish();
+
+    loadAndConnect();
+}
+
+/**
+ * @brief 获取工作流选择面板，首次调用时创建
+ * @return WorkflowSelector* 工作流选择面板
+ */
+WorkflowSelector* MainWindow::workflowSelector()
+{
+    if (!m_wfSelector) {
+        m_wfSelector = new WorkflowSelector(this);
+        connect(m_wfSelector, &WorkflowSelector::workflowSelected,
+                this, &MainWindow::onWorkflowSelected);
+    }
+    return m_wfSelector;
+}
+
+/**
+ * @brief 获取参考图面板，首次调用时创建
+ * @return ReferencePopup* 参考图面板
+ */
+ReferencePopup* MainWindow::referencePopup()
+{
+    if (!m_refPopup) m_refPopup = new ReferencePopup(this);
+    return m_refPopup;
+}
+
+/**
+ * @brief 获取历史画廊，首次调用时创建
+ * @return HistoryGallery* 历史画廊
+ */
+HistoryGallery* MainWindow::historyGallery()
+{
+    if (m_historyGallery) return m_historyGallery;
+
+    m_historyGallery = new HistoryGallery(m_leftStack);
+    m_leftStack->addWidget(m_historyGallery);
+
+    connect(m_historyGallery, &HistoryGallery::imageClicked, this, [this](const QString& path){
+        if (!QFileInfo::exists(path)) return;
+
+        // 查看器先显示缓存的缩略图，原图在后台切成瓦片
+        ImageViewer* viewer = new ImageViewer(path, QPixmap(), this);
+        viewer->exec();
+        delete viewer;
+    });
+
+    return m_historyGallery;
+}
+
 /**
  * @brief 切换到会话列表页面
  */
@@ -613,14 +729,9 @@ void MainWindow::switchToSessionList()
  */
 void MainWindow::switchToHistoryWindow()
 {
-    // 1. 切换界面
+    // 画廊首次显示时加载第一页，之后新生成的图片由 imageReceived 增量插入，切换时无需刷新
+    historyGallery();
     switchLeftPanel(1);
-
-    // 2. 每次切换过来时，刷新数据
-    // 这样刚生成的图也能立刻看到
-    if (m_leftStack->currentIndex() == 1) {
-        m_historyGallery->loadImages();
-    }
 }
 
 void MainWindow::setJobRunning(bool running)
@@ -646,126 +757,260 @@ void MainWindow::onInterrogateClicked()
 {
     if (m_isJobRunning) return;
 
-    QString localPath = m_refPopup->currentPath();
-
-    if (localPath.isEmpty()) {
+    if (!m_refPopup || !m_refPopup->hasImage()) {
         QToolButton* btn = m_inputPanel->getRefBtn();
         if (btn) {
             QPoint btnPos = btn->mapToGlobal(QPoint(btn->width() / 2, 0));
-            m_refPopup->popup(btnPos);
+            referencePopup()->popup(btnPos);
         }
         return;
     }
 
     m_accumulatedStreamText.clear();
+    m_streamMessageId = QFuture<int>();
 
     QPixmap pix = m_refPopup->currentImage();
     if (!pix.isNull()) {
-        if (m_chatArea) m_chatArea->addUserImage(pix);
+        if (m_chatArea) m_chatArea->addUserImage(pix, m_refPopup->currentPath());
     }
 
     setJobRunning(true);
     m_isUploadingForInterrogate = true;
 
-    if (m_apiService) {
-        m_apiService->uploadImage(localPath);
+    uploadReferenceImage(WorkflowType::VisionCaption);
+}
+
+/**
+ * @brief 上传参考图面板中的图片
+ * @param type 使用该参考图的工作流类型
+ */
+void MainWindow::uploadReferenceImage(WorkflowType type)
+{
+    if (!m_apiService || !m_refPopup) return;
+
+    UploadResizePolicy policy = m_wfManager->uploadResizePolicy(type);
+    m_uploadStartedAt = QDateTime::currentMSecsSinceEpoch();
+
+    QString localPath = m_refPopup->currentPath();
+    if (!localPath.isEmpty()) {
+        m_apiService->uploadImage(localPath, policy);
+    } else {
+        m_apiService->uploadImage(m_refPopup->pastedImage(), "clipboard.png", policy);
     }
 }
 
 /**
- * @brief 加载会话列表
+ * @brief 提交工作流并开始记录生成元数据
+ * @param type 工作流类型
+ * @param params 绑定到模板的参数
+ * @param workflow 构建好的工作流JSON
  */
-void MainWindow::loadSessionList()
+void MainWindow::submitWorkflow(WorkflowType type, const QMap<QString, QVariant>& params, const QJsonObject& workflow)
 {
-    QVector<SessionData> sessions = DatabaseManager::instance().getAllSessions();
+    if (!m_apiService) return;
+
+    GenerationRecord record;
+    record.workflowType = static_cast<int>(type);
+    record.templateHash = m_wfManager->templateHash(type);
+    record.paramsJson = QString::fromUtf8(
+        QJsonDocument(QJsonObject::fromVariantMap(params)).toJson(QJsonDocument::Compact));
+    record.seed = params.value("seed", -1).toLongLong();
+    record.backendUrl = m_apiService->baseUrl();
+    record.submittedAt = QDateTime::currentMSecsSinceEpoch();
+
+    // 文生图没有参考图，残留的上传时间来自此前失败的任务
+    if (m_uploadStartedAt > 0 && type != WorkflowType::TextToImage) {
+        record.uploadMs = record.submittedAt - m_uploadStartedAt;
+    }
+    m_uploadStartedAt = 0;
 
-    m_sessionList->loadSessions(sessions);
+    m_submittedGeneration = record;
+    m_apiService->queuePrompt(workflow);
+}
 
-    if (!sessions.isEmpty()) {
-        int firstId = sessions.first().id;
+/**
+ * @brief 任务结果落地后写入生成元数据
+ * @param promptId 任务ID
+ * @param messageId 结果消息的 addMessage future，结果未落库时为无效 future
+ * @param outputSize 输出图片尺寸，文本结果为空
+ */
+void MainWindow::recordGeneration(const QString& promptId, const QFuture<int>& messageId, const QSize& outputSize)
+{
+    auto it = m_generations.find(promptId);
+    if (it == m_generations.end()) return;
 
-        m_sessionList->selectSession(firstId);
+    GenerationRecord record = it.value();
+    m_generations.erase(it);
 
-        loadSessionHistory(firstId);
+    record.finishedAt = QDateTime::currentMSecsSinceEpoch();
+    record.width = outputSize.width() > 0 ? outputSize.width() : 0;
+    record.height = outputSize.height() > 0 ? outputSize.height() : 0;
 
-        m_chatArea->setCurrentSessionId(firstId);
-    }
-    else {
-        qDebug() << "数据库为空，自动创建新会话...";
-        createNewSession();
-    }
+    DatabaseManager::instance().addGeneration(messageId, record);
 }
 
 /**
- * @brief 创建新会话
+ * @brief 把当前累计的流式文本写入数据库
+ * @param force 是否忽略节流立即写入
  */
-void MainWindow::createNewSession()
+void MainWindow::persistStreamText(bool force)
 {
-    int newId = DatabaseManager::instance().createSession("新会话");
-    if (newId != -1) {
-        loadSessionList();
+    int currentSid = m_chatArea->currentSessionId();
+    if (currentSid == -1 || m_accumulatedStreamText.isEmpty()) return;
 
-        if (!m_leftContainerVisible) onToggleLeftContainer();
+    if (!m_streamMessageId.isValid()) {
+        MessageData msg(currentSid, MessageRole::AI, m_accumulatedStreamText);
+        m_streamMessageId = DatabaseManager::instance().addMessage(msg);
+        m_streamPersistTimer.start();
+        return;
     }
+
+    // 流式过程中每秒最多写一次，结束时强制写入最终文本
+    if (!force && m_streamPersistTimer.elapsed() < 1000) return;
+
+    DatabaseManager::instance().updateMessageText(m_streamMessageId, m_accumulatedStreamText);
+    m_streamPersistTimer.restart();
+}
+
+/**
+ * @brief 加载会话列表
+ */
+void MainWindow::loadSessionList()
+{
+    m_sessionModel->load().then(this, [this]() {
+        StartupProfiler::mark("会话列表就绪");
+
+        const SessionData* first = m_sessionModel->sessionAt(0);
+
+        if (first) {
+            int firstId = first->id;
+
+            m_sessionList->selectSession(firstId);
+
+            loadSessionHistory(firstId);
+        }
+        else {
+            qDebug() << "数据库为空，自动创建新会话...";
+            createNewSession();
+        }
+    });
 }
 
-QString MainWindow::saveImageToLocal(const QPixmap& img)
+/**
+ * @brief 创建新会话
+ */
+void MainWindow::createNewSession()
 {
-    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QString outputDir = dataDir + "/outputs";
+    m_sessionModel->createSession("新会话").then(this, [this](int newId) {
+        if (newId == -1) return;
+
+        m_sessionList->selectSession(newId);
+        m_historyCache->refresh(m_chatArea->currentSessionId());
 
-    QDir dir(outputDir);
-    if (!dir.exists()) dir.mkpath(".");
+        // 丢弃仍在返回途中的旧会话历史
+        ++m_historyLoadSerial;
+        m_historyCursor = MessageCursor();
+        m_chatArea->clear();
+        m_chatArea->setCurrentSessionId(newId);
+        m_chatArea->setHasMoreHistory(false);
 
-    QString fileName = QString::number(QDateTime::currentMSecsSinceEpoch()) + ".png";
-    QString fullPath = outputDir + "/" + fileName;
+        if (!m_leftContainerVisible) onToggleLeftContainer();
+    });
+}
 
-    if (img.save(fullPath, "PNG")) {
-        return fullPath;
+QString MainWindow::saveImageToLocal(const QByteArray& data)
+{
+    StoredImage stored = ImageStore::store(data);
+    if (!stored.ok) return QString();
+
+    // 先于 addMessage 入队，消息插入触发器据此累加引用计数
+    DatabaseManager::instance().registerImage(stored.hash, stored.path, stored.size);
+
+    // 顺手生成各档缩略图，画廊和历史记录不必再解码原图。
+    // data 可能引用本地结果文件的内存映射，只在本次调用内有效，后台任务从刚写入的文件读取
+    if (!stored.existed) {
+        QString path = stored.path;
+        QThreadPool::globalInstance()->start([path]() {
+            ThumbnailCache::generate(path);
+        });
     }
-    return QString();
+    return stored.path;
 }
 
 /**
  * @brief 加载会话历史
  * @param sessionId 会话ID
+ * @param focusMessageId 需定位的消息ID，-1 表示显示最新一页
  */
-void MainWindow::loadSessionHistory(int sessionId)
+void MainWindow::loadSessionHistory(int sessionId, int focusMessageId)
 {
     qDebug() << "正在加载会话历史:" << sessionId;
 
+    // 离开的会话重新取一次第一页，切回时可以立即显示；重新打开同一会话时缓存可能已过期
+    const int previousId = m_chatArea->currentSessionId();
+    if (previousId == sessionId) {
+        m_historyCache->invalidate(sessionId);
+    } else {
+        m_historyCache->refresh(previousId);
+    }
+
     m_chatArea->clear();
     m_chatArea->setCurrentSessionId(sessionId);
 
-    QVector<MessageData> messages = DatabaseManager::instance().getMessages(sessionId);
-
-    for (const auto& msg : messages) {
+    const int serial = ++m_historyLoadSerial;
+    m_historyCursor = MessageCursor();
+
+    auto showPage = [this](const MessagePage& page) {
+        m_historyCursor = page.next;
+        m_chatArea->appendHistory(page.messages);
+        m_chatArea->setHasMoreHistory(page.hasMore);
+    };
+
+    // 搜索结果可能在最新一页之外：从最新消息连续加载到目标消息，再滚动过去
+    if (focusMessageId != -1) {
+        DatabaseManager::instance().getMessagePageFrom(sessionId, focusMessageId)
+            .then(this, [this, serial, showPage, focusMessageId](const MessagePage& page) {
+                if (serial != m_historyLoadSerial) return;
+                showPage(page);
+                m_chatArea->scrollToMessage(focusMessageId);
+            });
+        return;
+    }
 
-        ChatRole role = (msg.role == MessageRole::User) ? ChatRole::User : ChatRole::AI;
+    MessagePage cached;
+    if (m_historyCache->readyPage(sessionId, &cached)) {
+        showPage(cached);
+    } else {
+        m_historyCache->page(sessionId).then(this, [this, serial, showPage](const MessagePage& page) {
+            // 查询返回前可能已发起了新的加载（切换会话或重复点击），旧结果直接丢弃
+            if (serial != m_historyLoadSerial) return;
+            showPage(page);
+        });
+    }
 
-        if (msg.isImage()) {
-            QPixmap pix(msg.imagePath);
-            if (!pix.isNull()) {
-                if (role == ChatRole::User) {
-                    m_chatArea->addUserImage(pix);
-                } else {
-                    m_chatArea->addAiImage(pix);
-                }
-            } else {
-                if (role == ChatRole::User) m_chatArea->addUserMessage("[图片文件已丢失]");
-                else m_chatArea->addAiMessage("[图片文件已丢失]");
-            }
-        }
-        else {
-            if (role == ChatRole::User) {
-                m_chatArea->addUserMessage(msg.text);
-            } else {
-                m_chatArea->addAiMessage(msg.text);
-            }
-        }
+    // 用户多半会切到相邻的会话，顺带预取
+    for (int neighbourId : m_sessionList->adjacentSessionIds(sessionId)) {
+        m_historyCache->prefetch(neighbourId);
     }
+}
 
-    QTimer::singleShot(100, this, [this](){ m_chatArea->scrollToBottom(); });
+/**
+ * @brief 加载当前会话更早的一页历史
+ */
+void MainWindow::loadOlderHistory()
+{
+    int sessionId = m_chatArea->currentSessionId();
+    if (sessionId == -1 || !m_historyCursor.isValid()) return;
+
+    const int serial = m_historyLoadSerial;
+
+    DatabaseManager::instance().getMessagePage(sessionId, m_historyCursor).then(this, [this, serial](const MessagePage& page) {
+        if (serial != m_historyLoadSerial) return;
+
+        m_historyCursor = page.next;
+        m_chatArea->prependHistory(page.messages);
+        m_chatArea->setHasMoreHistory(page.hasMore);
+    });
 }
 
 /**
@@ -784,6 +1029,8 @@ void MainWindow::loadAndConnect()
     m_inputPanel->setConnectionStatus(false);
 
     if (m_apiService) {
+        bool localMode = settings.value("Server/LocalMode", false).toBool();
+        m_apiService->setLocalComfyDir(localMode ? settings.value("Server/ComfyDir").toString() : QString());
         m_apiService->connectToHost(url);
     }
 }
@@ -16,6 +16,7 @@
 #include <QPropertyAnimation>
 #include <QHBoxLayout>
 #include <QStackedWidget>
+#include <QElapsedTimer>
 #include "../Model/WorkflowTypes.h"
 #include "../Network/ComfyApiService.h"
 #include "../Database/DatabaseManager.h"
@@ -29,9 +30,10 @@ class ChatArea;
 class QToolButton;
 class ComfyApiService;
 class WorkflowManager;
-class ChatBubble;
 class SidebarControl;
 class HistoryGallery;
+class SessionModel;
+class SessionHistoryCache;
 
 /**
  * @brief 主窗口类
@@ -110,12 +112,48 @@ protected:
      */
     void resizeEvent(QResizeEvent* event) override;
 
+    /**
+     * @brief 事件处理
+     * @param event 事件对象
+     * @return bool 是否处理了该事件
+     *
+     * 监听首次绘制，首帧显示后再执行连接服务器等非关键启动步骤
+     */
+    bool event(QEvent* event) override;
+
 private:
     /**
      * @brief 初始化UI布局
+     *
+     * 只构建首帧需要的控件，弹出面板和历史画廊在第一次使用时才创建
      */
     void setupUi();
 
+    /**
+     * @brief 首帧绘制完成
+     *
+     * 结束启动计时，然后连接服务器
+     */
+    void onFirstFrame();
+
+    /**
+     * @brief 获取工作流选择面板，首次调用时创建
+     * @return WorkflowSelector* 工作流选择面板
+     */
+    WorkflowSelector* workflowSelector();
+
+    /**
+     * @brief 获取参考图面板，首次调用时创建
+     * @return ReferencePopup* 参考图面板
+     */
+    ReferencePopup* referencePopup();
+
+    /**
+     * @brief 获取历史画廊，首次调用时创建
+     * @return HistoryGallery* 历史画廊（左侧堆栈第 1 页）
+     */
+    HistoryGallery* historyGallery();
+
     /**
      * @brief 更新侧边栏位置
      */
@@ -123,11 +161,15 @@ private:
 
     /**
      * @brief 加载所有历史会话
+     *
+     * 只在启动时调用一次，之后会话的增删改都增量进入 SessionModel
      */
     void loadSessionList();
 
     /**
      * @brief 创建新会话
+     *
+     * 新会话插入到列表顶部并切换过去；新会话没有消息，不查询历史
      */
     void createNewSession();
 
@@ -138,17 +180,25 @@ private:
     void switchLeftPanel(int targetIndex);
 
     /**
-     * @brief 保存图片到本地
-     * @param img 要保存的图片
-     * @return QString 保存后的文件路径
+     * @brief 保存图片到本地内容寻址存储并登记
+     * @param data 图片文件原始字节
+     * @return QString 保存后的文件路径，失败时为空
      */
-    QString saveImageToLocal(const QPixmap& img);
+    QString saveImageToLocal(const QByteArray& data);
 
     /**
      * @brief 加载指定会话的历史记录到聊天区
      * @param sessionId 会话ID
+     * @param focusMessageId 需定位的消息ID（打开搜索结果），-1 表示显示最新一页
      */
-    void loadSessionHistory(int sessionId);
+    void loadSessionHistory(int sessionId, int focusMessageId = -1);
+
+    /**
+     * @brief 加载当前会话更早的一页历史
+     *
+     * 由聊天区域滚动到顶部附近时触发
+     */
+    void loadOlderHistory();
 
     /**
      * @brief 切换忙碌状态
@@ -156,9 +206,44 @@ private:
      */
     void setJobRunning(bool running);
 
+    /**
+     * @brief 把当前累计的流式文本写入数据库
+     * @param force 是否忽略节流立即写入
+     *
+     * 首次调用时插入消息记录，之后按节流间隔更新同一条记录，
+     * 这样即使流式输出中途崩溃也能保留已收到的部分文本。
+     */
+    void persistStreamText(bool force);
+
+    /**
+     * @brief 上传参考图面板中的图片
+     * @param type 使用该参考图的工作流类型，决定上传前的缩放尺寸
+     *
+     * 本地文件按路径上传，剪贴板粘贴的图片直接从内存上传。
+     */
+    void uploadReferenceImage(WorkflowType type);
+
+    /**
+     * @brief 提交工作流并开始记录生成元数据
+     * @param type 工作流类型
+     * @param params 绑定到模板的参数
+     * @param workflow 构建好的工作流JSON
+     */
+    void submitWorkflow(WorkflowType type, const QMap<QString, QVariant>& params, const QJsonObject& workflow);
+
+    /**
+     * @brief 任务结果落地后写入生成元数据
+     * @param promptId 任务ID
+     * @param messageId 结果消息的 addMessage future，结果未落库时为无效 future
+     * @param outputSize 输出图片尺寸，文本结果为空
+     */
+    void recordGeneration(const QString& promptId, const QFuture<int>& messageId, const QSize& outputSize);
+
 private:
     QStackedWidget* m_leftStack = nullptr; ///< 左侧容器堆栈
     SessionList* m_sessionList = nullptr; ///< 会话列表组件
+    SessionModel* m_sessionModel = nullptr; ///< 会话列表模型
+    SessionHistoryCache* m_historyCache = nullptr; ///< 会话第一页的预取缓存
     ChatArea* m_chatArea = nullptr; ///< 聊天区域组件
     InputPanel* m_inputPanel = nullptr; ///< 底部控制面板组件
     WorkflowSelector* m_wfSelector = nullptr; ///< 工作流选择面板组件
@@ -169,18 +254,26 @@ private:
     int m_leftContainerOriginalWidth = 250; ///< 左侧容器的初始宽度
     int m_currentPageIndex = 0; ///< 当前显示的页面索引
     HistoryGallery* m_historyGallery = nullptr; ///< 历史记录画廊组件
+    bool m_firstFrameShown = false; ///< 首帧是否已绘制
     QHBoxLayout* m_mainLayout = nullptr; ///< 主布局
     ComfyApiService* m_apiService = nullptr; ///< API服务
     WorkflowManager* m_wfManager = nullptr; ///< 业务逻辑管理器
     WorkflowType m_currentWorkflowType = WorkflowType::TextToImage; ///< 当前选中的工作流类型
-    ChatBubble* m_tempBubbleForId = nullptr; ///< 暂存刚刚创建的加载气泡
-    QMap<QString, ChatBubble*> m_pendingBubbles; ///< 任务ID到气泡指针的映射表
+    int m_tempItemForId = -1; ///< 暂存刚刚创建的加载占位（ChatArea 条目 key），-1 表示无
+    QMap<QString, int> m_pendingItems; ///< 任务ID到加载占位条目 key 的映射表
     bool m_isUploadingForUpscale = false; ///< 标记当前上传操作是否为了高清修复
-    ChatBubble* m_tempUpscaleBubble = nullptr; ///< 暂存高清修复的气泡
+    int m_tempUpscaleItem = -1; ///< 暂存高清修复的加载占位，-1 表示无
     bool m_isJobRunning = false; ///< 是否正在执行任务（忙碌状态）
     bool m_isUploadingForInterrogate = false; ///< 标记当前上传是否为了反推提示词
     QString m_currentServerRefImg = ""; ///< 记住反推用的图片名
+    GenerationRecord m_submittedGeneration; ///< 已提交、尚未拿到任务ID的生成记录
+    QMap<QString, GenerationRecord> m_generations; ///< 任务ID到进行中生成记录的映射表
+    qint64 m_uploadStartedAt = 0; ///< 当前参考图上传的开始时间，0 表示无上传
     bool m_isUploadingForI2I = false; ///< 标记当前上传是否为了图生图生成
     QMap<QString, QVariant> m_pendingI2IParams; ///< 暂存图生图需要的参数
     QString m_accumulatedStreamText = ""; ///< 用于暂存流式传输的完整文本
+    QFuture<int> m_streamMessageId; ///< 流式文本对应的数据库消息ID（插入任务的结果）
+    QElapsedTimer m_streamPersistTimer; ///< 流式文本落库节流计时器
+    int m_historyLoadSerial = 0; ///< 会话历史加载序号，用于丢弃过期的查询结果
+    MessageCursor m_historyCursor; ///< 当前会话已加载的最旧消息位置
 };
@@ -7,8 +7,11 @@
  */
 
 #include <QApplication>
+#include <QIcon>
+#include <QMessageBox>
 #include "Ui/MainWindow.h"
 #include "Database/DatabaseManager.h"
+#include "Core/StartupProfiler.h"
 
 /**
  * @brief 应用程序主函数
@@ -18,20 +21,39 @@
  */
 int main(int argc, char *argv[])
 {
+    StartupProfiler::start();
+
     QApplication app(argc, argv);
     app.setApplicationName("CloudArt");
-    app.setWindowIcon(QIcon(":/images/logo.png"));
 
-    if (!DatabaseManager::instance().init()) {
-        qDebug() << "⚠️ 警告：数据库初始化失败，历史记录将无法保存！";
+    // 使用构建时生成的多尺寸图标，标题栏、任务栏各取合适的尺寸，不再缩放 1536 像素的原图
+    QIcon icon;
+    for (int size : { 16, 24, 32, 48, 64, 128, 256 }) {
+        icon.addFile(QString(":/icons/logo_%1.png").arg(size), QSize(size, size));
     }
+    app.setWindowIcon(icon);
+    StartupProfiler::mark("QApplication");
 
-    if (!DatabaseManager::instance().init()) {
-        return -1;
-    }
+    // 数据库在自己的线程里打开和迁移，与下面的界面构建并行；失败时仍可使用，只是不保存历史
+    DatabaseManager::instance().init().then(&app, [](bool ok) {
+        StartupProfiler::mark("数据库就绪");
+        if (ok) return;
+
+        qDebug() << "⚠️ 警告：数据库初始化失败，历史记录将无法保存！";
+        // 此时主窗口已经显示，提示框以它为父窗口
+        QMessageBox::warning(QApplication::activeWindow(), "数据库不可用",
+                             "数据库初始化失败，本次运行的会话和图片将不会保存到历史记录。");
+    });
 
     MainWindow window;
+    StartupProfiler::mark("主窗口构建");
+
     window.show();
+    StartupProfiler::mark("窗口显示");
+
+    int ret = app.exec();
 
-    return app.exec();
+    // 等待排队中的写操作落库后再退出
+    DatabaseManager::instance().shutdown();
+    return ret;
 }
@@ -0,0 +1,325 @@
+/**
+ * @file main.cpp
+ * @brief 资源烘焙工具
+ *
+ * 构建时运行：按 resources/assets.json 把原始素材生成为界面实际需要的尺寸，
+ * 分成编译进程序的常驻资源（core）和按需加载的外部资源包（media），并为两者各生成一个 qrc 清单。
+ *
+ * 用法：asset_baker <assets.json> <资源目录> <输出目录>
+ *
+ * @author CloudArt Team
+ * @version 1.0
+ * @date 2024
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QTextStream>
+#include <QDebug>
+
+namespace {
+
+/**
+ * @brief 读取 [宽, 高] 形式的尺寸
+ * @param value JSON 数组
+ * @return QSize 尺寸，格式不对时为无效尺寸
+ */
+QSize readSize(const QJsonValue& value)
+{
+    const QJsonArray array = value.toArray();
+    if (array.size() != 2) return QSize();
+    return QSize(array[0].toInt(), array[1].toInt());
+}
+
+/**
+ * @brief 缩放图片
+ * @param image 原图
+ * @param size 目标尺寸
+ * @param cover true 时按比例填满后居中裁剪，false 时按比例缩放到尺寸以内
+ * @return QImage 缩放结果
+ */
+QImage fitImage(const QImage& image, const QSize& size, bool cover)
+{
+    if (!cover) return image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    const QImage scaled = image.scaled(size, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    QRect clip(QPoint(0, 0), size);
+    clip.moveCenter(scaled.rect().center());
+    return scaled.copy(clip);
+}
+
+/**
+ * @brief 写出图片
+ * @param image 图片
+ * @param path 输出路径，按扩展名选择格式
+ * @param quality 压缩质量（JPEG 有效），-1 为默认
+ * @return bool 是否成功
+ */
+bool writeImage(const QImage& image, const QString& path, int quality)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QImageWriter writer(path);
+    writer.setQuality(quality);
+    writer.setOptimizedWrite(true);
+    if (writer.format() == "png") writer.setCompression(9);
+
+    // JPEG 不支持透明通道，先铺到不透明底色上
+    QImage output = image;
+    if (writer.format() == "jpg" || writer.format() == "jpeg") {
+        output = image.convertToFormat(QImage::Format_RGB32);
+    }
+
+    if (!writer.write(output)) {
+        qWarning() << "写出失败:" << path << writer.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 资源烘焙器
+ */
+class Baker
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param sourceDir 资源目录
+     * @param outputDir 输出目录
+     */
+    Baker(const QString& sourceDir, const QString& outputDir)
+        : m_sourceDir(sourceDir)
+        , m_outputDir(outputDir)
+    {
+    }
+
+    /**
+     * @brief 烘焙一个资源包
+     * @param pack 资源包名称（core / media），也是输出子目录名
+     * @param entries 资源条目
+     * @return bool 全部成功
+     */
+    bool bakePack(const QString& pack, const QJsonArray& entries)
+    {
+        m_files.clear();
+
+        bool ok = true;
+        for (const QJsonValue& value : entries) {
+            const QJsonObject entry = value.toObject();
+            const QString type = entry.value("type").toString();
+
+            if (type == "image") ok &= bakeImage(pack, entry);
+            else if (type == "icon") ok &= bakeIcon(pack, entry);
+            else if (type == "strip") ok &= bakeStrip(pack, entry);
+            else {
+                qWarning() << "未知的资源类型:" << type;
+                ok = false;
+            }
+        }
+
+        return ok && writeQrc(pack);
+    }
+
+private:
+    /**
+     * @brief 读取源图片
+     * @param entry 资源条目
+     * @return QImage 源图片，失败时为空
+     */
+    QImage readSource(const QJsonObject& entry) const
+    {
+        const QString path = m_sourceDir.filePath(entry.value("source").toString());
+        QImageReader reader(path);
+        reader.setAutoTransform(true);
+        QImage image = reader.read();
+        if (image.isNull()) qWarning() << "读取失败:" << path << reader.errorString();
+        return image;
+    }
+
+    /**
+     * @brief 输出文件路径并登记到清单
+     * @param pack 资源包名称
+     * @param name 资源内路径
+     * @return QString 输出文件路径
+     */
+    QString output(const QString& pack, const QString& name)
+    {
+        m_files.append(name);
+        return m_outputDir.filePath(pack + "/" + name);
+    }
+
+    /**
+     * @brief 缩放单张图片
+     * @param pack 资源包名称
+     * @param entry 资源条目（source / output / size / fit / quality）
+     * @return bool 是否成功
+     */
+    bool bakeImage(const QString& pack, const QJsonObject& entry)
+    {
+        const QImage image = readSource(entry);
+        const QSize size = readSize(entry.value("size"));
+        if (image.isNull() || !size.isValid()) return false;
+
+        const bool cover = entry.value("fit").toString() == "cover";
+        return writeImage(fitImage(image, size, cover), output(pack, entry.value("output").toString()),
+                          entry.value("quality").toInt(-1));
+    }
+
+    /**
+     * @brief 生成多尺寸图标
+     * @param pack 资源包名称
+     * @param entry 资源条目（source / output 含 %1 占位 / sizes）
+     * @return bool 是否成功
+     */
+    bool bakeIcon(const QString& pack, const QJsonObject& entry)
+    {
+        const QImage image = readSource(entry);
+        if (image.isNull()) return false;
+
+        bool ok = true;
+        const QString pattern = entry.value("output").toString();
+        for (const QJsonValue& value : entry.value("sizes").toArray()) {
+            const int side = value.toInt();
+            ok &= writeImage(fitImage(image, QSize(side, side), false), output(pack, pattern.arg(side)), -1);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief 把动画拆成帧表
+     * @param pack 资源包名称
+     * @param entry 资源条目（source / output / frameSize / columns / quality）
+     * @return bool 是否成功
+     *
+     * 所有帧按行排进一张 JPEG，另写一个 JSON 记录帧尺寸、列数和各帧时长，
+     * 运行时一次解码整张图再切帧，不必逐帧做 GIF 解压和合成
+     */
+    bool bakeStrip(const QString& pack, const QJsonObject& entry)
+    {
+        const QString path = m_sourceDir.filePath(entry.value("source").toString());
+        const QSize frameSize = readSize(entry.value("frameSize"));
+        const int columns = qMax(1, entry.value("columns").toInt(8));
+
+        QImageReader reader(path);
+        QVector<QImage> frames;
+        QJsonArray delays;
+        while (reader.canRead()) {
+            const QImage frame = reader.read();
+            if (frame.isNull()) break;
+            frames.append(fitImage(frame, frameSize, true));
+            delays.append(reader.nextImageDelay());
+        }
+        if (frames.isEmpty()) {
+            qWarning() << "读取失败:" << path << reader.errorString();
+            return false;
+        }
+
+        const int rows = (frames.size() + columns - 1) / columns;
+        QImage sheet(frameSize.width() * qMin(columns, int(frames.size())), frameSize.height() * rows,
+                     QImage::Format_RGB32);
+        sheet.fill(Qt::black);
+        {
+            QPainter painter(&sheet);
+            for (int i = 0; i < frames.size(); ++i) {
+                const QPoint at((i % columns) * frameSize.width(), (i / columns) * frameSize.height());
+                painter.drawImage(at, frames[i]);
+            }
+        }
+
+        const QString name = entry.value("output").toString();
+        const QString imageName = QFileInfo(name).fileName() + ".jpg";
+        if (!writeImage(sheet, output(pack, name + ".jpg"), entry.value("quality").toInt(80))) return false;
+
+        QJsonObject manifest;
+        manifest["image"] = imageName;
+        manifest["frameWidth"] = frameSize.width();
+        manifest["frameHeight"] = frameSize.height();
+        manifest["columns"] = columns;
+        manifest["delays"] = delays;
+
+        QFile file(output(pack, name + ".json"));
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "写出失败:" << file.fileName() << file.errorString();
+            return false;
+        }
+        file.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+        return true;
+    }
+
+    /**
+     * @brief 写出资源包的 qrc 清单
+     * @param pack 资源包名称
+     * @return bool 是否成功
+     */
+    bool writeQrc(const QString& pack) const
+    {
+        QFile file(m_outputDir.filePath(pack + ".qrc"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qWarning() << "写出失败:" << file.fileName() << file.errorString();
+            return false;
+        }
+
+        // media 包注册时挂在 /media 下，core 包直接挂在根目录
+        QTextStream out(&file);
+        out << "<RCC>\n    <qresource prefix=\"/" << (pack == "core" ? QString() : pack) << "\">\n";
+        for (const QString& name : m_files) {
+            out << "        <file alias=\"" << name << "\">" << pack << "/" << name << "</file>\n";
+        }
+        out << "    </qresource>\n</RCC>\n";
+        return true;
+    }
+
+private:
+    QDir m_sourceDir;      ///< 资源目录
+    QDir m_outputDir;      ///< 输出目录
+    QStringList m_files;   ///< 当前资源包已生成的文件
+};
+
+} // namespace
+
+/**
+ * @brief 工具入口
+ * @param argc 命令行参数个数
+ * @param argv 命令行参数数组
+ * @return int 0 表示成功
+ */
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const QStringList args = app.arguments();
+    if (args.size() != 4) {
+        qWarning() << "用法: asset_baker <assets.json> <资源目录> <输出目录>";
+        return 2;
+    }
+
+    QFile manifestFile(args[1]);
+    if (!manifestFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法读取清单:" << args[1] << manifestFile.errorString();
+        return 1;
+    }
+
+    QJsonParseError error;
+    const QJsonObject manifest = QJsonDocument::fromJson(manifestFile.readAll(), &error).object();
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "清单格式错误:" << error.errorString();
+        return 1;
+    }
+
+    Baker baker(args[2], args[3]);
+    bool ok = true;
+    for (const QString& pack : { QStringLiteral("core"), QStringLiteral("media") }) {
+        ok &= baker.bakePack(pack, manifest.value(pack).toArray());
+    }
+    return ok ? 0 : 1;
+}